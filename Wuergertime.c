@@ -25,12 +25,16 @@
 #include "controllers.h"
 #include "tiles.h"
 #include "sprites.h"
+#include "player.h"
 #include "draw.h"
 #include "highscores.h"
 #include "screens.h"
 #include "screens_outofgame.h"
 #include "screens_ingame.h"
 #include "patches.h"
+#include "levelpack.h"
+#include "statistics.h"
+#include "latency.h"
 
 
 /*
@@ -53,8 +57,21 @@ int main(void) {
 	/* Setup video. */
 	SetSpritesTileTable(SpriteTiles);
 
+	/* Setup sprite slots. The cook is shown on out-of-game screens, too. */
+	resetSpriteSlots();
+	Player.sprite=occupySpriteSlot(SPRITE_PIECES_BLOCK,SPRITE_SLOT_PRIORITY);
+
+	/* Read highscores from EEPROM. */
+	initHighscores();
+
+	/* Look for a level pack on SD card. */
+	initLevelPack();
+
 	/* Main loop */
 	for (;;) {
+		/* Leave a demo when it's over. */
+		checkDemo();
+
 		/* Check for screen change. */
 		if (GameScreen == GameScreenPrevious) {
 			/* Sample controllers. */
@@ -66,6 +83,15 @@ int main(void) {
 			/* Next animation phase. */
 			GameScreenAnimationPhase++;
 
+			/* Rebuild kernel sprites of all megasprites changed in this frame. */
+			commitSprites();
+
+			/* Write level statistics to EEPROM, byte by byte. */
+			updateLevelStatistics();
+
+			/* Check for cook's response to an injected button. */
+			checkLatencyProbe();
+
 			/* Wait for next frame (let the interrupt kernel work). */
 			WaitVsync(1);
 		} else {
@@ -73,6 +99,7 @@ int main(void) {
 			switch (GameScreenPrevious) {
 				case GAME_SCREEN_START:             cleanupStartScreen(); break;
 				case GAME_SCREEN_HIGHSCORES:        cleanupHighscoresScreen(); break;
+				case GAME_SCREEN_DEMO:              cleanupDemoScreen(); break;
 				case GAME_SCREEN_GAME_OVER:         cleanupGameOverScreen(); break;
 				case GAME_SCREEN_NEW_HIGHSCORE:     cleanupNewHighscoreScreen(); break;
 				case GAME_SCREEN_ENTER_HIGHSCORE:   cleanupEnterHighscoreScreen(); break;
@@ -104,6 +131,10 @@ int main(void) {
 					GameScreenUpdateFunction=&updateHighscoresScreen;
 					initHighscoresScreen();
 					break;
+				case GAME_SCREEN_DEMO:
+					GameScreenUpdateFunction=&updateDemoScreen;
+					initDemoScreen();
+					break;
 				case GAME_SCREEN_GAME_OVER:
 					GameScreenUpdateFunction=&updateGameOverScreen;
 					initGameOverScreen();
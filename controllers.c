@@ -13,12 +13,34 @@
 
 
 #include <avr/io.h> /* for uint16_t */
+#include <avr/pgmspace.h> /* for pgm_read_byte() */
 #include <uzebox.h> /* for ReadJoypad */
 
 
+/* Local includes. */
+#include "controllers.h"
+#include "latency.h"
+
+
 /* Controller data. */
 struct { uint16_t current, previous, held, pressed, released; } controllers[2];
 
+/* Frame counter for event timestamps. */
+uint8_t ControllerFrame;
+
+/* Event queue. Events are lost when it is full. */
+controller_event_t ControllerEvents[CONTROLLER_EVENT_MAX];
+uint8_t ControllerEventHead;
+uint8_t ControllerEventTail;
+uint8_t ControllerEventsLost;
+
+/* Demo input in program memory, buttons and frames left of the current run. */
+uint8_t ControllerDemoState;
+const char *ControllerDemoInput;
+uint16_t ControllerDemoButtons;
+uint16_t ControllerDemoFrames;
+uint8_t ControllerDemoRelease;
+
 
 /* Reset controller struct. */
 void resetControllers(void) {
@@ -31,22 +53,102 @@ void resetControllers(void) {
 		controllers[i].pressed = 0;
 		controllers[i].released = 0;
 	}
+
+	/* Reset event queue. */
+	flushControllerEvents();
+}
+
+
+/* Queue events for all changed buttons of a controller. */
+void queueControllerEvents(uint8_t n, uint16_t changed, uint16_t current) {
+	uint8_t button, next;
+
+	for (button=0;changed;button++,changed>>=1,current>>=1) {
+		/* Skip unchanged buttons. */
+		if (!(changed & 1))
+			continue;
+
+		/* Count lost event if queue is full. */
+		next=(ControllerEventHead+1) & (CONTROLLER_EVENT_MAX-1);
+		if (next == ControllerEventTail) {
+			if (ControllerEventsLost < 0xff) ControllerEventsLost++;
+			continue;
+		}
+
+		/* Queue event. */
+		ControllerEvents[ControllerEventHead].frame=ControllerFrame;
+		ControllerEvents[ControllerEventHead].flags=
+			(button<<CONTROLLER_EVENT_BUTTON_SHIFT)
+			|(n<<CONTROLLER_EVENT_CONTROLLER_SHIFT)
+			|((current & 1)?CONTROLLER_EVENT_EDGE_PRESSED:CONTROLLER_EVENT_EDGE_RELEASED);
+		ControllerEventHead=next;
+	}
+}
+
+
+/* Replace controller 0 by demo input while a demo plays. Any button pressed ends it. */
+uint16_t playControllerDemo(uint8_t n, uint16_t buttons) {
+	uint8_t run;
+
+	/* Swallow buttons still held from the end of a demo, so they don't make a press. */
+	if (!n && ControllerDemoRelease) {
+		if (buttons)
+			return 0;
+		ControllerDemoRelease=0;
+	}
+
+	/* Skip if not playing. */
+	if (n || ControllerDemoState != CONTROLLER_DEMO_STATE_PLAYING)
+		return buttons;
+
+	/* Next run. */
+	if (!ControllerDemoFrames) {
+		run=pgm_read_byte(ControllerDemoInput++);
+		ControllerDemoButtons=((run & CONTROLLER_DEMO_BUTTONS_MASK)>>CONTROLLER_DEMO_BUTTONS_SHIFT)<<CONTROLLER_DEMO_JOYPAD_SHIFT;
+		ControllerDemoFrames=(run & CONTROLLER_DEMO_FRAMES_MASK)>>CONTROLLER_DEMO_FRAMES_SHIFT;
+		if (ControllerDemoFrames == CONTROLLER_DEMO_FRAMES_LONG)
+			ControllerDemoFrames+=pgm_read_byte(ControllerDemoInput++);
+
+		/* End of input. */
+		if (run == CONTROLLER_DEMO_END)
+			ControllerDemoState=CONTROLLER_DEMO_STATE_ENDED;
+	}
+
+	/* A button pressed ends the demo, too. */
+	if (buttons)
+		ControllerDemoState=CONTROLLER_DEMO_STATE_ENDED;
+
+	/* Nothing held after the end. */
+	if (ControllerDemoState != CONTROLLER_DEMO_STATE_PLAYING)
+		return 0;
+
+	ControllerDemoFrames--;
+	return ControllerDemoButtons;
 }
 
 
 /* Sample controllers. */
 void sampleControllers(void) {
-	uint16_t i;
+	uint16_t i, changed;
+
+	/* Next frame. */
+	ControllerFrame++;
 
 	for (i=0;i<2;i++) {
 		/* Read current value. */
 		controllers[i].previous = controllers[i].current;
-		controllers[i].current = ReadJoypad(i);
+		controllers[i].current = playControllerDemo(i,probeLatencyInput(i,ReadJoypad(i)));
+		changed = controllers[i].current ^ controllers[i].previous;
 
 		/* Set event bits. */
 		controllers[i].held |= controllers[i].current & controllers[i].previous;
-		controllers[i].pressed |= controllers[i].current & (controllers[i].current ^ controllers[i].previous);
-		controllers[i].released |= controllers[i].previous & (controllers[i].current ^ controllers[i].previous);
+
+		/* Queue events only if anything changed. */
+		if (changed) {
+			controllers[i].pressed |= controllers[i].current & changed;
+			controllers[i].released |= controllers[i].previous & changed;
+			queueControllerEvents(i,changed,controllers[i].current);
+		}
 	}
 }
 
@@ -93,3 +195,62 @@ uint16_t checkControllerButtonsReleased(uint16_t n, uint16_t mask) {
 	return result;
 }
 
+
+/* Drop all queued events. */
+void flushControllerEvents(void) {
+	ControllerEventHead=0;
+	ControllerEventTail=0;
+	ControllerEventsLost=0;
+}
+
+
+/* Get oldest queued event. Returns 0 if there is none. */
+uint8_t getControllerEvent(controller_event_t *event) {
+	/* Queue empty? */
+	if (ControllerEventTail == ControllerEventHead)
+		return 0;
+
+	/* Dequeue. */
+	*event=ControllerEvents[ControllerEventTail];
+	ControllerEventTail=(ControllerEventTail+1) & (CONTROLLER_EVENT_MAX-1);
+	return 1;
+}
+
+
+/* Get next single masked button pressed on given controller. Other events are dropped. */
+uint16_t getControllerButtonPressed(uint8_t n, uint16_t mask) {
+	controller_event_t event;
+	uint16_t button;
+
+	while (getControllerEvent(&event)) {
+		/* Skip releases and other controller. */
+		if ((event.flags & CONTROLLER_EVENT_EDGE_MASK) != CONTROLLER_EVENT_EDGE_PRESSED)
+			continue;
+		if (((event.flags & CONTROLLER_EVENT_CONTROLLER_MASK)>>CONTROLLER_EVENT_CONTROLLER_SHIFT) != n)
+			continue;
+
+		/* Return masked button. */
+		button=CONTROLLER_EVENT_BUTTON(event.flags);
+		if (button & mask)
+			return button;
+	}
+
+	/* Nothing pressed. */
+	return 0;
+}
+
+
+/* Start playing demo input from program memory. */
+void startControllerDemo(const char *input) {
+	ControllerDemoInput=input;
+	ControllerDemoFrames=0;
+	ControllerDemoRelease=0;
+	ControllerDemoState=CONTROLLER_DEMO_STATE_PLAYING;
+}
+
+
+/* Stop playing demo input. Buttons held now are ignored until released. */
+void stopControllerDemo(void) {
+	ControllerDemoState=CONTROLLER_DEMO_STATE_OFF;
+	ControllerDemoRelease=1;
+}
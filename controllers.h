@@ -27,11 +27,62 @@
 #define BTN_ALL ((BTN_UP|BTN_DOWN|BTN_LEFT|BTN_RIGHT|BTN_A|BTN_B|BTN_X|BTN_Y|BTN_SR|BTN_SL|BTN_START|BTN_SELECT))
 
 
+/* Controller event queue. Size must be a power of two. */
+#define CONTROLLER_EVENT_MAX 16
+
+/* Controller event flags: button number, controller, pressed or released. */
+#define CONTROLLER_EVENT_BUTTON_SHIFT     0
+#define CONTROLLER_EVENT_BUTTON_MASK      ((0x0f<<CONTROLLER_EVENT_BUTTON_SHIFT))
+#define CONTROLLER_EVENT_CONTROLLER_SHIFT 4
+#define CONTROLLER_EVENT_CONTROLLER_MASK  ((0x01<<CONTROLLER_EVENT_CONTROLLER_SHIFT))
+#define CONTROLLER_EVENT_EDGE_SHIFT       5
+#define CONTROLLER_EVENT_EDGE_MASK        ((0x01<<CONTROLLER_EVENT_EDGE_SHIFT))
+#define CONTROLLER_EVENT_EDGE_PRESSED     ((0<<CONTROLLER_EVENT_EDGE_SHIFT))
+#define CONTROLLER_EVENT_EDGE_RELEASED    ((1<<CONTROLLER_EVENT_EDGE_SHIFT))
+
+/* Button mask from event flags. */
+#define CONTROLLER_EVENT_BUTTON(flags) ((1<<(((flags) & CONTROLLER_EVENT_BUTTON_MASK)>>CONTROLLER_EVENT_BUTTON_SHIFT)))
+
+typedef struct {
+	uint8_t frame;
+	uint8_t flags;
+} controller_event_t;
+
+/*
+ *  Demo input, one byte per run of frames with the same buttons held.
+ *  Buttons are UP, DOWN, LEFT, RIGHT and A, which are adjacent bits in
+ *  a joypad word. A run of CONTROLLER_DEMO_FRAMES_LONG or more frames is
+ *  followed by a byte of frames more. A zero byte ends the input.
+ */
+#define CONTROLLER_DEMO_BUTTONS_SHIFT 0
+#define CONTROLLER_DEMO_BUTTONS_MASK  ((0x1f<<CONTROLLER_DEMO_BUTTONS_SHIFT))
+#define CONTROLLER_DEMO_FRAMES_SHIFT  5
+#define CONTROLLER_DEMO_FRAMES_MASK   ((0x07<<CONTROLLER_DEMO_FRAMES_SHIFT))
+#define CONTROLLER_DEMO_FRAMES_LONG   7
+#define CONTROLLER_DEMO_JOYPAD_SHIFT  4
+#define CONTROLLER_DEMO_END           0
+
+/* Demo states. */
+#define CONTROLLER_DEMO_STATE_OFF     0
+#define CONTROLLER_DEMO_STATE_PLAYING 1
+#define CONTROLLER_DEMO_STATE_ENDED   2
+
+
+extern uint8_t ControllerFrame;
+extern uint8_t ControllerEventsLost;
+extern uint8_t ControllerDemoState;
+
+
 void resetControllers(void);
 void sampleControllers(void);
 uint16_t checkControllerButtonsHeld(uint16_t n, uint16_t mask);
 uint16_t checkControllerButtonsPressed(uint16_t n, uint16_t mask);
 uint16_t checkControllerButtonsReleased(uint16_t n, uint16_t mask);
+void flushControllerEvents(void);
+uint8_t getControllerEvent(controller_event_t *event);
+uint16_t getControllerButtonPressed(uint8_t n, uint16_t mask);
+void startControllerDemo(const char *input);
+void stopControllerDemo(void);
 
 
 #endif /* CONTROLLERS_H */
@@ -110,8 +110,8 @@ const tiles_block_t ShapeBonusItems[5][2]={
 };
 
 
-/* Other shape data. */
-#include "data/shapes.inc"
+/* Other shape data, run length encoded by shapestorle.tcl tool. */
+#include "data/shapes_rle.inc"
 
 
 /* Clear line. */
@@ -135,9 +135,39 @@ void clearScreen(void) {
 }
 
 
+/* Run length decoder state for shapes. */
+typedef struct {
+	const uint8_t *p;
+	uint8_t run, tile;
+} shape_stream_t;
+
+
+/* Get next tile of a run length encoded shape. */
+static inline uint8_t readShapeTile(shape_stream_t *s) {
+	/* Repeat tile while in a run. */
+	if (s->run) {
+		s->run--;
+		return s->tile;
+	}
+
+	/* Get next tile. Start a run on run marker. */
+	s->tile=pgm_read_byte(s->p);
+	s->p++;
+	if (s->tile == SHAPE_RLE_RUN) {
+		s->run=pgm_read_byte(s->p)-1;
+		s->p++;
+		s->tile=pgm_read_byte(s->p);
+		s->p++;
+	}
+
+	return s->tile;
+}
+
+
 /* Draw an arbitrary shape on screen */
 void drawShape(uint8_t x, uint8_t y, const uint8_t *p, uint8_t options) {
 	uint8_t width, height, sx, sy, t;
+	shape_stream_t s;
 
 	/* Get width and height of shape. */
 	width=pgm_read_byte(p);
@@ -145,11 +175,14 @@ void drawShape(uint8_t x, uint8_t y, const uint8_t *p, uint8_t options) {
 	height=pgm_read_byte(p);
 	p++;
 
+	/* Start decoding. */
+	s.p=p;
+	s.run=0;
+
 	/* Draw lines. */
 	for (sy=0;sy<height;sy++)
 		for (sx=0;sx<width;sx++) {
-			t=pgm_read_byte(p);
-			p++;
+			t=readShapeTile(&s);
 
 			/* Honor skip tiles. */
 			if ((Tileset==0 && t!=TILES0_SKIP) || (Tileset==1 && t!=TILES1_SKIP)) {
@@ -166,6 +199,8 @@ void drawShape(uint8_t x, uint8_t y, const uint8_t *p, uint8_t options) {
 /* TODO: So far only skipping the upper part is implemented. */
 void drawShapeAnimated(uint8_t x, uint8_t y, const uint8_t *p, uint8_t phase) {
 	uint8_t width, height, sx, sy, t;
+	uint16_t i;
+	shape_stream_t s;
 
 	/* Get width and height of shape. */
 	width=pgm_read_byte(p);
@@ -176,14 +211,18 @@ void drawShapeAnimated(uint8_t x, uint8_t y, const uint8_t *p, uint8_t phase) {
 	/* Skip if full height was reached. */
 	if (phase>height) return;
 
+	/* Start decoding. */
+	s.p=p;
+	s.run=0;
+
 	/* Skip lines. */
-	p+=(height-phase)*width;
+	for (i=(height-phase)*width;i;i--)
+		readShapeTile(&s);
 
 	/* Draw lines. */
 	for (sy=(height-phase);sy<height;sy++)
 		for (sx=0;sx<width;sx++) {
-			t=pgm_read_byte(p);
-			p++;
+			t=readShapeTile(&s);
 
 			/* Honor skip tiles. */
 			if ((Tileset==0 && t!=TILES0_SKIP) || (Tileset==1 && t!=TILES1_SKIP))
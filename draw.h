@@ -33,6 +33,10 @@
 #define DRAW_OPTION_SHAPE_TILTED      ((1<<0))
 
 
+/* Run marker in run length encoded shapes. Never a tile number, as VRAM holds tiles offset by the RAM tiles. */
+#define SHAPE_RLE_RUN 0xff
+
+
 /* Burger shapes are selected by number. */
 #define SHAPE_BURGER_BUNTOP 0
 #define SHAPE_BURGER_TOMATO 1
@@ -13,6 +13,8 @@
 
 
 #include <avr/io.h> /* for uint16_t */
+#include <stddef.h> /* for offsetof() */
+#include <string.h> /* for memset() */
 #include <uzebox.h> /* for EepromReadBlock() and friends */
 
 
@@ -30,8 +32,40 @@ typedef struct {
 } highscores_t;
 
 
-/* Wuergertime EEPROM block id. */
+/*
+ *  Highscore journal. New entries are appended to the journal block as
+ *  single records instead of rewriting the whole highscore block. The
+ *  journal is compacted into the highscore block when it is full.
+ *
+ *  A record holds the encoded entry and a header byte written last, with
+ *  the entry index and a sequence number. A record is valid if its
+ *  sequence number is the journal sequence number plus its slot. Bumping
+ *  the journal sequence number after compaction invalidates all records
+ *  at once.
+ */
+#define HIGHSCORE_JOURNAL_MAX 4
+#define HIGHSCORE_JOURNAL_RECORD_SIZE ((HIGHSCORE_ENTRY_SIZE+1))
+#define HIGHSCORE_JOURNAL_INDEX_SHIFT 0
+#define HIGHSCORE_JOURNAL_INDEX_MASK ((0x07<<HIGHSCORE_JOURNAL_INDEX_SHIFT))
+#define HIGHSCORE_JOURNAL_SEQUENCE_SHIFT 3
+#define HIGHSCORE_JOURNAL_SEQUENCE_MASK ((0x1f<<HIGHSCORE_JOURNAL_SEQUENCE_SHIFT))
+#define HIGHSCORE_JOURNAL_INVALID 0xff
+
+typedef struct {
+	uint16_t eid;
+	uint8_t  sequence;
+	uint8_t  records[HIGHSCORE_JOURNAL_MAX][HIGHSCORE_JOURNAL_RECORD_SIZE];
+	uint8_t  unused;
+} highscores_journal_t;
+
+
+/*
+ *  Wuergertime EEPROM block ids. The EEPROM has 64 blocks shared by all
+ *  games on the console. Highscores take one block, the journal another.
+ *  Level statistics take 0x5760 to 0x5762 when built in, see statistics.h.
+ */
 #define WUERGERTIME_EID 0x5754
+#define WUERGERTIME_JOURNAL_EID 0x5755
 
 
 /* Default Highscore entries. */
@@ -44,6 +78,16 @@ const uint8_t DefaultHighscores[] PROGMEM={
 };
 
 
+/* Decoded highscore entries. Read from EEPROM once, written back on change only. */
+uint32_t HighscoreName[HIGHSCORE_ENTRY_MAX];
+uint32_t HighscoreScore[HIGHSCORE_ENTRY_MAX];
+
+/* EEPROM address of journal block (0 if there is none), its sequence number and number of records in use. */
+uint16_t HighscoreJournalAddress;
+uint8_t HighscoreJournalSequence;
+uint8_t HighscoreJournalRecords;
+
+
 /* Decode name from highscore entry. */
 uint32_t decodeHighscoreEntryName(uint8_t entry[HIGHSCORE_ENTRY_SIZE]) {
 	uint32_t name;
@@ -84,30 +128,125 @@ void readHighscores(highscores_t *highscores) {
 }
 
 
-/* Read single highscore entry. */
-void readHighscoreEntry(uint8_t index, uint32_t *name, uint32_t *score) {
+/* Encode name and score into highscore entry. */
+void encodeHighscoreEntry(uint8_t entry[HIGHSCORE_ENTRY_SIZE], uint32_t name, uint32_t score) {
+	entry[0]=score & 0xff;
+	score>>=8;
+	entry[1]=score & 0xff;
+	score>>=8;
+	entry[2]=score & 0x7f;
+
+	entry[2]|=(name & 0x01)<<7;
+	name>>=1;
+	entry[3]=name & 0xff;
+	name>>=8;
+	entry[4]=name & 0xff;
+	name>>=8;
+	entry[5]=name & 0xff;
+}
+
+
+/* Insert entry into cache. */
+void insertHighscoreEntry(uint8_t index, uint32_t name, uint32_t score) {
+	uint8_t i;
+
+	/* Move existing entries. */
+	for(i=HIGHSCORE_ENTRY_MAX-1;i>index;i--) {
+		HighscoreName[i]=HighscoreName[i-1];
+		HighscoreScore[i]=HighscoreScore[i-1];
+	}
+
+	/* Place new entry. */
+	HighscoreName[index]=name;
+	HighscoreScore[index]=score;
+}
+
+
+/* Get sequence number of journal record in given slot. */
+uint8_t getHighscoreJournalSequence(uint8_t slot) {
+	return ((HighscoreJournalSequence+slot)<<HIGHSCORE_JOURNAL_SEQUENCE_SHIFT) & HIGHSCORE_JOURNAL_SEQUENCE_MASK;
+}
+
+
+/* Read journal and apply its records to the cache. Create the journal if there is none. */
+void readHighscoreJournal(void) {
+	highscores_journal_t journal;
+	uint8_t i, header, dummy;
+
+	/* No journal yet. */
+	HighscoreJournalAddress=0;
+	HighscoreJournalSequence=0;
+	HighscoreJournalRecords=0;
+
+	/* Read journal block from EEPROM. */
+	if (EepromReadBlock(WUERGERTIME_JOURNAL_EID,(struct EepromBlockStruct *)&journal)) {
+		/* Not found. Create an empty journal. */
+		memset(&journal,HIGHSCORE_JOURNAL_INVALID,sizeof(journal));
+		journal.eid=WUERGERTIME_JOURNAL_EID;
+		journal.sequence=0;
+		if (EepromWriteBlock((struct EepromBlockStruct *)&journal))
+			return;
+	}
+
+	/* Get its address for writing single records. */
+	if (EepromBlockExists(WUERGERTIME_JOURNAL_EID,&HighscoreJournalAddress,&dummy) != EEPROM_OK) {
+		HighscoreJournalAddress=0;
+		return;
+	}
+	HighscoreJournalSequence=journal.sequence;
+
+	/* Apply all valid records in order. */
+	for(i=0;i<HIGHSCORE_JOURNAL_MAX;i++) {
+		/* Stop at first invalid record. */
+		header=journal.records[i][HIGHSCORE_ENTRY_SIZE];
+		if ((header & HIGHSCORE_JOURNAL_SEQUENCE_MASK) != getHighscoreJournalSequence(i))
+			break;
+		if ((header & HIGHSCORE_JOURNAL_INDEX_MASK) >= HIGHSCORE_ENTRY_MAX)
+			break;
+
+		/* Insert entry. */
+		insertHighscoreEntry((header & HIGHSCORE_JOURNAL_INDEX_MASK)>>HIGHSCORE_JOURNAL_INDEX_SHIFT,
+			decodeHighscoreEntryName(journal.records[i]),
+			decodeHighscoreEntryScore(journal.records[i]));
+		HighscoreJournalRecords++;
+	}
+}
+
+
+/* Read highscores into the cache. Called once at startup. */
+void initHighscores(void) {
 	highscores_t highscores;
+	uint8_t i;
 
 	/* Read highscores. */
 	readHighscores(&highscores);
 
-	/* Decode and return the entry. */
-	*name=decodeHighscoreEntryName((uint8_t*)&highscores.entries[index]);
-	*score=decodeHighscoreEntryScore((uint8_t*)&highscores.entries[index]);
+	/* Decode all entries. */
+	for(i=0;i<HIGHSCORE_ENTRY_MAX;i++) {
+		HighscoreName[i]=decodeHighscoreEntryName((uint8_t*)&highscores.entries[i]);
+		HighscoreScore[i]=decodeHighscoreEntryScore((uint8_t*)&highscores.entries[i]);
+	}
+
+	/* Apply entries from journal. */
+	readHighscoreJournal();
+}
+
+
+/* Read single highscore entry. */
+void readHighscoreEntry(uint8_t index, uint32_t *name, uint32_t *score) {
+	/* Return the cached entry. */
+	*name=HighscoreName[index];
+	*score=HighscoreScore[index];
 }
 
 
 /* Find topped highscore entry. */
 uint8_t findToppedHighscoreEntry(uint32_t score) {
-	highscores_t highscores;
 	uint8_t i;
 
-	/* Read highscores. */
-	readHighscores(&highscores);
-
 	/* Go through all entries, lowest highscore first. */
 	for(i=HIGHSCORE_ENTRY_MAX-1;i>0;i--) {
-		if (score < decodeHighscoreEntryScore((uint8_t*)&highscores.entries[i]))
+		if (score < HighscoreScore[i])
 			return (i+1);
 	}
 
@@ -119,35 +258,50 @@ uint8_t findToppedHighscoreEntry(uint32_t score) {
 /* Replace highscore entry. */
 char replaceHighscoreEntry(uint8_t index, uint32_t name, uint32_t score) {
 	highscores_t highscores;
-	uint8_t i,j;
+	uint8_t entry[HIGHSCORE_ENTRY_SIZE];
+	uint16_t address;
+	uint8_t i, free;
+	char result;
 
 	/* Skip when index is invalid */
 	if (index >= HIGHSCORE_ENTRY_MAX) return 0;
 
-	/* Read highscores. */
-	readHighscores(&highscores);
-
-	/* Move existing entries. */
-	for(i=HIGHSCORE_ENTRY_MAX-1;i>index;i--)
-		for(j=0;j<HIGHSCORE_ENTRY_SIZE;j++)
-			highscores.entries[i][j]=highscores.entries[i-1][j];
-
-	/* Encode name and score into highscore entry. */
-	highscores.entries[index][0]=score & 0xff;
-	score>>=8;
-	highscores.entries[index][1]=score & 0xff;
-	score>>=8;
-	highscores.entries[index][2]=score & 0x7f;
+	/* Update cache. */
+	insertHighscoreEntry(index,name,score);
+
+	/* Append a record to the journal if there is room. */
+	if (HighscoreJournalAddress && HighscoreJournalRecords < HIGHSCORE_JOURNAL_MAX) {
+		/* Write the entry first, then the header byte making it valid. */
+		address=HighscoreJournalAddress+offsetof(highscores_journal_t,records)+HighscoreJournalRecords*HIGHSCORE_JOURNAL_RECORD_SIZE;
+		encodeHighscoreEntry(entry,name,score);
+		for(i=0;i<HIGHSCORE_ENTRY_SIZE;i++)
+			WriteEeprom(address+i,entry[i]);
+		WriteEeprom(address+HIGHSCORE_ENTRY_SIZE,getHighscoreJournalSequence(HighscoreJournalRecords)|(index<<HIGHSCORE_JOURNAL_INDEX_SHIFT));
+		HighscoreJournalRecords++;
+		return EEPROM_OK;
+	}
 
-	highscores.entries[index][2]|=(name & 0x01)<<7;
-	name>>=1;
-	highscores.entries[index][3]=name & 0xff;
-	name>>=8;
-	highscores.entries[index][4]=name & 0xff;
-	name>>=8;
-	highscores.entries[index][5]=name & 0xff;
+	/* Journal is full. Skip compaction if there is no room for the highscore block. */
+	if (EepromBlockExists(WUERGERTIME_EID,&address,&free) != EEPROM_OK && free == 0xff)
+		return EEPROM_ERROR_FULL;
+
+	/*
+	 *  Invalidate all journal records by advancing the sequence number past
+	 *  them, before the highscore block is written. The records are in the
+	 *  block then. A power loss in between loses them, but never applies
+	 *  them twice.
+	 */
+	if (HighscoreJournalAddress) {
+		HighscoreJournalSequence+=HIGHSCORE_JOURNAL_MAX;
+		WriteEeprom(HighscoreJournalAddress+offsetof(highscores_journal_t,sequence),HighscoreJournalSequence);
+		HighscoreJournalRecords=0;
+	}
 
-	/* Write highscores. */
+	/* Compact: encode all entries and write highscores. */
+	for(i=0;i<HIGHSCORE_ENTRY_MAX;i++)
+		encodeHighscoreEntry(highscores.entries[i],HighscoreName[i],HighscoreScore[i]);
 	highscores.eid=WUERGERTIME_EID;
-	return EepromWriteBlock((struct EepromBlockStruct *)&highscores);
+	result=EepromWriteBlock((struct EepromBlockStruct *)&highscores);
+
+	return result;
 }
@@ -22,6 +22,7 @@
 #define HIGHSCORE_ENTRY_MAX 5
 
 
+void initHighscores(void);
 void readHighscoreEntry(uint8_t index, uint32_t *name, uint32_t *score);
 uint8_t findToppedHighscoreEntry(uint32_t score);
 char replaceHighscoreEntry(uint8_t index, uint32_t name, uint32_t score);
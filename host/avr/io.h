@@ -0,0 +1,27 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  avr/io.h - host build replacement, for the integer types only.
+ */
+
+
+#ifndef HOST_AVR_IO_H
+#define HOST_AVR_IO_H
+
+
+#include <stdint.h>
+
+
+/* I/O registers go to a dummy array. */
+extern uint8_t HostIo[256];
+#define _SFR_MEM8(a) (HostIo[(a)])
+
+
+#endif /* HOST_AVR_IO_H */
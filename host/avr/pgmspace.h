@@ -0,0 +1,33 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  avr/pgmspace.h - host build replacement, flash is just memory.
+ */
+
+
+#ifndef HOST_AVR_PGMSPACE_H
+#define HOST_AVR_PGMSPACE_H
+
+
+#include <stdint.h>
+#include <string.h>
+
+
+/* No separate address space. Words are read with the pointer's type, as flash tables hold host sized pointers. */
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(p))
+#define pgm_read_dword(p) (*(p))
+#define memcmp_P memcmp
+#define memcpy_P memcpy
+
+
+#endif /* HOST_AVR_PGMSPACE_H */
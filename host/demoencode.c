@@ -0,0 +1,375 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  demoencode.c - encode demo input for the attract mode, and check it.
+ *
+ *  Usage: demoencode [-l level] [-s seed] [-o output] script
+ *         demoencode -c
+ *
+ *    -l level   level the demo plays, default 1
+ *    -s seed    random seed, default 1
+ *    -o output  file to write, default standard output
+ *    -c         check the demo built in, see below
+ *
+ *  Scripts are those of framehash, one line per step, # starts a comment:
+ *
+ *    <frames> <button> [<button> ...]   hold buttons for that many frames
+ *    <frames> -                         no buttons
+ *
+ *  Frames are those the game samples the controllers in, from the level
+ *  description screen on. Blocking fades don't count. In-game, all buttons
+ *  but the directions throw pepper, so they are stored as A.
+ *
+ *  The input is encoded as runs, see controllers.h, and played by the
+ *  game on the host: it is left alone on the start screen until the
+ *  attract mode has shown the demo twice. Both times must play the same,
+ *  and all of the input must be used before the game is over. Frames
+ *  played, score and a hash of all frames shown are written along with
+ *  the input, as DEMO_FRAMES, DEMO_SCORE and DEMO_HASH. Checking plays the
+ *  demo built into the game the same way and compares with those.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+
+/* Local includes. */
+#include "host.h"
+#include "../controllers.h" /* for ControllerDemoState */
+#include "../screens.h" /* for Score */
+
+/* Demo built in, for its check values. */
+#define Demo DemoBuiltIn
+#include "../data/demo.inc"
+#undef Demo
+
+
+/* Input at most, in bytes. */
+#define DEMOENCODE_INPUT_MAX 65536
+
+/* Frames the attract mode takes at most before the demo plays, and after. */
+#define DEMOENCODE_ATTRACT_FRAMES 4000
+
+/* Hash, FNV-1a. */
+#define DEMOENCODE_FNV_BASIS 0x811c9dc5
+#define DEMOENCODE_FNV_PRIME 0x01000193
+
+
+/* Button names. */
+typedef struct {
+	const char *name;
+	uint16_t button;
+} demoencode_button_t;
+
+const demoencode_button_t DemoencodeButtons[]={
+	{ "-", 0 },
+	{ "A", BTN_A },
+	{ "B", BTN_B },
+	{ "X", BTN_X },
+	{ "Y", BTN_Y },
+	{ "SL", BTN_SL },
+	{ "SR", BTN_SR },
+	{ "START", BTN_START },
+	{ "SELECT", BTN_SELECT },
+	{ "UP", BTN_UP },
+	{ "DOWN", BTN_DOWN },
+	{ "LEFT", BTN_LEFT },
+	{ "RIGHT", BTN_RIGHT },
+};
+
+/* Outcome of playing a demo. */
+typedef struct {
+	uint32_t ended;
+	uint32_t frames;
+	uint32_t score;
+	uint32_t hash;
+} demoencode_result_t;
+
+
+/* Encoded input, and frames in it. */
+uint8_t Input[DEMOENCODE_INPUT_MAX];
+unsigned int InputSize;
+uint32_t InputFrames;
+
+/* Play state, outcome of the demo shown first and second. */
+demoencode_result_t Result[2];
+uint8_t Play;
+uint32_t FramesMax;
+
+
+/* Append a byte of input. */
+void putInput(uint8_t byte) {
+	if (InputSize >= DEMOENCODE_INPUT_MAX) {
+		fprintf(stderr,"input too long.\n");
+		exit(1);
+	}
+	Input[InputSize++]=byte;
+}
+
+
+/* Append a run of frames with the same buttons held. */
+void putRun(uint16_t buttons, uint32_t frames) {
+	uint8_t code=((buttons>>CONTROLLER_DEMO_JOYPAD_SHIFT)<<CONTROLLER_DEMO_BUTTONS_SHIFT) & CONTROLLER_DEMO_BUTTONS_MASK;
+	uint32_t n;
+
+	InputFrames+=frames;
+	while (frames) {
+		if (frames < CONTROLLER_DEMO_FRAMES_LONG) {
+			putInput(code|(frames<<CONTROLLER_DEMO_FRAMES_SHIFT));
+			return;
+		}
+		n=(frames < CONTROLLER_DEMO_FRAMES_LONG+255)?frames:CONTROLLER_DEMO_FRAMES_LONG+255;
+		putInput(code|(CONTROLLER_DEMO_FRAMES_LONG<<CONTROLLER_DEMO_FRAMES_SHIFT));
+		putInput(n-CONTROLLER_DEMO_FRAMES_LONG);
+		frames-=n;
+	}
+}
+
+
+/* Read a script and encode it. Steps with the same buttons become one run. */
+void encodeScript(const char *filename, uint8_t level, uint16_t seed) {
+	char line[256], *token, *end;
+	uint16_t buttons, run_buttons=0;
+	uint32_t frames, run_frames=0;
+	unsigned int i;
+	FILE *f;
+
+	if (!(f=fopen(filename,"r"))) {
+		perror(filename);
+		exit(1);
+	}
+
+	/* Level and seed first. */
+	putInput(level);
+	putInput(seed & 0xff);
+	putInput(seed>>8);
+
+	/* Parse line by line. */
+	while (fgets(line,sizeof(line),f)) {
+		if ((end=strchr(line,'#')))
+			*end=0;
+		if (!(token=strtok(line," \t\r\n")))
+			continue;
+		frames=strtoul(token,&end,0);
+		if (*end) {
+			fprintf(stderr,"%s: bad frame count %s.\n",filename,token);
+			exit(1);
+		}
+		buttons=0;
+		while ((token=strtok(NULL," \t\r\n"))) {
+			for (i=0;i<sizeof(DemoencodeButtons)/sizeof(DemoencodeButtons[0]);i++)
+				if (!strcmp(token,DemoencodeButtons[i].name))
+					break;
+			if (i == sizeof(DemoencodeButtons)/sizeof(DemoencodeButtons[0])) {
+				fprintf(stderr,"%s: unknown button %s.\n",filename,token);
+				exit(1);
+			}
+			buttons|=DemoencodeButtons[i].button;
+		}
+
+		/* Other buttons throw pepper, like A. */
+		if (buttons & BTN_NONDIRECTION)
+			buttons=(buttons & BTN_DIRECTIONS)|BTN_A;
+
+		/* Continue run or start a new one. */
+		if (buttons != run_buttons) {
+			putRun(run_buttons,run_frames);
+			run_buttons=buttons;
+			run_frames=0;
+		}
+		run_frames+=frames;
+	}
+	fclose(f);
+
+	/* Last run, end. */
+	putRun(run_buttons,run_frames);
+	putInput(CONTROLLER_DEMO_END);
+}
+
+
+/* Hash bytes into the result. */
+void hashBytes(const void *data, size_t n) {
+	const uint8_t *p=data;
+
+	while (n--)
+		Result[Play].hash=(Result[Play].hash^*p++)*DEMOENCODE_FNV_PRIME;
+}
+
+
+/* Hash a frame as shown. Sprites off screen keep whatever they had before, so they are skipped. */
+void hashFrame(void) {
+	uint8_t i;
+
+	hashBytes(vram,VRAM_TILES_H*VRAM_TILES_V);
+	for (i=0;i<MAX_SPRITES;i++)
+		if (sprites[i].x < OFF_SCREEN) {
+			hashBytes(&i,sizeof(i));
+			hashBytes(&sprites[i],sizeof(struct SpriteStruct));
+		}
+}
+
+
+/* Called each frame. No buttons are pressed, so the attract mode gets to the demo. */
+void watchDemo(void) {
+	if (HostFrame > FramesMax)
+		_exit(1);
+
+	switch (ControllerDemoState) {
+		case CONTROLLER_DEMO_STATE_PLAYING:
+			Result[Play].frames++;
+			Result[Play].score=Score;
+			hashFrame();
+			break;
+		case CONTROLLER_DEMO_STATE_ENDED:
+			Result[Play].ended=1;
+			break;
+		case CONTROLLER_DEMO_STATE_OFF:
+			if (Result[Play].frames && ++Play == 2)
+				stopGame();
+			break;
+	}
+}
+
+
+/* Play demo input on the host, the one built in if NULL. Each game gets a process of its own. */
+int playDemo(const char *input, uint32_t frames, demoencode_result_t result[2]) {
+	int fds[2], status;
+	pid_t pid;
+
+	if (pipe(fds)) {
+		perror("pipe");
+		return -1;
+	}
+	switch ((pid=fork())) {
+		case -1:
+			perror("fork");
+			return -1;
+		case 0:
+			close(fds[0]);
+			HostDemoInput=input;
+			FramesMax=2*(frames+DEMOENCODE_ATTRACT_FRAMES);
+			Result[0].hash=Result[1].hash=DEMOENCODE_FNV_BASIS;
+			runGame(1,&watchDemo);
+			if (write(fds[1],Result,sizeof(Result)) != sizeof(Result))
+				_exit(1);
+			_exit(0);
+	}
+
+	/* Get the outcome. */
+	close(fds[1]);
+	status=(read(fds[0],result,sizeof(Result)) == sizeof(Result))?0:-1;
+	close(fds[0]);
+	waitpid(pid,NULL,0);
+	if (status) {
+		fprintf(stderr,"demo didn't play to its end.\n");
+		return status;
+	}
+	if (memcmp(&result[0],&result[1],sizeof(demoencode_result_t))) {
+		fprintf(stderr,"demo doesn't play the same when shown again.\n");
+		return -1;
+	}
+	return 0;
+}
+
+
+/* Write encoded input with check values. */
+void writeDemo(FILE *f, const char *script, demoencode_result_t *result) {
+	unsigned int i;
+
+	/* Name the script without its directory. */
+	if (strrchr(script,'/'))
+		script=strrchr(script,'/')+1;
+
+	fprintf(f,
+		"/*\n"
+		" *  demo.inc - demo input of the attract mode.\n"
+		" *\n"
+		" *  Generated by host/demoencode from %s, don't edit.\n"
+		" *  Level and seed, then runs of buttons, see controllers.h.\n"
+		" */\n"
+		"\n"
+		"\n"
+		"/* Outcome on the host build, checked by demoencode -c. */\n"
+		"#define DEMO_FRAMES %u\n"
+		"#define DEMO_SCORE %u\n"
+		"#define DEMO_HASH 0x%08x\n"
+		"\n"
+		"const char Demo[] PROGMEM = {",
+		script,result->frames,result->score,result->hash);
+	for (i=0;i<InputSize;i++)
+		fprintf(f,"%s0x%02x,",(i % 12)?" ":"\n\t",Input[i]);
+	fprintf(f,"\n};\n");
+}
+
+
+int main(int argc, char *argv[]) {
+	unsigned int level=1, seed=1, check=0;
+	demoencode_result_t result[2];
+	const char *output=NULL;
+	FILE *f=stdout;
+	int c;
+
+	/* Get options. */
+	while ((c=getopt(argc,argv,"l:s:o:c")) != -1) {
+		switch (c) {
+			case 'l': level=strtoul(optarg,NULL,0); break;
+			case 's': seed=strtoul(optarg,NULL,0); break;
+			case 'o': output=optarg; break;
+			case 'c': check=1; break;
+			default:
+				fprintf(stderr,"Usage: %s [-l level] [-s seed] [-o output] script\n       %s -c\n",argv[0],argv[0]);
+				return 1;
+		}
+	}
+	if ((check && optind != argc) || (!check && optind != argc-1) || !level || level > 255 || seed > 0xffff) {
+		fprintf(stderr,"Usage: %s [-l level] [-s seed] [-o output] script\n       %s -c\n",argv[0],argv[0]);
+		return 1;
+	}
+
+	/* Check the demo built in. */
+	if (check) {
+		if (playDemo(NULL,DEMO_FRAMES,result))
+			return 1;
+		fprintf(stderr,"%u frames, score %u, hash %08x\n",result[0].frames,result[0].score,result[0].hash);
+		if (result[0].frames != DEMO_FRAMES || result[0].score != DEMO_SCORE || result[0].hash != DEMO_HASH) {
+			fprintf(stderr,"demo differs, recorded %u frames, score %u, hash %08x\n",DEMO_FRAMES,DEMO_SCORE,DEMO_HASH);
+			return 1;
+		}
+		return 0;
+	}
+
+	/* Encode and play. */
+	encodeScript(argv[optind],level,seed);
+	if (playDemo((const char *)Input,InputFrames,result))
+		return 1;
+	if (!result[0].ended) {
+		fprintf(stderr,"demo left the game before its input ended.\n");
+		return 1;
+	}
+
+	/* Write it. */
+	if (output && !(f=fopen(output,"w"))) {
+		perror(output);
+		return 1;
+	}
+	writeDemo(f,argv[optind],&result[0]);
+	if (output)
+		fclose(f);
+
+	/* Summary. */
+	fprintf(stderr,"%u frames of input, %u played, %u bytes, %.0f bytes per minute, score %u, hash %08x\n",
+		InputFrames,result[0].frames,InputSize,InputSize*3600.0/result[0].frames,result[0].score,result[0].hash);
+	return 0;
+}
@@ -0,0 +1,172 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  encoder.c - what the tiles on screen mean, as bitplanes.
+ *
+ *  All tiles the game sets go through SetTile() of the host kernel, be it
+ *  by drawing the level, stomping on burgers or squirting on ladders. The
+ *  kernel hands them to encodeTile(), which looks up the class of the tile
+ *  and flips the plane bits that changed for that cell.
+ */
+
+
+#include <stdint.h>
+#include <string.h>
+
+
+/* Local includes. */
+#include "host.h"
+#include "encoder.h"
+#include "../tiles.h" /* for TILES0_... */
+#include "../draw.h" /* for SHAPE_BURGER_..., SCREEN_WIDTH */
+
+
+/* Planes cover the screen, a row of a plane is a word. */
+_Static_assert(SCREEN_TILES_H == SCREEN_WIDTH && SCREEN_TILES_V == SCREEN_HEIGHT,"encoded tiles must be the screen");
+_Static_assert(SCREEN_TILES_H <= 32,"plane rows must fit a word");
+
+
+/* Class bits of a tile. */
+#define ENCODER_BIT(plane) ((1<<ENCODER_PLANE_ ## plane))
+#define ENCODER_UPPER(component) (((SHAPE_BURGER_ ## component+1)<<ENCODER_PLANE_UPPER))
+#define ENCODER_LOWER(component) (((SHAPE_BURGER_ ## component+1)<<ENCODER_PLANE_LOWER))
+#define ENCODER_FULL(component) ((ENCODER_UPPER(component)|ENCODER_LOWER(component)))
+
+/* The five tiles of a burger component or plate. */
+#define ENCODER_BURGER(name,class) \
+	{ TILES0_ ## name ## _LEFT, class }, \
+	{ TILES0_ ## name ## _MIDDLELEFT, class }, \
+	{ TILES0_ ## name ## _MIDDLE, class }, \
+	{ TILES0_ ## name ## _MIDDLERIGHT, class }, \
+	{ TILES0_ ## name ## _RIGHT, class }
+
+
+/* Classes of in-game tiles. Others are background. */
+typedef struct {
+	uint8_t tile;
+	uint16_t class;
+} encoder_class_t;
+
+const encoder_class_t EncoderClassList[]={
+	/* Floors and ladders. Ladder ends are within floors. */
+	{ TILES0_FLOOR_LEFT, ENCODER_BIT(FLOOR) },
+	{ TILES0_FLOOR_MIDDLE, ENCODER_BIT(FLOOR) },
+	{ TILES0_FLOOR_RIGHT, ENCODER_BIT(FLOOR) },
+	{ TILES0_LADDER_LEFT, ENCODER_BIT(LADDER) },
+	{ TILES0_LADDER_RIGHT, ENCODER_BIT(LADDER) },
+	{ TILES0_LADDER_CLEANED_LEFT, ENCODER_BIT(LADDER) },
+	{ TILES0_LADDER_CLEANED_RIGHT, ENCODER_BIT(LADDER) },
+	{ TILES0_LADDER_SQUIRTED_LEFT, ENCODER_BIT(LADDER)|ENCODER_BIT(SQUIRTED) },
+	{ TILES0_LADDER_SQUIRTED_RIGHT, ENCODER_BIT(LADDER)|ENCODER_BIT(SQUIRTED) },
+	{ TILES0_LADDER_WAILED_LEFT, ENCODER_BIT(LADDER)|ENCODER_BIT(SQUIRTED) },
+	{ TILES0_LADDER_WAILED_RIGHT, ENCODER_BIT(LADDER)|ENCODER_BIT(SQUIRTED) },
+	{ TILES0_LADDER_TOP_LEFT, ENCODER_BIT(FLOOR)|ENCODER_BIT(LADDER) },
+	{ TILES0_LADDER_TOP_RIGHT, ENCODER_BIT(FLOOR)|ENCODER_BIT(LADDER) },
+	{ TILES0_LADDER_TOP_FLOOREND_LEFT, ENCODER_BIT(FLOOR)|ENCODER_BIT(LADDER) },
+	{ TILES0_LADDER_TOP_FLOOREND_RIGHT, ENCODER_BIT(FLOOR)|ENCODER_BIT(LADDER) },
+	{ TILES0_LADDER_TOP_UPONLY_LEFT, ENCODER_BIT(FLOOR)|ENCODER_BIT(LADDER) },
+	{ TILES0_LADDER_TOP_UPONLY_RIGHT, ENCODER_BIT(FLOOR)|ENCODER_BIT(LADDER) },
+	{ TILES0_LADDER_BOTTOM_LEFT, ENCODER_BIT(FLOOR)|ENCODER_BIT(LADDER) },
+	{ TILES0_LADDER_BOTTOM_RIGHT, ENCODER_BIT(FLOOR)|ENCODER_BIT(LADDER) },
+	{ TILES0_LADDER_BOTTOM_FLOOREND_LEFT, ENCODER_BIT(FLOOR)|ENCODER_BIT(LADDER) },
+	{ TILES0_LADDER_BOTTOM_FLOOREND_RIGHT, ENCODER_BIT(FLOOR)|ENCODER_BIT(LADDER) },
+
+	/* Plates. */
+	ENCODER_BURGER(PLATE,ENCODER_BIT(PLATE)),
+
+	/* Burger components on full tiles. */
+	ENCODER_BURGER(BURGER_BUNTOP,ENCODER_FULL(BUNTOP)),
+	ENCODER_BURGER(BURGER_TOMATO,ENCODER_FULL(TOMATO)),
+	ENCODER_BURGER(BURGER_PATTY,ENCODER_FULL(PATTY)),
+	ENCODER_BURGER(BURGER_CHEESESALAD,ENCODER_FULL(CHEESESALAD)),
+	ENCODER_BURGER(BURGER_BUNBOTTOM,ENCODER_FULL(BUNBOTTOM)),
+
+	/* Burger components on half tiles, above and below air. */
+	ENCODER_BURGER(BURGER_AIR_BUNTOP,ENCODER_LOWER(BUNTOP)),
+	ENCODER_BURGER(BURGER_BUNTOP_AIR,ENCODER_UPPER(BUNTOP)),
+	ENCODER_BURGER(BURGER_AIR_TOMATO,ENCODER_LOWER(TOMATO)),
+	ENCODER_BURGER(BURGER_TOMATO_AIR,ENCODER_UPPER(TOMATO)),
+	ENCODER_BURGER(BURGER_AIR_PATTY,ENCODER_LOWER(PATTY)),
+	ENCODER_BURGER(BURGER_PATTY_AIR,ENCODER_UPPER(PATTY)),
+	ENCODER_BURGER(BURGER_AIR_CHEESESALAD,ENCODER_LOWER(CHEESESALAD)),
+	ENCODER_BURGER(BURGER_CHEESESALAD_AIR,ENCODER_UPPER(CHEESESALAD)),
+	ENCODER_BURGER(BURGER_AIR_BUNBOTTOM,ENCODER_LOWER(BUNBOTTOM)),
+	ENCODER_BURGER(BURGER_BUNBOTTOM_AIR,ENCODER_UPPER(BUNBOTTOM)),
+
+	/* Burger components on half tiles, stacked. */
+	ENCODER_BURGER(BURGER_BUNTOP_PATTY,ENCODER_UPPER(BUNTOP)|ENCODER_LOWER(PATTY)),
+	ENCODER_BURGER(BURGER_PATTY_BUNBOTTOM,ENCODER_UPPER(PATTY)|ENCODER_LOWER(BUNBOTTOM)),
+	ENCODER_BURGER(BURGER_BUNTOP_TOMATO,ENCODER_UPPER(BUNTOP)|ENCODER_LOWER(TOMATO)),
+	ENCODER_BURGER(BURGER_TOMATO_PATTY,ENCODER_UPPER(TOMATO)|ENCODER_LOWER(PATTY)),
+	ENCODER_BURGER(BURGER_PATTY_CHEESESALAD,ENCODER_UPPER(PATTY)|ENCODER_LOWER(CHEESESALAD)),
+	ENCODER_BURGER(BURGER_CHEESESALAD_BUNBOTTOM,ENCODER_UPPER(CHEESESALAD)|ENCODER_LOWER(BUNBOTTOM)),
+
+	/* Burger components on half tiles, below floor. */
+	ENCODER_BURGER(BURGER_FLOOR_BUNTOP,ENCODER_BIT(FLOOR)|ENCODER_LOWER(BUNTOP)),
+	ENCODER_BURGER(BURGER_FLOOR_TOMATO,ENCODER_BIT(FLOOR)|ENCODER_LOWER(TOMATO)),
+	ENCODER_BURGER(BURGER_FLOOR_PATTY,ENCODER_BIT(FLOOR)|ENCODER_LOWER(PATTY)),
+	ENCODER_BURGER(BURGER_FLOOR_CHEESESALAD,ENCODER_BIT(FLOOR)|ENCODER_LOWER(CHEESESALAD)),
+	ENCODER_BURGER(BURGER_FLOOR_BUNBOTTOM,ENCODER_BIT(FLOOR)|ENCODER_LOWER(BUNBOTTOM)),
+
+	/* Bun ends inside floors. */
+	{ TILES0_BURGER_BUNTOP_INFLOOR_LEFT, ENCODER_BIT(FLOOR)|ENCODER_FULL(BUNTOP) },
+	{ TILES0_BURGER_BUNTOP_INFLOOR_RIGHT, ENCODER_BIT(FLOOR)|ENCODER_FULL(BUNTOP) },
+	{ TILES0_BURGER_BUNBOTTOM_INFLOOR_LEFT, ENCODER_BIT(FLOOR)|ENCODER_UPPER(BUNBOTTOM) },
+	{ TILES0_BURGER_BUNBOTTOM_INFLOOR_RIGHT, ENCODER_BIT(FLOOR)|ENCODER_UPPER(BUNBOTTOM) },
+};
+
+
+/* Planes, and the class of each cell they were last set to. */
+encoder_planes_t EncoderPlanes;
+uint16_t EncoderCells[SCREEN_TILES_V][SCREEN_TILES_H];
+
+/* Class by tile. */
+uint16_t EncoderClasses[256];
+
+
+/* Encode a tile set by the game. */
+void encodeTile(char x, char y, unsigned int tileId) {
+	uint8_t cx=x, cy=y, plane;
+	uint16_t class, changed;
+
+	/* Skip tiles off screen. Only in-game tiles have a meaning. */
+	if (cx >= SCREEN_TILES_H || cy >= SCREEN_TILES_V) return;
+	class=(Tileset == TILESET0)?EncoderClasses[(uint8_t)tileId]:0;
+
+	/* Flip the bits of planes changed. */
+	changed=class^EncoderCells[cy][cx];
+	EncoderCells[cy][cx]=class;
+	for (plane=0;changed;plane++,changed>>=1)
+		if (changed & 0x01)
+			EncoderPlanes[plane][cy]^=((uint32_t)1)<<cx;
+}
+
+
+/* Encode the whole screen, e.g. to check the planes or to start encoding. */
+void encodeScreen(void) {
+	uint8_t x, y;
+
+	memset(EncoderPlanes,0,sizeof(EncoderPlanes));
+	memset(EncoderCells,0,sizeof(EncoderCells));
+	for (y=0;y<SCREEN_TILES_V;y++)
+		for (x=0;x<SCREEN_TILES_H;x++)
+			encodeTile(x,y,vram[y*VRAM_TILES_H+x]-RAM_TILES_COUNT);
+}
+
+
+/* Start encoding the screen, following tiles set from here on. */
+void startEncoder(void) {
+	uint16_t i;
+
+	for (i=0;i<sizeof(EncoderClassList)/sizeof(encoder_class_t);i++)
+		EncoderClasses[EncoderClassList[i].tile]=EncoderClassList[i].class;
+	encodeScreen();
+	HostTileHook=&encodeTile;
+}
@@ -0,0 +1,56 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  encoder.h - what the tiles on screen mean, as bitplanes.
+ *
+ *  Each plane has a 32 bit word per tile row, bit x for tile column x.
+ *  Burger components are drawn with half tile steps, so the component in
+ *  the upper and lower half of a tile are planes of their own, three each
+ *  for SHAPE_BURGER_...+1, 0 for none. A component in one half only is one
+ *  a half tile down, e.g. stomped.
+ *
+ *  The planes are kept up to date by encodeTile() as the game sets tiles,
+ *  so reading them is free. Call startEncoder() before runGame().
+ */
+
+
+#ifndef ENCODER_H
+#define ENCODER_H
+
+
+#include <stdint.h>
+
+
+/* Local includes. */
+#include "mode3.h" /* for SCREEN_TILES_H */
+
+
+/* Planes. */
+#define ENCODER_PLANE_FLOOR 0
+#define ENCODER_PLANE_LADDER 1
+#define ENCODER_PLANE_SQUIRTED 2
+#define ENCODER_PLANE_PLATE 3
+#define ENCODER_PLANE_UPPER 4
+#define ENCODER_PLANE_LOWER 7
+#define ENCODER_PLANES 10
+
+
+typedef uint32_t encoder_planes_t[ENCODER_PLANES][SCREEN_TILES_V];
+
+
+extern encoder_planes_t EncoderPlanes;
+
+
+void encodeTile(char x, char y, unsigned int tileId);
+void encodeScreen(void);
+void startEncoder(void);
+
+
+#endif /* ENCODER_H */
@@ -0,0 +1,506 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  framehash.c - golden frame regression check on the host build.
+ *
+ *  Usage: framehash [-r] [-j jobs] [-l first[-last]] [-n frames] [-s scripts] [-d images] golden
+ *
+ *    -r            record golden hash streams instead of checking
+ *    -j jobs       levels run in parallel, default number of CPUs
+ *    -l first-last levels to run, default all
+ *    -n frames     frames per level, default 3600
+ *    -s scripts    directory with input scripts levelNN.in or default.in
+ *    -d images     directory for diff images, default the golden directory
+ *
+ *  Each level gets its own process. Start is pressed, the game goes to
+ *  the level and the input script is played. After every frame, vram,
+ *  sprites[] and the active tileset are hashed. Recording writes the
+ *  hashes to golden/levelNN.golden, along with the changes to the state,
+ *  so the golden frame can be rebuilt. Checking compares the hashes and
+ *  reports the first diverging frame of each level, with an image of the
+ *  golden frame, the actual frame and their difference side by side.
+ *  A diff image that can't be written counts as an error.
+ *
+ *  Input scripts are text, one line per step, # starts a comment:
+ *
+ *    <frames> <button> [<button> ...]   hold buttons for that many frames
+ *    <frames> -                         no buttons
+ *
+ *  Buttons are A B X Y SL SR START SELECT UP DOWN LEFT RIGHT. No buttons
+ *  are pressed after the end of the script. Without a script, start is
+ *  pressed once after the start screen faded in.
+ *
+ *  Record on the commit before a change, check on the one after it.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/wait.h>
+
+
+/* Local includes. */
+#include "host.h"
+#include "mode3.h"
+#include "png.h"
+#include "../tiles.h" /* for Tiles[] */
+
+
+/* Defaults. */
+#define FRAMEHASH_FRAMES 3600
+#define FRAMEHASH_SCRIPT_MAX 4096
+#define FRAMEHASH_MAGIC "WTFH"
+#define FRAMEHASH_VERSION 1
+
+/* Exit codes of a level process. */
+#define FRAMEHASH_OK 0
+#define FRAMEHASH_DIVERGED 1
+#define FRAMEHASH_ERROR 2
+
+
+/* State hashed each frame, padded to whole hash blocks. */
+#define FRAMEHASH_BLOCK 32
+typedef struct {
+	uint8_t vram[VRAM_TILES_H*VRAM_TILES_V];
+	struct SpriteStruct sprites[MAX_SPRITES];
+	uint8_t tileset[2];
+	uint8_t padding[FRAMEHASH_BLOCK-(VRAM_TILES_H*VRAM_TILES_V+MAX_SPRITES*4+2)%FRAMEHASH_BLOCK];
+} framehash_state_t;
+
+/* Script step. */
+typedef struct {
+	uint32_t frames;
+	uint16_t buttons;
+} framehash_step_t;
+
+
+/* Button names. */
+const struct { const char *name; uint16_t button; } FramehashButtons[]={
+	{ "A", BTN_A }, { "B", BTN_B }, { "X", BTN_X }, { "Y", BTN_Y },
+	{ "SL", BTN_SL }, { "SR", BTN_SR }, { "START", BTN_START }, { "SELECT", BTN_SELECT },
+	{ "UP", BTN_UP }, { "DOWN", BTN_DOWN }, { "LEFT", BTN_LEFT }, { "RIGHT", BTN_RIGHT },
+	{ "-", 0 }
+};
+
+
+/* Options. */
+int Record;
+uint32_t Frames=FRAMEHASH_FRAMES;
+const char *GoldenDirectory;
+const char *ImagesDirectory;
+const char *ScriptsDirectory;
+
+/* Run state of a level process. */
+uint8_t RunLevel;
+FILE *Golden;
+framehash_state_t Actual, Previous;
+framehash_step_t Script[FRAMEHASH_SCRIPT_MAX];
+unsigned int ScriptSteps, ScriptStep;
+uint32_t ScriptFrame;
+
+
+/* Hash of whole blocks, four independent 64 bit lanes like xxHash64, so compilers can keep them in vector registers. */
+#define FRAMEHASH_PRIME1 0x9e3779b185ebca87ULL
+#define FRAMEHASH_PRIME2 0xc2b2ae3d27d4eb4fULL
+#define FRAMEHASH_PRIME3 0x165667b19e3779f9ULL
+#define FRAMEHASH_PRIME4 0x85ebca77c2b2ae63ULL
+#define FRAMEHASH_ROTL(x,r) ((((x)<<(r))|((x)>>(64-(r)))))
+
+uint64_t hashFrame(const void *data, size_t n) {
+	const uint8_t *p=data;
+	uint64_t v[4]={ FRAMEHASH_PRIME1+FRAMEHASH_PRIME2, FRAMEHASH_PRIME2, 0, -FRAMEHASH_PRIME1 };
+	uint64_t h, w;
+	size_t i;
+	int l;
+
+	/* Lanes. */
+	for (i=0;i<n;i+=FRAMEHASH_BLOCK) {
+		for (l=0;l<4;l++) {
+			memcpy(&w,p+i+l*8,8);
+			v[l]=FRAMEHASH_ROTL(v[l]+w*FRAMEHASH_PRIME2,31)*FRAMEHASH_PRIME1;
+		}
+	}
+
+	/* Merge lanes and mix. */
+	h=FRAMEHASH_ROTL(v[0],1)+FRAMEHASH_ROTL(v[1],7)+FRAMEHASH_ROTL(v[2],12)+FRAMEHASH_ROTL(v[3],18);
+	for (l=0;l<4;l++)
+		h=(h^(FRAMEHASH_ROTL(v[l]*FRAMEHASH_PRIME2,31)*FRAMEHASH_PRIME1))*FRAMEHASH_PRIME1+FRAMEHASH_PRIME4;
+	h^=n;
+	h^=h>>33;
+	h*=FRAMEHASH_PRIME2;
+	h^=h>>29;
+	h*=FRAMEHASH_PRIME3;
+	h^=h>>32;
+	return h;
+}
+
+
+/* Little endian file I/O. */
+void putValue(uint64_t value, int bytes) {
+	while (bytes--) {
+		fputc(value & 0xff,Golden);
+		value>>=8;
+	}
+}
+
+int getValue(uint64_t *value, int bytes) {
+	int c, i;
+
+	for (*value=0,i=0;i<bytes;i++) {
+		if ((c=fgetc(Golden)) == EOF)
+			return -1;
+		*value|=(uint64_t)c<<(i*8);
+	}
+	return 0;
+}
+
+
+/* Read input script. Returns 0 if there is none. */
+int readScript(const char *filename) {
+	char line[256], *token, *end;
+	unsigned int i;
+	FILE *f;
+
+	/* Open script. */
+	if (!(f=fopen(filename,"r")))
+		return 0;
+
+	/* Parse line by line. */
+	ScriptSteps=0;
+	while (fgets(line,sizeof(line),f)) {
+		if ((end=strchr(line,'#')))
+			*end=0;
+		if (!(token=strtok(line," \t\r\n")))
+			continue;
+		if (ScriptSteps >= FRAMEHASH_SCRIPT_MAX) {
+			fprintf(stderr,"%s: too many steps.\n",filename);
+			exit(FRAMEHASH_ERROR);
+		}
+		Script[ScriptSteps].frames=strtoul(token,&end,0);
+		if (*end) {
+			fprintf(stderr,"%s: bad frame count %s.\n",filename,token);
+			exit(FRAMEHASH_ERROR);
+		}
+		Script[ScriptSteps].buttons=0;
+		while ((token=strtok(NULL," \t\r\n"))) {
+			for (i=0;i<sizeof(FramehashButtons)/sizeof(FramehashButtons[0]);i++)
+				if (!strcmp(token,FramehashButtons[i].name))
+					break;
+			if (i == sizeof(FramehashButtons)/sizeof(FramehashButtons[0])) {
+				fprintf(stderr,"%s: unknown button %s.\n",filename,token);
+				exit(FRAMEHASH_ERROR);
+			}
+			Script[ScriptSteps].buttons|=FramehashButtons[i].button;
+		}
+		ScriptSteps++;
+	}
+	fclose(f);
+	return 1;
+}
+
+
+/* Get input script for the level: levelNN.in, default.in or built in. */
+void loadScript(void) {
+	char filename[4096];
+
+	if (ScriptsDirectory) {
+		snprintf(filename,sizeof(filename),"%s/level%02u.in",ScriptsDirectory,RunLevel);
+		if (readScript(filename))
+			return;
+		snprintf(filename,sizeof(filename),"%s/default.in",ScriptsDirectory);
+		if (readScript(filename))
+			return;
+	}
+
+	/* Press start once the start screen faded in. */
+	Script[0].frames=HOST_FADER_STEPS*2;
+	Script[0].buttons=0;
+	Script[1].frames=2;
+	Script[1].buttons=BTN_START;
+	ScriptSteps=2;
+}
+
+
+/* Get buttons of the next frame from the script. */
+uint16_t getScriptButtons(void) {
+	while (ScriptStep < ScriptSteps && ScriptFrame >= Script[ScriptStep].frames) {
+		ScriptStep++;
+		ScriptFrame=0;
+	}
+	if (ScriptStep >= ScriptSteps)
+		return 0;
+	ScriptFrame++;
+	return Script[ScriptStep].buttons;
+}
+
+
+/* Get current state. */
+void getState(framehash_state_t *state) {
+	uint16_t tileset=(HostTileTable-Tiles)/MODE3_PIXELS_PER_TILE;
+
+	memcpy(state->vram,vram,sizeof(state->vram));
+	memcpy(state->sprites,sprites,sizeof(state->sprites));
+	state->tileset[0]=tileset;
+	state->tileset[1]=tileset>>8;
+}
+
+
+/* Write a frame: hash, tileset and the changes to vram and sprites since the previous frame. */
+void writeFrame(uint64_t hash) {
+	unsigned int i, n;
+
+	putValue(hash,8);
+	putValue(Actual.tileset[0]|(Actual.tileset[1]<<8),2);
+	for (i=0,n=0;i<sizeof(Actual.vram);i++)
+		n+=(Actual.vram[i] != Previous.vram[i]);
+	putValue(n,2);
+	for (i=0;i<sizeof(Actual.vram);i++) {
+		if (Actual.vram[i] != Previous.vram[i]) {
+			putValue(i,2);
+			putValue(Actual.vram[i],1);
+		}
+	}
+	for (i=0,n=0;i<MAX_SPRITES;i++)
+		n+=!!memcmp(&Actual.sprites[i],&Previous.sprites[i],sizeof(struct SpriteStruct));
+	putValue(n,1);
+	for (i=0;i<MAX_SPRITES;i++) {
+		if (memcmp(&Actual.sprites[i],&Previous.sprites[i],sizeof(struct SpriteStruct))) {
+			putValue(i,1);
+			fwrite(&Actual.sprites[i],sizeof(struct SpriteStruct),1,Golden);
+		}
+	}
+}
+
+
+/* Read a frame into the previous state. Returns -1 at end of file. */
+int readFrame(uint64_t *hash) {
+	uint64_t v, n, i;
+
+	if (getValue(hash,8) || getValue(&v,2))
+		return -1;
+	Previous.tileset[0]=v;
+	Previous.tileset[1]=v>>8;
+	if (getValue(&n,2))
+		return -1;
+	while (n--) {
+		if (getValue(&i,2) || getValue(&v,1) || i >= sizeof(Previous.vram))
+			return -1;
+		Previous.vram[i]=v;
+	}
+	if (getValue(&n,1))
+		return -1;
+	while (n--) {
+		if (getValue(&i,1) || i >= MAX_SPRITES || fread(&Previous.sprites[i],sizeof(struct SpriteStruct),1,Golden) != 1)
+			return -1;
+	}
+	return 0;
+}
+
+
+/* Render a state into an RGB frame. */
+void renderState(uint8_t *rgb, const framehash_state_t *state) {
+	static mode3_frame_t frame;
+	mode3_state_t mode3;
+
+	getMode3State(&mode3);
+	mode3.vram=state->vram;
+	mode3.tiles=Tiles+(state->tileset[0]|(state->tileset[1]<<8))*MODE3_PIXELS_PER_TILE;
+	mode3.sprites=(const mode3_sprite_t *)state->sprites;
+	renderMode3(&frame,&mode3);
+	convertMode3ToRgb(rgb,&frame);
+}
+
+
+/* Write golden, actual and difference side by side. Differing pixels are shown bright, others dimmed. Returns 1 on error. */
+int writeDiffImage(void) {
+	static uint8_t golden[MODE3_WIDTH*MODE3_HEIGHT*3], actual[MODE3_WIDTH*MODE3_HEIGHT*3];
+	static uint8_t image[MODE3_WIDTH*3*MODE3_HEIGHT*3];
+	char filename[4096];
+	unsigned int x, y, c, i, differs;
+
+	/* Render both. */
+	renderState(golden,&Previous);
+	renderState(actual,&Actual);
+
+	/* Compose. */
+	for (y=0;y<MODE3_HEIGHT;y++) {
+		for (x=0;x<MODE3_WIDTH;x++) {
+			i=(y*MODE3_WIDTH+x)*3;
+			differs=memcmp(&golden[i],&actual[i],3);
+			for (c=0;c<3;c++) {
+				image[(y*MODE3_WIDTH*3+x)*3+c]=golden[i+c];
+				image[(y*MODE3_WIDTH*3+MODE3_WIDTH+x)*3+c]=actual[i+c];
+				image[(y*MODE3_WIDTH*3+MODE3_WIDTH*2+x)*3+c]=differs?(c == 1?0:0xff):actual[i+c]/4;
+			}
+		}
+	}
+
+	/* Write. */
+	snprintf(filename,sizeof(filename),"%s/level%02u-frame%u.png",ImagesDirectory,RunLevel,HostFrame);
+	if (writePng(filename,image,MODE3_WIDTH*3,MODE3_HEIGHT)) {
+		perror(filename);
+		return 1;
+	}
+	printf("level %02u: diff image %s\n",RunLevel,filename);
+	return 0;
+}
+
+
+/* Called each frame. */
+void checkFrame(void) {
+	uint64_t hash, golden;
+
+	/* Hash state. */
+	getState(&Actual);
+	hash=hashFrame(&Actual,sizeof(Actual));
+
+	/* Record or compare. */
+	if (Record) {
+		writeFrame(hash);
+		Previous=Actual;
+	} else {
+		if (readFrame(&golden)) {
+			printf("level %02u: golden stream ends before frame %u\n",RunLevel,HostFrame);
+			exit(FRAMEHASH_DIVERGED);
+		}
+		if (hash != golden) {
+			printf("level %02u: diverges at frame %u%s%s%s\n",RunLevel,HostFrame,
+				memcmp(Actual.vram,Previous.vram,sizeof(Actual.vram))?", vram":"",
+				memcmp(Actual.sprites,Previous.sprites,sizeof(Actual.sprites))?", sprites":"",
+				memcmp(Actual.tileset,Previous.tileset,sizeof(Actual.tileset))?", tileset":"");
+			/* An image that can't be written is an error, not just a divergence. */
+			exit(writeDiffImage()?FRAMEHASH_ERROR:FRAMEHASH_DIVERGED);
+		}
+	}
+
+	/* Enough? */
+	if (HostFrame >= Frames)
+		stopGame();
+
+	/* Input for the next frame. */
+	HostJoypad[0]=getScriptButtons();
+}
+
+
+/* Run a level, in its own process. */
+int runLevel(uint8_t level) {
+	char filename[4096];
+	uint64_t v;
+
+	/* Open golden stream. */
+	RunLevel=level;
+	snprintf(filename,sizeof(filename),"%s/level%02u.golden",GoldenDirectory,level);
+	if (!(Golden=fopen(filename,Record?"wb":"rb"))) {
+		perror(filename);
+		return FRAMEHASH_ERROR;
+	}
+
+	/* Header. */
+	if (Record) {
+		fwrite(FRAMEHASH_MAGIC,4,1,Golden);
+		putValue(FRAMEHASH_VERSION,1);
+		putValue(level,1);
+		putValue(Frames,4);
+	} else {
+		if (fread(filename,4,1,Golden) != 1 || memcmp(filename,FRAMEHASH_MAGIC,4) || getValue(&v,1) || v != FRAMEHASH_VERSION || getValue(&v,1) || v != level || getValue(&v,4)) {
+			fprintf(stderr,"level %02u: not a golden stream of this level.\n",level);
+			return FRAMEHASH_ERROR;
+		}
+		if (v < Frames)
+			Frames=v;
+	}
+
+	/* Play. */
+	loadScript();
+	HostJoypad[0]=getScriptButtons();
+	runGame(level,&checkFrame);
+
+	/* Done. */
+	if (fclose(Golden)) {
+		perror(filename);
+		return FRAMEHASH_ERROR;
+	}
+	printf("level %02u: %s %u frames\n",level,Record?"recorded":"ok,",HostFrame);
+	return FRAMEHASH_OK;
+}
+
+
+int main(int argc, char *argv[]) {
+	unsigned int first=1, last, level, jobs, running=0, failed=0, errors=0;
+	struct timespec start, end;
+	int c, status;
+	char *end_of_number;
+
+	/* Get options. */
+	last=getHostLevelsCount();
+	jobs=sysconf(_SC_NPROCESSORS_ONLN);
+	while ((c=getopt(argc,argv,"rj:l:n:s:d:")) != -1) {
+		switch (c) {
+			case 'r': Record=1; break;
+			case 'j': jobs=strtoul(optarg,NULL,0); break;
+			case 'l':
+				first=last=strtoul(optarg,&end_of_number,0);
+				if (*end_of_number == '-')
+					last=strtoul(end_of_number+1,NULL,0);
+				break;
+			case 'n': Frames=strtoul(optarg,NULL,0); break;
+			case 's': ScriptsDirectory=optarg; break;
+			case 'd': ImagesDirectory=optarg; break;
+			default:
+				fprintf(stderr,"Usage: %s [-r] [-j jobs] [-l first[-last]] [-n frames] [-s scripts] [-d images] golden\n",argv[0]);
+				return FRAMEHASH_ERROR;
+		}
+	}
+	if (optind != argc-1 || !first || first > last || last > 255 || !jobs) {
+		fprintf(stderr,"Usage: %s [-r] [-j jobs] [-l first[-last]] [-n frames] [-s scripts] [-d images] golden\n",argv[0]);
+		return FRAMEHASH_ERROR;
+	}
+	GoldenDirectory=argv[optind];
+	if (!ImagesDirectory)
+		ImagesDirectory=GoldenDirectory;
+
+	/* Run levels in parallel, a process each. */
+	clock_gettime(CLOCK_MONOTONIC,&start);
+	setvbuf(stdout,NULL,_IOLBF,0);
+	for (level=first;level<=last || running;) {
+		/* Start another one? */
+		if (level<=last && running<jobs) {
+			switch (fork()) {
+				case -1:
+					perror("fork");
+					return FRAMEHASH_ERROR;
+				case 0:
+					exit(runLevel(level));
+			}
+			level++;
+			running++;
+			continue;
+		}
+
+		/* Wait for one to finish. */
+		if (wait(&status) < 0)
+			break;
+		running--;
+		if (!WIFEXITED(status) || WEXITSTATUS(status) == FRAMEHASH_ERROR)
+			errors++;
+		else if (WEXITSTATUS(status) == FRAMEHASH_DIVERGED)
+			failed++;
+	}
+	clock_gettime(CLOCK_MONOTONIC,&end);
+
+	/* Summary. */
+	printf("%u levels, %u diverged, %u errors, %.1f s\n",last-first+1,failed,errors,
+		(end.tv_sec-start.tv_sec)+(end.tv_nsec-start.tv_nsec)/1e9);
+	return errors?FRAMEHASH_ERROR:(failed?FRAMEHASH_DIVERGED:FRAMEHASH_OK);
+}
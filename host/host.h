@@ -0,0 +1,52 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  host.h - running the game on the host, frame by frame.
+ */
+
+
+#ifndef HOST_H
+#define HOST_H
+
+
+#include <stdint.h>
+
+
+/* Local includes. */
+#include "uzebox.h"
+#include "mode3.h"
+
+
+/* Fader steps of the kernel. A blocking fade takes that many vsyncs per speed. */
+#define HOST_FADER_STEPS 12
+
+
+/* Called at each vsync, after the game committed its sprites. Set HostJoypad[] for the next frame here. */
+typedef void (*host_vsync_hook_t)(void);
+
+/* Called for each tile set, with the arguments of SetTile(). */
+typedef void (*host_tile_hook_t)(char x, char y, unsigned int tileId);
+
+
+extern uint32_t HostFrame;
+extern uint16_t HostJoypad[2];
+extern host_tile_hook_t HostTileHook;
+extern const char *HostTileTable;
+extern const char *HostSpriteTileTable;
+extern uint8_t HostEeprom[EEPROM_SIZE];
+
+
+int runGame(uint8_t level, host_vsync_hook_t hook);
+void stopGame(void);
+void getMode3State(mode3_state_t *state);
+uint8_t getHostLevelsCount(void);
+
+
+#endif /* HOST_H */
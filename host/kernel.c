@@ -0,0 +1,279 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  kernel.c - host build replacement for the kernel API used by the game.
+ *
+ *  The game runs unchanged on top of this. Each WaitVsync() is one frame:
+ *  the hook given to runGame() is called, may look at vram and sprites[]
+ *  and sets the buttons ReadJoypad() returns for the next frame. Blocking
+ *  fades take as many frames as on the real thing, so frame numbers match.
+ *  There is no sound, and the EEPROM starts out erased like a fresh one in
+ *  the emulator.
+ *
+ *  The game has no way to restart from scratch, so runGame() works once
+ *  per process. Tools fork a process per run.
+ */
+
+
+#include <stdint.h>
+#include <string.h>
+#include <setjmp.h>
+
+
+/* Local includes. */
+#include "host.h"
+#include "../screens.h" /* for LevelDrawings[] */
+
+
+/* Entry point of the game, renamed by the host Makefile. */
+int wuergertimeMain(void);
+
+
+/*
+ *  Kernel state. The game reads tiles off screen with wrapped coordinates,
+ *  e.g. for burgers falling in from above. The real thing reads other RAM
+ *  then, here it's a guard area covering any 8 bit coordinates.
+ */
+#define HOST_VRAM_SIZE ((256*VRAM_TILES_H+256))
+struct SpriteStruct sprites[MAX_SPRITES];
+uint8_t vram[HOST_VRAM_SIZE];
+uint8_t HostIo[256];
+uint8_t HostFontTilesIndex;
+const char *HostTileTable;
+const char *HostSpriteTileTable;
+
+/* Fader state. */
+uint8_t HostFadeStep;
+int8_t HostFadeDirection;
+uint8_t HostFadeSpeed;
+uint8_t HostFadeCounter;
+
+/* EEPROM, erased. */
+uint8_t HostEeprom[EEPROM_SIZE]={ [0 ... EEPROM_SIZE-1]=0xff };
+
+/* Run state. */
+uint8_t HostStartLevel=1;
+const char *HostDemoInput;
+uint32_t HostFrame;
+uint16_t HostJoypad[2];
+host_vsync_hook_t HostVsyncHook;
+host_tile_hook_t HostTileHook;
+jmp_buf HostStop;
+
+
+/*
+ *  Video
+ */
+void SetTile(char x, char y, unsigned int tileId) {
+	vram[(uint8_t)y*VRAM_TILES_H+(uint8_t)x]=tileId+RAM_TILES_COUNT;
+	if (HostTileHook)
+		HostTileHook(x,y,tileId);
+}
+
+void Fill(int x, int y, int width, int height, int tile) {
+	int cx, cy;
+
+	for (cy=y;cy<y+height;cy++)
+		for (cx=x;cx<x+width;cx++)
+			SetTile(cx,cy,tile);
+}
+
+void Print(int x, int y, const char *string) {
+	char c;
+
+	/* Font starts with space. */
+	while ((c=*string++))
+		SetTile(x++,y,((c & 127)-32)+HostFontTilesIndex);
+}
+
+void SetTileTable(const char *data) {
+	HostTileTable=data;
+}
+
+void SetFontTilesIndex(unsigned char index) {
+	HostFontTilesIndex=index;
+}
+
+void SetSpritesTileTable(const char *data) {
+	HostSpriteTileTable=data;
+}
+
+
+/* One frame. */
+void hostVsync(void) {
+	/* Fader steps every speed frames. */
+	if (HostFadeDirection && ++HostFadeCounter >= HostFadeSpeed) {
+		HostFadeCounter=0;
+		HostFadeStep+=HostFadeDirection;
+		if (HostFadeStep == 0 || HostFadeStep == HOST_FADER_STEPS)
+			HostFadeDirection=0;
+	}
+
+	/* Let the tool look at the frame. */
+	HostFrame++;
+	if (HostVsyncHook)
+		HostVsyncHook();
+}
+
+void WaitVsync(int count) {
+	while (count--)
+		hostVsync();
+}
+
+/* Start a fade, wait for it to complete if blocking. */
+void hostFade(unsigned char speed, bool blocking, int8_t direction) {
+	HostFadeSpeed=speed?speed:1;
+	HostFadeCounter=0;
+	HostFadeStep=(direction > 0)?0:HOST_FADER_STEPS;
+	HostFadeDirection=direction;
+	while (blocking && HostFadeDirection)
+		hostVsync();
+}
+
+void FadeIn(unsigned char speed, bool blocking) {
+	hostFade(speed,blocking,1);
+}
+
+void FadeOut(unsigned char speed, bool blocking) {
+	hostFade(speed,blocking,-1);
+}
+
+
+/*
+ *  Controllers
+ */
+unsigned int ReadJoypad(unsigned char joypadNo) {
+	return HostJoypad[joypadNo & 1];
+}
+
+
+/*
+ *  EEPROM
+ */
+uint16_t getHostEepromId(uint8_t block) {
+	return HostEeprom[block*EEPROM_BLOCK_SIZE]|(HostEeprom[block*EEPROM_BLOCK_SIZE+1]<<8);
+}
+
+/* Block number of a block id, 0 if not found. */
+uint8_t findHostEepromBlock(unsigned int blockId) {
+	uint8_t i;
+
+	for (i=1;i<EEPROM_SIZE/EEPROM_BLOCK_SIZE;i++)
+		if (getHostEepromId(i) == blockId)
+			return i;
+	return 0;
+}
+
+void formatHostEeprom(void) {
+	memset(HostEeprom,0xff,EEPROM_SIZE);
+	HostEeprom[0]=EEPROM_SIGNATURE & 0xff;
+	HostEeprom[1]=EEPROM_SIGNATURE>>8;
+}
+
+char EepromWriteBlock(struct EepromBlockStruct *block) {
+	uint8_t i;
+
+	/* Format a fresh EEPROM. */
+	if (getHostEepromId(0) != EEPROM_SIGNATURE)
+		formatHostEeprom();
+	if (block->id == EEPROM_FREE_BLOCK || block->id == EEPROM_SIGNATURE)
+		return EEPROM_ERROR_INVALID_BLOCK;
+
+	/* Overwrite the block or take the first free one. */
+	if (!(i=findHostEepromBlock(block->id)) && !(i=findHostEepromBlock(EEPROM_FREE_BLOCK)))
+		return EEPROM_ERROR_FULL;
+	memcpy(&HostEeprom[i*EEPROM_BLOCK_SIZE],block,EEPROM_BLOCK_SIZE);
+	return EEPROM_OK;
+}
+
+char EepromReadBlock(unsigned int blockId, struct EepromBlockStruct *block) {
+	uint8_t i;
+
+	if (getHostEepromId(0) != EEPROM_SIGNATURE)
+		return EEPROM_ERROR_NOT_FORMATTED;
+	if (!(i=findHostEepromBlock(blockId)))
+		return EEPROM_ERROR_BLOCK_NOT_FOUND;
+	memcpy(block,&HostEeprom[i*EEPROM_BLOCK_SIZE],EEPROM_BLOCK_SIZE);
+	return EEPROM_OK;
+}
+
+char EepromBlockExists(unsigned int blockId, uint16_t *eepromAddr, uint8_t *nextFreeBlockId) {
+	uint8_t i;
+
+	if (getHostEepromId(0) != EEPROM_SIGNATURE)
+		return EEPROM_ERROR_NOT_FORMATTED;
+	*nextFreeBlockId=(i=findHostEepromBlock(EEPROM_FREE_BLOCK))?i:0xff;
+	if (!(i=findHostEepromBlock(blockId)))
+		return EEPROM_ERROR_BLOCK_NOT_FOUND;
+	*eepromAddr=i*EEPROM_BLOCK_SIZE;
+	return EEPROM_OK;
+}
+
+void WriteEeprom(unsigned int addr, unsigned char value) {
+	HostEeprom[addr % EEPROM_SIZE]=value;
+}
+
+unsigned char ReadEeprom(unsigned int addr) {
+	return HostEeprom[addr % EEPROM_SIZE];
+}
+
+
+/*
+ *  Sound
+ */
+void InitMusicPlayer(const struct PatchStruct *patchPointersParam) {
+}
+
+void TriggerFx(unsigned char patch, unsigned char volume, bool retrig) {
+}
+
+
+/*
+ *  Running the game
+ */
+
+/* Run the game with start pressed leading to the given level. Returns when the hook calls stopGame(). */
+int runGame(uint8_t level, host_vsync_hook_t hook) {
+	HostStartLevel=level;
+	HostVsyncHook=hook;
+	if (!setjmp(HostStop))
+		wuergertimeMain();
+	return HostFrame;
+}
+
+void stopGame(void) {
+	longjmp(HostStop,1);
+}
+
+
+/* Kernel state as seen by the video mode. */
+void getMode3State(mode3_state_t *state) {
+	state->vram=vram;
+	state->ramtiles=NULL;
+	state->tiles=HostTileTable;
+	state->spritetiles=HostSpriteTileTable;
+	state->sprites=(const mode3_sprite_t *)sprites;
+	state->sprites_count=MAX_SPRITES;
+	state->user_ramtiles_count=0;
+}
+
+
+/* Number of levels in flash. Level drawings end with an empty one, like in selectLevel(). */
+uint8_t getHostLevelsCount(void) {
+	const uint8_t *p=LevelDrawings;
+	uint8_t n=0;
+
+	while (*p) {
+		while (*p) p++;
+		p++;
+		n++;
+	}
+	return n;
+}
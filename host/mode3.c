@@ -0,0 +1,229 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  mode3.c - host side renderer for uzebox video mode 3.
+ *
+ *  Renders vram, the tile tables and sprites[] into a 240x224 frame the
+ *  way the mode 3 kernel does: background tiles from the tile table or
+ *  user ram tiles, then sprites in order of sprites[], each one blitted
+ *  into ram tiles. Pixels in TRANSLUCENT_COLOR are transparent. When the
+ *  ram tiles run out, the remaining sprite parts are dropped just like on
+ *  the real thing, so sprite flicker and drop-outs show up in the frame.
+ *
+ *  Tile rows and sprite transparency use SSE2 where available, two rows
+ *  of 8 pixels per register. Define MODE3_NO_SIMD to get the scalar code
+ *  on any host, e.g. to compare both.
+ */
+
+
+#include <stdint.h>
+#include <string.h>
+#if defined(__SSE2__) && !defined(MODE3_NO_SIMD)
+#define MODE3_SSE2
+#include <emmintrin.h>
+#endif
+
+
+/* Local includes. */
+#include "mode3.h"
+
+
+/* Sprite tiles cover up to 2x2 background tiles. */
+#define MODE3_CELLS_MAX 2
+
+
+/* Palette, uzebox colors are BBGGGRRR. Red in the lowest byte. */
+uint32_t Mode3Palette[256];
+
+
+/* Build palette once. */
+void initMode3Palette(void) {
+	unsigned int c;
+
+	/* Already done? */
+	if (Mode3Palette[0xff])
+		return;
+
+	/* Scale each component to 8 bits. */
+	for (c=0;c<256;c++)
+		Mode3Palette[c]=((c & 0x07)*255/7)|((((c>>3) & 0x07)*255/7)<<8)|(((c>>6)*255/3)<<16);
+}
+
+
+/* Get a tile's pixels for a vram entry. NULL for a user ram tile without ram tiles. */
+const uint8_t *getMode3Tile(const mode3_state_t *state, uint8_t v) {
+	if (v >= RAM_TILES_COUNT)
+		return (const uint8_t *)state->tiles+(v-RAM_TILES_COUNT)*MODE3_PIXELS_PER_TILE;
+	if (state->ramtiles)
+		return state->ramtiles+v*MODE3_PIXELS_PER_TILE;
+	return NULL;
+}
+
+
+/* Copy a tile into the frame. */
+void blitMode3Tile(uint8_t *dst, const uint8_t *src) {
+#ifdef MODE3_SSE2
+	__m128i rows;
+	uint8_t i;
+
+	/* Two rows per register. */
+	for (i=0;i<MODE3_TILE_SIZE;i+=2) {
+		rows=_mm_loadu_si128((const __m128i *)(src+i*MODE3_TILE_SIZE));
+		_mm_storel_epi64((__m128i *)(dst+i*MODE3_STRIDE),rows);
+		_mm_storel_epi64((__m128i *)(dst+(i+1)*MODE3_STRIDE),_mm_srli_si128(rows,8));
+	}
+#else
+	uint8_t i;
+
+	/* Row by row. */
+	for (i=0;i<MODE3_TILE_SIZE;i++)
+		memcpy(dst+i*MODE3_STRIDE,src+i*MODE3_TILE_SIZE,MODE3_TILE_SIZE);
+#endif
+}
+
+
+/* Blend sprite rows into the frame. Pixels are drawn where the mask is set and the sprite isn't transparent. */
+void blendMode3Sprite(uint8_t *dst, const uint64_t *rows, const uint64_t *masks, uint8_t count) {
+#ifdef MODE3_SSE2
+	uint8_t scratch[MODE3_TILE_SIZE];
+	__m128i translucent=_mm_set1_epi8((char)TRANSLUCENT_COLOR);
+	__m128i s, m, d;
+	uint8_t *d0, *d1;
+	uint8_t i;
+
+	/* Two rows per register. A missing second row goes to a scratch row. */
+	for (i=0;i<count;i+=2) {
+		d0=dst+i*MODE3_STRIDE;
+		d1=(i+1 < count)?d0+MODE3_STRIDE:scratch;
+		s=_mm_loadu_si128((const __m128i *)(rows+i));
+		m=_mm_andnot_si128(_mm_cmpeq_epi8(s,translucent),_mm_loadu_si128((const __m128i *)(masks+i)));
+		d=_mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)d0),_mm_loadl_epi64((const __m128i *)d1));
+		d=_mm_or_si128(_mm_and_si128(m,s),_mm_andnot_si128(m,d));
+		_mm_storel_epi64((__m128i *)d0,d);
+		_mm_storel_epi64((__m128i *)d1,_mm_srli_si128(d,8));
+	}
+#else
+	uint8_t i, j, p;
+
+	/* Pixel by pixel. */
+	for (i=0;i<count;i++) {
+		for (j=0;j<MODE3_TILE_SIZE;j++) {
+			p=rows[i]>>(j*8);
+			if (((masks[i]>>(j*8)) & 0xff) && p != TRANSLUCENT_COLOR)
+				dst[i*MODE3_STRIDE+j]=p;
+		}
+	}
+#endif
+}
+
+
+/* Reverse the pixels of a sprite row. Pixel 0 is the lowest byte. */
+uint64_t flipMode3Row(uint64_t row) {
+	return __builtin_bswap64(row);
+}
+
+
+/* Render a frame. */
+void renderMode3(mode3_frame_t *frame, const mode3_state_t *state) {
+	uint8_t ramtile[SCREEN_TILES_V][SCREEN_TILES_H];
+	uint64_t rows[MODE3_TILE_SIZE+1], masks[MODE3_TILE_SIZE+1];
+	uint8_t visible[MODE3_CELLS_MAX][MODE3_CELLS_MAX];
+	const mode3_sprite_t *s;
+	const uint8_t *src;
+	uint8_t i, j, k, x, y, cx, cy, count, nextramtile;
+
+	/* Background. Note which cells are ram tiles already. */
+	for (y=0;y<SCREEN_TILES_V;y++) {
+		for (x=0;x<SCREEN_TILES_H;x++) {
+			ramtile[y][x]=(state->vram[y*VRAM_TILES_H+x] < RAM_TILES_COUNT);
+			src=getMode3Tile(state,state->vram[y*VRAM_TILES_H+x]);
+			if (src)
+				blitMode3Tile(&frame->pixels[y*MODE3_TILE_SIZE][x*MODE3_TILE_SIZE],src);
+			else
+				for (i=0;i<MODE3_TILE_SIZE;i++)
+					memset(&frame->pixels[y*MODE3_TILE_SIZE+i][x*MODE3_TILE_SIZE],0,MODE3_TILE_SIZE);
+		}
+	}
+
+	/* Sprites in order, later ones on top. */
+	nextramtile=state->user_ramtiles_count;
+	for (k=0;k<state->sprites_count;k++) {
+		s=&state->sprites[k];
+
+		/* Off screen? */
+		if (s->x >= MODE3_WIDTH || s->y >= MODE3_HEIGHT)
+			continue;
+
+		/* Get a ram tile for each background tile covered, as long as there are free ones. */
+		for (i=0;i<MODE3_CELLS_MAX;i++) {
+			for (j=0;j<MODE3_CELLS_MAX;j++) {
+				cy=(s->y/MODE3_TILE_SIZE)+i;
+				cx=(s->x/MODE3_TILE_SIZE)+j;
+				visible[i][j]=0;
+				if ((i && !(s->y % MODE3_TILE_SIZE)) || (j && !(s->x % MODE3_TILE_SIZE)))
+					continue;
+				if (cy >= SCREEN_TILES_V || cx >= SCREEN_TILES_H)
+					continue;
+				if (!ramtile[cy][cx] && nextramtile < RAM_TILES_COUNT) {
+					ramtile[cy][cx]=1;
+					nextramtile++;
+				}
+				visible[i][j]=ramtile[cy][cx];
+			}
+		}
+
+		/* Get sprite rows, flipped as needed, and which pixels fall into a ram tile. */
+		src=(const uint8_t *)state->spritetiles+s->tileIndex*MODE3_PIXELS_PER_TILE;
+		count=(MODE3_HEIGHT-s->y < MODE3_TILE_SIZE)?MODE3_HEIGHT-s->y:MODE3_TILE_SIZE;
+		for (i=0;i<count;i++) {
+			memcpy(&rows[i],src+((s->flags & SPRITE_FLIP_Y)?MODE3_TILE_SIZE-1-i:i)*MODE3_TILE_SIZE,MODE3_TILE_SIZE);
+			if (s->flags & SPRITE_FLIP_X)
+				rows[i]=flipMode3Row(rows[i]);
+			cy=((s->y % MODE3_TILE_SIZE)+i)/MODE3_TILE_SIZE;
+			j=MODE3_TILE_SIZE-(s->x % MODE3_TILE_SIZE);
+			masks[i]=(visible[cy][0]?((j == MODE3_TILE_SIZE)?~0ULL:(1ULL<<(j*8))-1):0)
+				|(visible[cy][1]?~((j == MODE3_TILE_SIZE)?~0ULL:(1ULL<<(j*8))-1):0);
+		}
+
+		/* Draw. Row after the last one is blended into scratch space by SIMD code. */
+		rows[count]=masks[count]=0;
+		blendMode3Sprite(&frame->pixels[s->y][s->x],rows,masks,count);
+	}
+}
+
+
+/* Convert a frame to 8 bit RGB, 3 bytes per pixel, no padding. */
+void convertMode3ToRgb(uint8_t *rgb, const mode3_frame_t *frame) {
+	uint32_t c;
+	unsigned int x, y;
+
+	/* Build palette if not done yet. */
+	initMode3Palette();
+
+	/* Pixel by pixel through the palette. */
+	for (y=0;y<MODE3_HEIGHT;y++) {
+		for (x=0;x<MODE3_WIDTH;x++) {
+			c=Mode3Palette[frame->pixels[y][x]];
+			*rgb++=c;
+			*rgb++=c>>8;
+			*rgb++=c>>16;
+		}
+	}
+}
+
+
+/* Name of the blitting code in use. */
+const char *getMode3Implementation(void) {
+#ifdef MODE3_SSE2
+	return "sse2";
+#else
+	return "scalar";
+#endif
+}
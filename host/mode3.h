@@ -0,0 +1,90 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  mode3.h - host side renderer for uzebox video mode 3.
+ */
+
+
+#ifndef MODE3_H
+#define MODE3_H
+
+
+#include <stdint.h>
+
+
+/* Kernel configuration, as in default/Makefile. */
+#ifndef SCREEN_TILES_H
+#define SCREEN_TILES_H 30
+#endif
+#ifndef SCREEN_TILES_V
+#define SCREEN_TILES_V 28
+#endif
+#ifndef VRAM_TILES_H
+#define VRAM_TILES_H SCREEN_TILES_H
+#endif
+#ifndef RAM_TILES_COUNT
+#define RAM_TILES_COUNT 32
+#endif
+#ifndef MAX_SPRITES
+#define MAX_SPRITES 24
+#endif
+#ifndef TRANSLUCENT_COLOR
+#define TRANSLUCENT_COLOR 0xfe
+#endif
+
+
+/* Sprite flags as in the kernel. */
+#ifndef SPRITE_FLIP_X
+#define SPRITE_FLIP_X 1
+#define SPRITE_FLIP_Y 2
+#endif
+
+
+/* Frame dimensions. Rows are padded so a sprite row never crosses the end of a row. */
+#define MODE3_TILE_SIZE 8
+#define MODE3_PIXELS_PER_TILE ((MODE3_TILE_SIZE*MODE3_TILE_SIZE))
+#define MODE3_WIDTH ((SCREEN_TILES_H*MODE3_TILE_SIZE))
+#define MODE3_HEIGHT ((SCREEN_TILES_V*MODE3_TILE_SIZE))
+#define MODE3_STRIDE 256
+
+
+/* Same layout as the kernel's struct SpriteStruct, so sprites[] may be passed directly. */
+typedef struct {
+	uint8_t x;
+	uint8_t y;
+	uint8_t tileIndex;
+	uint8_t flags;
+} mode3_sprite_t;
+
+
+/* What the kernel would see at vsync. */
+typedef struct {
+	const uint8_t *vram;          /* VRAM_TILES_H wide, entries are tile index + RAM_TILES_COUNT */
+	const uint8_t *ramtiles;      /* user ram tiles for vram entries below RAM_TILES_COUNT, may be NULL */
+	const char *tiles;            /* active tile table, e.g. Tiles plus the SetTileset() offset */
+	const char *spritetiles;      /* sprite tile table, SpriteTiles */
+	const mode3_sprite_t *sprites;
+	uint8_t sprites_count;        /* usually MAX_SPRITES */
+	uint8_t user_ramtiles_count;  /* ram tiles taken by the game, not available to sprites */
+} mode3_state_t;
+
+
+/* Rendered frame in palette colors. */
+typedef struct {
+	uint8_t pixels[MODE3_HEIGHT][MODE3_STRIDE];
+} mode3_frame_t;
+
+
+void renderMode3(mode3_frame_t *frame, const mode3_state_t *state);
+void convertMode3ToRgb(uint8_t *rgb, const mode3_frame_t *frame);
+const char *getMode3Implementation(void);
+
+
+#endif /* MODE3_H */
@@ -0,0 +1,149 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  png.c - minimal PNG writer for host tools.
+ *
+ *  Writes 8 bit RGB without compression (stored deflate blocks), so no
+ *  zlib is needed. Screenshots are small enough for that.
+ */
+
+
+#include <stdio.h>
+#include <stdint.h>
+
+
+/* Local includes. */
+#include "png.h"
+
+
+/* Largest stored deflate block. */
+#define PNG_STORED_MAX 65535
+
+
+/* CRC of chunks. */
+uint32_t PngCrcTable[256];
+
+void initPngCrc(void) {
+	uint32_t c;
+	unsigned int i, j;
+
+	/* Already done? */
+	if (PngCrcTable[1])
+		return;
+
+	for (i=0;i<256;i++) {
+		for (c=i,j=0;j<8;j++)
+			c=(c & 1)?0xedb88320^(c>>1):c>>1;
+		PngCrcTable[i]=c;
+	}
+}
+
+uint32_t updatePngCrc(uint32_t crc, const uint8_t *p, unsigned int n) {
+	while (n--)
+		crc=PngCrcTable[(crc^*p++) & 0xff]^(crc>>8);
+	return crc;
+}
+
+
+/* Chunk writing, big endian words. */
+typedef struct {
+	FILE *f;
+	uint32_t crc;
+} png_chunk_t;
+
+void putPngBytes(png_chunk_t *chunk, const uint8_t *p, unsigned int n) {
+	fwrite(p,1,n,chunk->f);
+	chunk->crc=updatePngCrc(chunk->crc,p,n);
+}
+
+void putPngWord(png_chunk_t *chunk, uint32_t w) {
+	uint8_t b[4]={ w>>24, w>>16, w>>8, w };
+
+	putPngBytes(chunk,b,4);
+}
+
+void beginPngChunk(png_chunk_t *chunk, const char *type, uint32_t length) {
+	putPngWord(chunk,length);
+	chunk->crc=0xffffffff;
+	putPngBytes(chunk,(const uint8_t *)type,4);
+}
+
+void endPngChunk(png_chunk_t *chunk) {
+	putPngWord(chunk,chunk->crc^0xffffffff);
+}
+
+
+/* Write an RGB image. Returns 0 on success. */
+int writePng(const char *filename, const uint8_t *rgb, unsigned int width, unsigned int height) {
+	static const uint8_t signature[8]={ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+	png_chunk_t chunk;
+	uint32_t size, remaining, block, adler_a=1, adler_b=0;
+	uint32_t x, y, i, j, n;
+	uint8_t b[5], filter=0;
+	const uint8_t *p;
+
+	/* Open file. */
+	if (!(chunk.f=fopen(filename,"wb")))
+		return -1;
+	initPngCrc();
+	fwrite(signature,1,sizeof(signature),chunk.f);
+
+	/* Header: 8 bit RGB, no interlace. */
+	beginPngChunk(&chunk,"IHDR",13);
+	putPngWord(&chunk,width);
+	putPngWord(&chunk,height);
+	b[0]=8; b[1]=2; b[2]=0; b[3]=0; b[4]=0;
+	putPngBytes(&chunk,b,5);
+	endPngChunk(&chunk);
+
+	/* Image data: each row starts with filter type 0. */
+	size=(width*3+1)*height;
+	beginPngChunk(&chunk,"IDAT",2+size+5*((size+PNG_STORED_MAX-1)/PNG_STORED_MAX)+4);
+	b[0]=0x78; b[1]=0x01;
+	putPngBytes(&chunk,b,2);
+	for (remaining=size,x=0,y=0;remaining;remaining-=block) {
+		/* Stored block header. */
+		block=(remaining > PNG_STORED_MAX)?PNG_STORED_MAX:remaining;
+		b[0]=(block == remaining);
+		b[1]=block; b[2]=block>>8; b[3]=~block; b[4]=(~block)>>8;
+		putPngBytes(&chunk,b,5);
+
+		/* Block data in spans within a row, x counts bytes of a row including the filter byte. */
+		for (i=0;i<block;i+=n) {
+			if (x) {
+				p=&rgb[y*width*3+x-1];
+				n=width*3+1-x;
+			} else {
+				p=&filter;
+				n=1;
+			}
+			if (n > block-i)
+				n=block-i;
+			putPngBytes(&chunk,p,n);
+			for (j=0;j<n;j++) {
+				adler_a=(adler_a+p[j]) % 65521;
+				adler_b=(adler_b+adler_a) % 65521;
+			}
+			if ((x+=n) > width*3) {
+				x=0;
+				y++;
+			}
+		}
+	}
+	b[0]=adler_b>>8; b[1]=adler_b; b[2]=adler_a>>8; b[3]=adler_a;
+	putPngBytes(&chunk,b,4);
+	endPngChunk(&chunk);
+
+	/* End. */
+	beginPngChunk(&chunk,"IEND",0);
+	endPngChunk(&chunk);
+
+	return fclose(chunk.f)?-1:0;
+}
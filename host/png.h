@@ -0,0 +1,25 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  png.h - minimal PNG writer for host tools.
+ */
+
+
+#ifndef PNG_H
+#define PNG_H
+
+
+#include <stdint.h>
+
+
+int writePng(const char *filename, const uint8_t *rgb, unsigned int width, unsigned int height);
+
+
+#endif /* PNG_H */
@@ -0,0 +1,101 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  randombench.c - time of the random generator against the former one,
+ *  on the host build.
+ *
+ *  Usage: randombench [-n calls]
+ *
+ *    -n calls  calls of each generator, default 100000000
+ *
+ *  Calls fastrandom() of the game and the former 31 bit generator, the one
+ *  tools/randomcheck.tcl compares against, copied here as it was. Both are
+ *  called out of line, from the default seed on. Prints the host CPU time
+ *  per call of each. Host times only compare the two against each other,
+ *  they say nothing about AVR cycles.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+
+
+/* Local includes. */
+#include "host.h"
+#include "../utils.h" /* for fastrandom() */
+
+
+/* Calls of each generator by default. */
+#define RANDOMBENCH_CALLS 100000000
+
+
+/* Former random generator. */
+#define FORMER_RANDOM_MODULO 0x7FFFFFFF
+
+uint32_t FormerRandomSeed=1234;
+
+__attribute__((noinline)) uint8_t formerFastrandom(void) {
+	FormerRandomSeed=
+		(FormerRandomSeed >> 16)
+		+ ((FormerRandomSeed << 15) & FORMER_RANDOM_MODULO)
+		- (FormerRandomSeed >> 21)
+		- ((FormerRandomSeed << 10) & FORMER_RANDOM_MODULO);
+	return (uint8_t) FormerRandomSeed;
+}
+
+
+/* Host CPU time in ns. */
+uint64_t getTime(void) {
+	struct timespec t;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID,&t);
+	return (uint64_t)t.tv_sec*1000000000+t.tv_nsec;
+}
+
+
+/* Time a generator, print ns per call. The results are summed so the calls can't be dropped. */
+void timeGenerator(const char *name, uint8_t (*generator)(void), uint32_t calls) {
+	uint64_t t;
+	uint32_t i, sum=0;
+
+	t=getTime();
+	for (i=0;i<calls;i++)
+		sum+=generator();
+	t=getTime()-t;
+	printf("%s %.2f ns per call, %u calls, sum %u\n",name,(double)t/calls,calls,sum);
+}
+
+
+int main(int argc, char *argv[]) {
+	uint32_t calls=RANDOMBENCH_CALLS;
+	int c;
+
+	/* Get options. */
+	while ((c=getopt(argc,argv,"n:")) != -1) {
+		switch (c) {
+			case 'n': calls=strtoul(optarg,NULL,0); break;
+			default:
+				fprintf(stderr,"Usage: %s [-n calls]\n",argv[0]);
+				return 1;
+		}
+	}
+	if (optind != argc || !calls) {
+		fprintf(stderr,"Usage: %s [-n calls]\n",argv[0]);
+		return 1;
+	}
+
+	/* Former first, then the game's. */
+	timeGenerator("former",formerFastrandom,calls);
+	timeGenerator("fastrandom()",fastrandom,calls);
+	return 0;
+}
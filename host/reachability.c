@@ -0,0 +1,516 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  reachability.c - check levels can be solved, on the host build.
+ *
+ *  Usage: reachability [-l first[-last]] [-s] [-v]
+ *
+ *    -l first-last levels to check, default all in data/levels.inc
+ *    -s            strict, warnings fail the check too
+ *    -v            also list levels without findings
+ *
+ *  Each level is drawn like on the level start screen, by prepareLevel()
+ *  and animateLevelStart(). Then every position of the cook is searched,
+ *  starting from the player start point, by calling selectPlayerDirection()
+ *  and movePlayer() of the game with any held direction buttons. So the
+ *  floor/ladder graph is exactly the one the game uses, with floor ends,
+ *  one-way ladders and wrapping floors.
+ *
+ *  Errors, the level can't be won:
+ *    - a tile of a burger component the cook can't stomp
+ *
+ *  Warnings:
+ *    - a trap, floors the cook can go to but never get back from
+ *    - a floor with a ladder the cook can't go to, floors without ladders
+ *      are decoration, e.g. the stand of the sign
+ *    - an opponent start point from which opponents never meet the cook,
+ *      searched by the same moves as the cook's
+ *
+ *  Burgers are searched where they are at the start of the level, none of
+ *  them has fallen yet. Exits 1 if any level fails, so it may gate level
+ *  submissions along with tools/levelcompiler.tcl.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <time.h>
+
+
+/* Local includes. */
+#include "host.h"
+#include "../tiles.h" /* for SetTileset() */
+#include "../draw.h" /* for clearScreen() */
+#include "../sprites.h" /* for placeSprite() */
+#include "../player.h" /* for movePlayer() */
+#include "../opponents.h" /* for OpponentStartPosition[] */
+#include "../screens.h" /* for prepareLevel() */
+#include "../levelpack.h" /* for readLevelByte() */
+
+
+/* Search state. Cook position and direction. */
+#define REACHABILITY_STATES ((1<<19))
+#define REACHABILITY_STATE(x,y,direction) ((((direction)<<16)|((y)<<8)|(x)))
+#define REACHABILITY_STATE_X(s) (((s) & 0xff))
+#define REACHABILITY_STATE_Y(s) ((((s)>>8) & 0xff))
+#define REACHABILITY_STATE_DIRECTION(s) (((s)>>16))
+
+/* Flags of a state. */
+#define REACHABILITY_REACHED  0x01
+#define REACHABILITY_RETURNS  0x02
+#define REACHABILITY_STOMPING 0x04
+#define REACHABILITY_OPPONENT 0x08
+
+/* Held direction buttons tried on each state. */
+#define REACHABILITY_BUTTONS 16
+
+/* Burger components, 4 burgers of 5 like in screens.c. */
+#define REACHABILITY_COMPONENTS_MAX 20
+
+/* Tile grid, wide enough for the wrapped floors. */
+#define REACHABILITY_COLUMNS 32
+
+
+/* Burger components of the level. */
+typedef struct {
+	uint8_t type, x, y;
+	uint8_t stomped, stomped_safe;
+} component_t;
+
+/* Floors and ladders of the level. */
+typedef struct {
+	uint8_t x, y, length;
+} floor_t;
+
+typedef struct {
+	uint8_t x, top, bottom;
+} ladder_exits_t;
+
+
+/* Options. */
+int Strict, Verbose;
+
+/* Search state. Positions of the cook are numbered in order of the search. */
+uint8_t States[REACHABILITY_STATES];
+uint32_t Index[REACHABILITY_STATES];
+uint32_t Cook[REACHABILITY_STATES];
+uint32_t Queue[REACHABILITY_STATES];
+size_t CookCount;
+uint32_t *EdgeFrom, *EdgeTo, *EdgeIndex, *EdgeSorted;
+size_t Edges, EdgesMax;
+
+/* Level items. */
+component_t Components[REACHABILITY_COMPONENTS_MAX];
+uint8_t ComponentsCount;
+floor_t Floors[256];
+uint8_t FloorsCount;
+ladder_exits_t Ladders[256];
+uint8_t LaddersCount;
+int PlayerStartPoint;
+
+/* Findings of the current level. */
+unsigned int Errors, Warnings;
+
+
+/* Report a finding. */
+void report(uint8_t level, const char *kind, const char *format, ...) {
+	va_list args;
+
+	printf("level %02u: %s: ",level,kind);
+	va_start(args,format);
+	vprintf(format,args);
+	va_end(args);
+	printf("\n");
+}
+
+
+/* Draw a level like the level start screen, without burgers. */
+void drawLevelForSearch(uint8_t level) {
+	const uint8_t *p;
+	const level_item_t *q;
+	uint8_t b, c;
+
+	/* Select and prepare the level. Burger components stay above the screen, so stomp() never hits them. */
+	SetTileset(TILESET0);
+	clearScreen();
+	selectLevel(level);
+	prepareLevel();
+
+	/* Animate the floors, ladders and sign in. */
+	for (GameScreenAnimationPhase=0;GameScreenAnimationPhase<=LEVEL_START_ANIMATION_SIGN_ENDED;GameScreenAnimationPhase++)
+		animateLevelStart();
+
+	/* Get burger components, floors and ladders. */
+	ComponentsCount=FloorsCount=LaddersCount=0;
+	PlayerStartPoint=0;
+	for (p=LevelDrawing;(b=readLevelByte(p));p++)
+		for (q=getLevelComponentBlock(b);(c=readLevelByte(&(q->component)));q++) {
+			if (c >= LEVEL_ITEM_BURGER_BUNTOP && c <= LEVEL_ITEM_BURGER_BUNBOTTOM
+					&& ComponentsCount < REACHABILITY_COMPONENTS_MAX)
+				Components[ComponentsCount++]=(component_t){
+					type: c,
+					x: readLevelByte(&(q->position.x)),
+					y: readLevelByte(&(q->position.y)) };
+			if (!(c & LEVEL_ITEM_BURGER_PLACEHOLDER) && FloorsCount < 255)
+				Floors[FloorsCount++]=(floor_t){
+					x: readLevelByte(&(q->position.x)),
+					y: readLevelByte(&(q->position.y)),
+					length: c & LEVEL_ITEM_FLOOR_LENGTH };
+			if (c == LEVEL_ITEM_PLAYERSTARTPOINT)
+				PlayerStartPoint=1;
+			if ((c & LEVEL_ITEM_LADDER) == LEVEL_ITEM_LADDER && LaddersCount < 255)
+				Ladders[LaddersCount++]=(ladder_exits_t){
+					x: readLevelByte(&(q->position.x)),
+					top: readLevelByte(&(q->position.y)),
+					bottom: readLevelByte(&(q->position.y))+(c & LEVEL_ITEM_LADDER_LENGTH) };
+		}
+}
+
+
+/* Put the cook into a search state. The sprite direction follows from the cook's. */
+void placeCook(uint32_t s) {
+	uint16_t flags;
+
+	switch (REACHABILITY_STATE_DIRECTION(s)) {
+		case PLAYER_FLAGS_DIRECTION_LEFT:  flags=SPRITE_FLAGS_DIRECTION_LEFT;  break;
+		case PLAYER_FLAGS_DIRECTION_RIGHT: flags=SPRITE_FLAGS_DIRECTION_RIGHT; break;
+		case PLAYER_FLAGS_DIRECTION_SLIDE: flags=SPRITE_FLAGS_DIRECTION_SLIDE; break;
+		default: flags=SPRITE_FLAGS_DIRECTION_LADDER;
+	}
+	Player.flags=PLAYER_FLAGS_SPEED_NORMAL|REACHABILITY_STATE_DIRECTION(s);
+	placeSprite(Player.sprite,REACHABILITY_STATE_X(s),REACHABILITY_STATE_Y(s),SPRITE_FLAGS_TYPE_COOK|flags);
+}
+
+/* Get the search state of the cook. */
+uint32_t getCookState(void) {
+	return REACHABILITY_STATE(getSpriteX(Player.sprite),getSpriteY(Player.sprite),Player.flags & PLAYER_FLAGS_DIRECTION_MASK);
+}
+
+/* Get the search state of a start point, facing like resetPlayer() does. */
+uint32_t getStartState(position_t position) {
+	position_t player=Player.start_position;
+
+	Player.start_position=position;
+	resetPlayer();
+	Player.start_position=player;
+	return getCookState();
+}
+
+
+/* Add an edge. */
+void addEdge(uint32_t from, uint32_t to) {
+	if (Edges == EdgesMax) {
+		EdgesMax=EdgesMax?EdgesMax*2:65536;
+		EdgeFrom=realloc(EdgeFrom,EdgesMax*sizeof(uint32_t));
+		EdgeTo=realloc(EdgeTo,EdgesMax*sizeof(uint32_t));
+		if (!EdgeFrom || !EdgeTo) {
+			perror("realloc");
+			exit(1);
+		}
+	}
+	EdgeFrom[Edges]=from;
+	EdgeTo[Edges]=to;
+	Edges++;
+}
+
+
+/* One frame of the game with these held buttons. Directions are bits 4 to 7. */
+uint32_t moveCook(uint32_t s, uint8_t buttons) {
+	placeCook(s);
+	selectPlayerDirection(buttons<<4);
+	movePlayer(buttons<<4);
+	return getCookState();
+}
+
+
+/* Search all positions of the cook from the start point, with the edges between them. */
+void searchCook(uint32_t start) {
+	size_t head=0;
+	uint32_t s, t;
+	uint8_t buttons;
+
+	CookCount=Edges=0;
+	States[start]|=REACHABILITY_REACHED;
+	Index[start]=CookCount;
+	Cook[CookCount++]=start;
+	while (head < CookCount) {
+		s=Cook[head++];
+		for (buttons=0;buttons<REACHABILITY_BUTTONS;buttons++) {
+			t=moveCook(s,buttons);
+			if (t == s) continue;
+
+			/* New position? */
+			if (!(States[t] & REACHABILITY_REACHED)) {
+				States[t]|=REACHABILITY_REACHED;
+				Index[t]=CookCount;
+				Cook[CookCount++]=t;
+			}
+
+			/* Remember edges for the way back, and where the cook stomps. */
+			addEdge(Index[s],Index[t]);
+			if (REACHABILITY_STATE_Y(t) == REACHABILITY_STATE_Y(s) && REACHABILITY_STATE_X(t) != REACHABILITY_STATE_X(s))
+				States[t]|=REACHABILITY_STOMPING;
+		}
+	}
+}
+
+
+/* Mark all positions the start point is reachable from, by the edges of the search. */
+void searchBack(uint32_t start) {
+	size_t head=0, tail=0, i;
+	uint32_t s, d;
+
+	/* Sort edges by target. */
+	EdgeIndex=realloc(EdgeIndex,(CookCount+1)*sizeof(uint32_t));
+	EdgeSorted=realloc(EdgeSorted,(Edges?Edges:1)*sizeof(uint32_t));
+	if (!EdgeIndex || !EdgeSorted) {
+		perror("realloc");
+		exit(1);
+	}
+	memset(EdgeIndex,0,(CookCount+1)*sizeof(uint32_t));
+	for (i=0;i<Edges;i++)
+		EdgeIndex[EdgeTo[i]+1]++;
+	for (i=0;i<CookCount;i++)
+		EdgeIndex[i+1]+=EdgeIndex[i];
+	for (i=0;i<Edges;i++)
+		EdgeSorted[EdgeIndex[EdgeTo[i]]++]=EdgeFrom[i];
+	memmove(EdgeIndex+1,EdgeIndex,CookCount*sizeof(uint32_t));
+	EdgeIndex[0]=0;
+
+	/* The start point counts in any direction. */
+	for (d=0;d<=PLAYER_FLAGS_DIRECTION_MASK;d++) {
+		s=REACHABILITY_STATE(REACHABILITY_STATE_X(start),REACHABILITY_STATE_Y(start),d);
+		if ((States[s] & REACHABILITY_REACHED) && !(States[s] & REACHABILITY_RETURNS)) {
+			States[s]|=REACHABILITY_RETURNS;
+			Queue[tail++]=Index[s];
+		}
+	}
+
+	/* Go back the edges. */
+	while (head < tail) {
+		s=Queue[head++];
+		for (i=EdgeIndex[s];i<EdgeIndex[s+1];i++)
+			if (!(States[Cook[EdgeSorted[i]]] & REACHABILITY_RETURNS)) {
+				States[Cook[EdgeSorted[i]]]|=REACHABILITY_RETURNS;
+				Queue[tail++]=EdgeSorted[i];
+			}
+	}
+}
+
+
+/* Search from an opponent start point with the moves of the cook. Returns 1 if it meets the cook. */
+int searchOpponent(uint32_t start) {
+	size_t head=0, tail=0, i;
+	uint32_t s, t;
+	uint8_t buttons;
+	int met=0;
+
+	States[start]|=REACHABILITY_OPPONENT;
+	Queue[tail++]=start;
+	while (head < tail && !met) {
+		s=Queue[head++];
+		met=States[s] & REACHABILITY_REACHED;
+		for (buttons=0;buttons<REACHABILITY_BUTTONS;buttons++) {
+			t=moveCook(s,buttons);
+			if (!(States[t] & REACHABILITY_OPPONENT)) {
+				States[t]|=REACHABILITY_OPPONENT;
+				Queue[tail++]=t;
+			}
+		}
+	}
+
+	/* Clean up for the next search. */
+	for (i=0;i<tail;i++)
+		States[Queue[i]]&=~REACHABILITY_OPPONENT;
+
+	return met;
+}
+
+
+/* Stomp like stomp() does, on the components of the level. Returns the number of stomped tiles. */
+uint8_t stompComponents(uint8_t x, uint8_t y, int safe) {
+	uint8_t i, stomped=0;
+
+	for (i=0;i<ComponentsCount;i++)
+		if (x >= Components[i].x && x < Components[i].x+5 && y == Components[i].y) {
+			Components[i].stomped|=1<<(x-Components[i].x);
+			if (safe)
+				Components[i].stomped_safe|=1<<(x-Components[i].x);
+			stomped++;
+		}
+	return stomped;
+}
+
+
+/* Check if a ladder ends on a floor. */
+int checkFloorWithLadder(floor_t *floor) {
+	uint8_t i;
+
+	for (i=0;i<LaddersCount;i++)
+		if ((Ladders[i].top == floor->y || Ladders[i].bottom == floor->y)
+				&& Ladders[i].x+1 >= floor->x && Ladders[i].x < floor->x+floor->length)
+			return 1;
+	return 0;
+}
+
+
+/* Check a level. Returns 1 if it fails. */
+int checkLevel(uint8_t level) {
+	static const char *names[]={ "bun top", "tomato", "patty", "cheese salad", "bun bottom" };
+	uint8_t trap[SCREEN_HEIGHT][REACHABILITY_COLUMNS];
+	uint8_t reached[SCREEN_HEIGHT][REACHABILITY_COLUMNS];
+	uint32_t start, s;
+	uint8_t n, x, y, safe;
+	char columns[3*REACHABILITY_COLUMNS+1];
+	size_t i;
+
+	Errors=Warnings=0;
+	drawLevelForSearch(level);
+	if (!PlayerStartPoint) {
+		report(level,"warning","no player start point, the game keeps the one of the level before");
+		Warnings++;
+	}
+
+	/* Search the cook's positions, and the way back to the start. */
+	start=getStartState(Player.start_position);
+	searchCook(start);
+	searchBack(start);
+
+	/* Go through all positions of the cook. */
+	memset(trap,0,sizeof(trap));
+	memset(reached,0,sizeof(reached));
+	for (i=0;i<CookCount;i++) {
+		s=Cook[i];
+
+		/* Place the cook for the tile coordinates of the game. */
+		placeCook(s);
+		x=getSpriteTileX(Player.sprite,0);
+		y=getSpriteTileY(Player.sprite,0);
+		safe=States[s] & REACHABILITY_RETURNS;
+
+		/* Remember floor tiles the cook walks on, and traps. */
+		if (x < REACHABILITY_COLUMNS && y < SCREEN_HEIGHT
+				&& (REACHABILITY_STATE_DIRECTION(s) == PLAYER_FLAGS_DIRECTION_LEFT || REACHABILITY_STATE_DIRECTION(s) == PLAYER_FLAGS_DIRECTION_RIGHT)) {
+			reached[y][x]=1;
+			if (!safe)
+				trap[y][x]=1;
+		}
+
+		/* Stomp like stompUnderSprite() does. */
+		if (States[s] & REACHABILITY_STOMPING)
+			if (!stompComponents(x,getSpriteTileY(Player.sprite,-8),safe))
+				stompComponents(x,y,safe);
+	}
+
+	/* Each component tile must be stomped. */
+	for (i=0;i<ComponentsCount;i++) {
+		if (Components[i].stomped != 0x1f) {
+			columns[0]=0;
+			for (n=0;n<5;n++)
+				if (!(Components[i].stomped & (1<<n)))
+					sprintf(columns+strlen(columns),"%s%u",columns[0]?",":"",Components[i].x+n);
+			report(level,"error","%s at %u,%u can't be stomped at column %s",
+				names[Components[i].type-LEVEL_ITEM_BURGER_BUNTOP],Components[i].x,Components[i].y,columns);
+			Errors++;
+		} else if (Components[i].stomped_safe != 0x1f) {
+			report(level,"warning","%s at %u,%u can only be stomped from a trap",
+				names[Components[i].type-LEVEL_ITEM_BURGER_BUNTOP],Components[i].x,Components[i].y);
+			Warnings++;
+		}
+	}
+
+	/* Report traps by rows. */
+	for (y=0;y<SCREEN_HEIGHT;y++)
+		for (x=0;x<REACHABILITY_COLUMNS;x++)
+			if (trap[y][x]) {
+				for (n=x;n+1<REACHABILITY_COLUMNS && trap[y][n+1];n++);
+				report(level,"warning","trap at row %u, columns %u-%u, no way back to the start point",y,x,n);
+				Warnings++;
+				x=n;
+			}
+
+	/* Report floors with ladders the cook never walks on. */
+	for (i=0;i<FloorsCount;i++) {
+		if (!checkFloorWithLadder(&Floors[i])) continue;
+		for (n=0;n<Floors[i].length;n++)
+			if (reached[Floors[i].y][(Floors[i].x+n) % SCREEN_WIDTH]) break;
+		if (n == Floors[i].length) {
+			report(level,"warning","floor at %u,%u can't be reached",Floors[i].x,Floors[i].y);
+			Warnings++;
+		}
+	}
+
+	/* Opponents must meet the cook somewhere. */
+	for (i=0;i<OPPONENT_START_POSITION_MAX;i++) {
+		if (OpponentStartPosition[i].x == OPPONENT_START_POSITION_INVALID) break;
+		if (!searchOpponent(getStartState(OpponentStartPosition[i]))) {
+			report(level,"warning","opponents from start point %u,%u never meet the cook",
+				OpponentStartPosition[i].x,OpponentStartPosition[i].y);
+			Warnings++;
+		}
+	}
+
+	if (Verbose && !Errors && !Warnings)
+		printf("level %02u: ok, %zu positions\n",level,CookCount);
+
+	/* Clean up for the next level. */
+	for (i=0;i<CookCount;i++)
+		States[Cook[i]]=0;
+
+	return Errors || (Strict && Warnings);
+}
+
+
+int main(int argc, char *argv[]) {
+	unsigned int first=1, last, level, failed=0;
+	struct timespec start, end;
+	char *end_of_number;
+	int c;
+
+	/* Get options. */
+	last=getHostLevelsCount();
+	while ((c=getopt(argc,argv,"l:sv")) != -1) {
+		switch (c) {
+			case 'l':
+				first=last=strtoul(optarg,&end_of_number,0);
+				if (*end_of_number == '-')
+					last=strtoul(end_of_number+1,NULL,0);
+				break;
+			case 's': Strict=1; break;
+			case 'v': Verbose=1; break;
+			default:
+				fprintf(stderr,"Usage: %s [-l first[-last]] [-s] [-v]\n",argv[0]);
+				return 1;
+		}
+	}
+	if (optind != argc || !first || first > last || last > 255) {
+		fprintf(stderr,"Usage: %s [-l first[-last]] [-s] [-v]\n",argv[0]);
+		return 1;
+	}
+
+	/* Check levels. The level before is prepared first, for the start point it leaves. */
+	clock_gettime(CLOCK_MONOTONIC,&start);
+	if (first > 1) {
+		selectLevel(first-1);
+		prepareLevel();
+	}
+	for (level=first;level<=last;level++)
+		failed+=checkLevel(level);
+	clock_gettime(CLOCK_MONOTONIC,&end);
+
+	/* Summary on stderr, stdout lists the findings. */
+	fprintf(stderr,"%u levels, %u failed, %.1f ms\n",last-first+1,failed,
+		(end.tv_sec-start.tv_sec)*1e3+(end.tv_nsec-start.tv_nsec)/1e6);
+	return !!failed;
+}
@@ -0,0 +1,180 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  ring.c - frames of a game published in a shared ring file.
+ *
+ *  Each slot is a sequence lock of its own. The writer fills the record
+ *  in place, so publishing a frame costs no more than writing it. Readers
+ *  copy the record out and check the sequence didn't move meanwhile.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+
+/* Local includes. */
+#include "ring.h"
+
+
+/* Header, padded to its own cache line. */
+#define RING_HEADER_SIZE 64
+
+typedef struct {
+	uint32_t magic, version, slots, size;
+	_Atomic uint64_t head;
+} ring_header_t;
+
+/* A slot, its size rounded up to cache lines. */
+typedef struct {
+	_Atomic uint64_t sequence;
+	ring_record_t record;
+} __attribute__((aligned(64))) ring_slot_t;
+
+struct ring {
+	size_t size;
+	ring_header_t *header;
+};
+
+
+_Static_assert(sizeof(ring_header_t) <= RING_HEADER_SIZE,"ring header must fit its cache line");
+
+
+/* Slot of a frame. */
+static inline ring_slot_t *getRingSlot(ring_t *ring, uint64_t frame) {
+	return (ring_slot_t *)((char *)ring->header+RING_HEADER_SIZE+(frame % ring->header->slots)*ring->header->size);
+}
+
+
+/* Map a ring file. */
+ring_t *mapRing(int fd, size_t size, int prot) {
+	ring_t *ring;
+
+	if (!(ring=calloc(1,sizeof(ring_t))))
+		return NULL;
+	ring->size=size;
+	ring->header=mmap(NULL,size,prot,MAP_SHARED,fd,0);
+	if (ring->header == MAP_FAILED) {
+		free(ring);
+		return NULL;
+	}
+	return ring;
+}
+
+
+/* Create a ring file with a number of slots, replacing any before. */
+ring_t *createRing(const char *path, uint32_t slots) {
+	size_t size=RING_HEADER_SIZE+(size_t)slots*sizeof(ring_slot_t);
+	ring_t *ring;
+	int fd;
+
+	if (!slots)
+		return NULL;
+	if ((fd=open(path,O_RDWR|O_CREAT|O_TRUNC,0644)) < 0)
+		return NULL;
+	if (ftruncate(fd,size) || !(ring=mapRing(fd,size,PROT_READ|PROT_WRITE))) {
+		close(fd);
+		return NULL;
+	}
+	close(fd);
+
+	/* The file is zeroed, so all slots read as not written yet. */
+	ring->header->slots=slots;
+	ring->header->size=sizeof(ring_slot_t);
+	ring->header->version=RING_VERSION;
+	atomic_store_explicit(&ring->header->head,0,memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	ring->header->magic=RING_MAGIC;
+	return ring;
+}
+
+
+/* Begin writing the next frame. Returns the record to fill in place. */
+ring_record_t *beginRing(ring_t *ring) {
+	uint64_t frame=atomic_load_explicit(&ring->header->head,memory_order_relaxed);
+	ring_slot_t *slot=getRingSlot(ring,frame);
+
+	/* Mark the slot as being written before touching the record. */
+	atomic_store_explicit(&slot->sequence,2*frame+1,memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	slot->record.frame=frame;
+	return &slot->record;
+}
+
+
+/* Commit the frame begun. */
+void commitRing(ring_t *ring) {
+	uint64_t frame=atomic_load_explicit(&ring->header->head,memory_order_relaxed);
+
+	atomic_store_explicit(&getRingSlot(ring,frame)->sequence,2*frame+2,memory_order_release);
+	atomic_store_explicit(&ring->header->head,frame+1,memory_order_release);
+}
+
+
+/* Attach to a ring file for reading. */
+ring_t *attachRing(const char *path) {
+	ring_header_t header;
+	ring_t *ring;
+	int fd;
+
+	/* Check the header first. */
+	if ((fd=open(path,O_RDONLY)) < 0)
+		return NULL;
+	if (pread(fd,&header,sizeof(header),0) != sizeof(header)
+		|| header.magic != RING_MAGIC
+		|| header.version != RING_VERSION
+		|| header.size != sizeof(ring_slot_t)
+		|| !(ring=mapRing(fd,RING_HEADER_SIZE+(size_t)header.slots*header.size,PROT_READ))) {
+		close(fd);
+		return NULL;
+	}
+	close(fd);
+	return ring;
+}
+
+
+/* Number of frames written so far. */
+uint64_t getRingHead(ring_t *ring) {
+	return atomic_load_explicit(&ring->header->head,memory_order_acquire);
+}
+
+
+/* Read a frame. */
+int readRing(ring_t *ring, uint64_t frame, ring_record_t *record) {
+	ring_slot_t *slot=getRingSlot(ring,frame);
+	uint64_t sequence;
+
+	/* Check the slot holds that frame, done. */
+	sequence=atomic_load_explicit(&slot->sequence,memory_order_acquire);
+	if (sequence < 2*frame+2)
+		return RING_READ_NOT_YET;
+	if (sequence > 2*frame+2)
+		return RING_READ_OVERWRITTEN;
+
+	/* Copy, then check nothing was written meanwhile. The writer only goes on to later frames. */
+	memcpy(record,&slot->record,sizeof(ring_record_t));
+	atomic_thread_fence(memory_order_acquire);
+	if (atomic_load_explicit(&slot->sequence,memory_order_relaxed) != sequence)
+		return RING_READ_OVERWRITTEN;
+	return RING_READ_OK;
+}
+
+
+/* Close a ring, the file stays. */
+void closeRing(ring_t *ring) {
+	munmap(ring->header,ring->size);
+	free(ring);
+}
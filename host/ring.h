@@ -0,0 +1,84 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  ring.h - frames of a game published in a shared ring file.
+ *
+ *  One game writes, any number of readers map the file and follow. The
+ *  file is a header of 64 bytes, then a number of slots of the size given
+ *  in the header, each starting on 64 bytes:
+ *
+ *    header  uint32 magic, version, slots, size; uint64 head
+ *    slot    uint64 sequence; ring_record_t record
+ *
+ *  Head is the number of frames written so far. Frame n goes to slot n
+ *  modulo slots. Its sequence is 2n+1 while it is written and 2n+2 once
+ *  done. A reader wanting frame n reads the sequence, reads the record,
+ *  then reads the sequence again. If both are 2n+2, the record is frame n.
+ *  Lower means not written yet, higher means it was overwritten already.
+ *  There are no locks, readers never hold up the writer.
+ *
+ *  Records are native byte order and alignment of the host build, x86-64
+ *  for everything else reading them.
+ */
+
+
+#ifndef RING_H
+#define RING_H
+
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+
+/* Local includes. */
+#include "rlenv.h" /* for rlenv_observation_t */
+
+
+/* File identification. */
+#define RING_MAGIC 0x57524e47
+#define RING_VERSION 1
+
+/* Events of a frame. */
+#define RING_EVENT_RESET  0x01 /* first frame of a level */
+#define RING_EVENT_WON    0x02 /* level won */
+#define RING_EVENT_LOST   0x04 /* cook lost a life */
+#define RING_EVENT_PEPPER 0x08 /* pepper thrown */
+
+/* Results of readRing(). */
+#define RING_READ_OK 0
+#define RING_READ_NOT_YET 1
+#define RING_READ_OVERWRITTEN 2
+
+
+/* A frame. */
+typedef struct {
+	uint64_t frame;
+	uint32_t events;
+	int32_t reward;
+	rlenv_observation_t observation;
+} ring_record_t;
+
+typedef struct ring ring_t;
+
+
+/* Writer. */
+ring_t *createRing(const char *path, uint32_t slots);
+ring_record_t *beginRing(ring_t *ring);
+void commitRing(ring_t *ring);
+
+/* Readers. */
+ring_t *attachRing(const char *path);
+uint64_t getRingHead(ring_t *ring);
+int readRing(ring_t *ring, uint64_t frame, ring_record_t *record);
+
+void closeRing(ring_t *ring);
+
+
+#endif /* RING_H */
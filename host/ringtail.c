@@ -0,0 +1,97 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  ringtail.c - follow the frames published to a ring file.
+ *
+ *  Usage: ringtail [-q] [-n frames] ring
+ *
+ *    -q         don't print frames, just count them
+ *    -n frames  stop after that many frames, default never
+ *
+ *  Starts with the latest frame written. Prints a line per frame: frame
+ *  number, events, reward, cook position, lives, peppers and bonus. Frames
+ *  overwritten before they could be read are counted as missed.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+
+/* Local includes. */
+#include "ring.h"
+
+
+/* Microseconds to wait for a frame not written yet. */
+#define RINGTAIL_WAIT 1000
+
+
+int main(int argc, char *argv[]) {
+	uint64_t frame, head, frames=0, read=0, missed=0;
+	ring_record_t record;
+	int quiet=0, c;
+	ring_t *ring;
+
+	/* Get options. */
+	while ((c=getopt(argc,argv,"qn:")) != -1) {
+		switch (c) {
+			case 'q': quiet=1; break;
+			case 'n': frames=strtoull(optarg,NULL,0); break;
+			default:
+				fprintf(stderr,"Usage: %s [-q] [-n frames] ring\n",argv[0]);
+				return 1;
+		}
+	}
+	if (optind != argc-1) {
+		fprintf(stderr,"Usage: %s [-q] [-n frames] ring\n",argv[0]);
+		return 1;
+	}
+	if (!(ring=attachRing(argv[optind]))) {
+		perror(argv[optind]);
+		return 1;
+	}
+
+	/* Follow. */
+	head=getRingHead(ring);
+	frame=head?head-1:0;
+	while (!frames || read+missed < frames) {
+		switch (readRing(ring,frame,&record)) {
+			case RING_READ_NOT_YET:
+				usleep(RINGTAIL_WAIT);
+				continue;
+			case RING_READ_OVERWRITTEN:
+				/* Fell behind. Go on with the frame written next. */
+				head=getRingHead(ring);
+				missed+=head-frame;
+				frame=head;
+				continue;
+		}
+		if (!quiet)
+			printf("%" PRIu64 " %02x %d %u,%u %u %u %u\n",
+				record.frame,
+				record.events,
+				record.reward,
+				record.observation.cook.x,
+				record.observation.cook.y,
+				record.observation.lives,
+				record.observation.peppers,
+				record.observation.bonus);
+		read++;
+		frame++;
+	}
+	closeRing(ring);
+
+	/* Summary. */
+	fprintf(stderr,"%" PRIu64 " frames read, %" PRIu64 " missed\n",read,missed);
+	return 0;
+}
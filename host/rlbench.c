@@ -0,0 +1,130 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  rlbench.c - throughput of the training environments in rlenv.c.
+ *
+ *  Usage: rlbench [-n environments] [-s steps] [-l level] [-p path]
+ *
+ *    -n environments  environments stepped together, default number of CPUs
+ *    -s steps         steps of all environments, default 100000
+ *    -l level         level to play, default 1
+ *    -p path          publish frames to ring files path.0, path.1 etc.
+ *
+ *  Random buttons are held, each for a few frames. Environments that are
+ *  done are reset to the level with a new seed. Prints steps per second,
+ *  along with episodes and score.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+
+
+/* Local includes. */
+#include "host.h"
+#include "rlenv.h"
+
+
+/* Frames a random action is held. */
+#define RLBENCH_HOLD 8
+
+/* Frames kept in a ring file. */
+#define RLBENCH_RING_SLOTS 1024
+
+
+/* Buttons to choose from. */
+const uint16_t Actions[]={ 0, BTN_LEFT, BTN_RIGHT, BTN_UP, BTN_DOWN, BTN_A };
+
+/* Environment state. */
+uint8_t Levels[RLENV_MAX];
+uint16_t Seeds[RLENV_MAX];
+uint16_t ActionsHeld[RLENV_MAX];
+int32_t Rewards[RLENV_MAX];
+uint8_t Dones[RLENV_MAX];
+rlenv_observation_t Observations[RLENV_MAX];
+
+
+int main(int argc, char *argv[]) {
+	unsigned int count, steps=100000, level=1, i, step, episodes=0, resets;
+	uint32_t random=1, score=0;
+	struct timespec start, end;
+	double seconds;
+	const char *path=NULL;
+	rlenv_t *env;
+	int c;
+
+	/* Get options. */
+	count=sysconf(_SC_NPROCESSORS_ONLN);
+	while ((c=getopt(argc,argv,"n:s:l:p:")) != -1) {
+		switch (c) {
+			case 'n': count=strtoul(optarg,NULL,0); break;
+			case 's': steps=strtoul(optarg,NULL,0); break;
+			case 'l': level=strtoul(optarg,NULL,0); break;
+			case 'p': path=optarg; break;
+			default:
+				fprintf(stderr,"Usage: %s [-n environments] [-s steps] [-l level] [-p path]\n",argv[0]);
+				return 1;
+		}
+	}
+	if (optind != argc || !count || count > RLENV_MAX || !level || level > 255) {
+		fprintf(stderr,"Usage: %s [-n environments] [-s steps] [-l level] [-p path]\n",argv[0]);
+		return 1;
+	}
+
+	/* Start all environments. */
+	if (!(env=openEnvironments(count))) {
+		perror("openEnvironments");
+		return 1;
+	}
+	if (path && publishEnvironments(env,path,RLBENCH_RING_SLOTS))
+		return 1;
+	for (i=0;i<count;i++) {
+		Levels[i]=level;
+		Seeds[i]=i+1;
+	}
+	if (resetEnvironments(env,Levels,Seeds,Observations))
+		return 1;
+
+	/* Step, reset done ones in between. Resets are timed, too. */
+	clock_gettime(CLOCK_MONOTONIC,&start);
+	for (step=0;step<steps;step++) {
+		for (i=0;i<count;i++) {
+			if (!(step % RLBENCH_HOLD)) {
+				random=random*1103515245+12345;
+				ActionsHeld[i]=Actions[(random>>16) % (sizeof(Actions)/sizeof(Actions[0]))];
+			}
+		}
+		stepEnvironments(env,ActionsHeld,Rewards,Dones,Observations);
+		for (resets=i=0;i<count;i++) {
+			score+=Rewards[i];
+			Levels[i]=0;
+			if (Dones[i]) {
+				Levels[i]=level;
+				Seeds[i]+=count;
+				resets++;
+			}
+		}
+		if (resets) {
+			episodes+=resets;
+			resetEnvironments(env,Levels,Seeds,Observations);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC,&end);
+	closeEnvironments(env);
+
+	/* Summary. */
+	seconds=(end.tv_sec-start.tv_sec)+(end.tv_nsec-start.tv_nsec)/1e9;
+	printf("%u environments, %u steps, %.0f steps/s, %u episodes, score %u\n",
+		count,steps,(double)count*steps/seconds,episodes,score);
+	return 0;
+}
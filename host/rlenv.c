@@ -0,0 +1,371 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  rlenv.c - environments for training agents on the host build.
+ *
+ *  The game has no way to restart, and it keeps its state in globals, so
+ *  each environment is a worker process running runGame(). Resetting kills
+ *  the worker and forks a new one, which presses start, goes to the level
+ *  and seeds the random generator once the level is played.
+ *
+ *  Workers talk to the caller through shared memory. A step writes the
+ *  actions, then counts up the step number. Each worker spins on that
+ *  number, plays one frame in the vsync hook and answers with its step
+ *  number, reward, done flag and observation. Workers idle for longer
+ *  sleep on a futex instead of spinning. Linux only.
+ *
+ *  When published, each worker also writes its frames to a ring file of
+ *  its environment. The ring is created by the caller and outlives resets,
+ *  so readers just follow it.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <signal.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+
+/* Local includes. */
+#include "host.h"
+#include "rlenv.h"
+#include "ring.h"
+#include "../utils.h" /* for seedRandom() */
+#include "../sprites.h" /* for getSpriteType() */
+#include "../player.h" /* for Player */
+#include "../pepper.h" /* for Pepper */
+#include "../opponents.h" /* for OpponentSprite[] */
+#include "../screens.h" /* for Score */
+
+
+/* Observations follow the game. */
+_Static_assert(RLENV_OPPONENTS == OPPONENT_MAX,"RLENV_OPPONENTS must be OPPONENT_MAX");
+
+
+/* Spins before a worker sleeps, or the caller yields. */
+#define RLENV_SPINS 4096
+
+/* Frames to wait for the level to be played. */
+#define RLENV_FRAMES_MAX 10000
+
+
+/* An environment in shared memory, a cache line of its own for the answer. */
+typedef struct {
+	_Atomic uint32_t step;
+	uint16_t action;
+	uint8_t done;
+	int32_t reward;
+	rlenv_observation_t observation;
+} __attribute__((aligned(64))) rlenv_slot_t;
+
+/* Shared memory. The step number is counted up by the caller. */
+typedef struct {
+	_Atomic uint32_t step;
+	_Atomic uint32_t sleepers;
+	rlenv_slot_t slots[] __attribute__((aligned(64)));
+} rlenv_shared_t;
+
+struct rlenv {
+	unsigned int count;
+	size_t size;
+	rlenv_shared_t *shared;
+	pid_t workers[RLENV_MAX];
+	ring_t *rings[RLENV_MAX];
+};
+
+
+/* Worker state. */
+rlenv_shared_t *WorkerShared;
+rlenv_slot_t *WorkerSlot;
+ring_t *WorkerRing;
+uint32_t WorkerStep;
+uint16_t WorkerSeed;
+uint32_t WorkerScore;
+uint8_t WorkerPeppers;
+uint32_t WorkerEvents;
+int WorkerPlaying;
+
+
+/* Write a sprite into an observation. */
+void writeObservationSprite(rlenv_sprite_t *sprite, uint8_t slot) {
+	sprite->x=getSpriteX(slot);
+	sprite->y=getSpriteY(slot);
+	sprite->type=getSpriteType(slot)>>SPRITE_FLAGS_TYPE_SHIFT;
+}
+
+/* Write an observation of the current frame. Planes are kept up to date by the encoder. */
+void writeObservation(rlenv_observation_t *o) {
+	uint8_t i;
+
+	memcpy(o->planes,EncoderPlanes,sizeof(encoder_planes_t));
+	writeObservationSprite(&o->cook,Player.sprite);
+	if (Pepper.flags)
+		writeObservationSprite(&o->pepper,Pepper.sprite);
+	else
+		o->pepper=(rlenv_sprite_t){ 0, 0, 0xff };
+	for (i=0;i<RLENV_OPPONENTS;i++)
+		if (OpponentFlags[i] == OPPONENT_FLAGS_INVALID)
+			o->opponents[i]=(rlenv_sprite_t){ 0, 0, 0xff };
+		else
+			writeObservationSprite(&o->opponents[i],OpponentSprite[i]);
+	o->lives=Lives;
+	o->peppers=Peppers;
+	o->bonus=Bonus;
+}
+
+
+/* Publish the frame answered. */
+void publishFrame(void) {
+	ring_record_t *record=beginRing(WorkerRing);
+
+	/* Events since the frame before. */
+	if (GameScreen == GAME_SCREEN_LEVEL_LOSE)
+		WorkerEvents|=RING_EVENT_LOST;
+	if (GameScreen == GAME_SCREEN_LEVEL_BONUS)
+		WorkerEvents|=RING_EVENT_WON;
+	if (Peppers < WorkerPeppers)
+		WorkerEvents|=RING_EVENT_PEPPER;
+	WorkerPeppers=Peppers;
+
+	record->events=WorkerEvents;
+	record->reward=WorkerSlot->reward;
+	memcpy(&record->observation,&WorkerSlot->observation,sizeof(rlenv_observation_t));
+	commitRing(WorkerRing);
+	WorkerEvents=0;
+}
+
+
+/* Wait for the next step. Spin first, then sleep. */
+void waitForStep(void) {
+	unsigned int spins=0;
+
+	while (atomic_load_explicit(&WorkerShared->step,memory_order_acquire) == WorkerStep) {
+		if (++spins < RLENV_SPINS) continue;
+		atomic_fetch_add(&WorkerShared->sleepers,1);
+		syscall(SYS_futex,(uint32_t *)&WorkerShared->step,FUTEX_WAIT,WorkerStep,NULL,NULL,0);
+		atomic_fetch_sub(&WorkerShared->sleepers,1);
+	}
+	WorkerStep=atomic_load_explicit(&WorkerShared->step,memory_order_acquire);
+}
+
+
+/* Called each frame in a worker. */
+void serveEnvironment(void) {
+	/* Press start once the start screen faded in, until the level is played. */
+	if (!WorkerPlaying) {
+		if (GameScreenPrevious != GAME_SCREEN_LEVEL_PLAY) {
+			if (HostFrame >= RLENV_FRAMES_MAX)
+				_exit(1);
+			HostJoypad[0]=(HostFrame >= HOST_FADER_STEPS*2 && HostFrame < HOST_FADER_STEPS*2+2)?BTN_START:0;
+			return;
+		}
+
+		/* Playing. Episodes only depend on the seed from here on. */
+		seedRandom(WorkerSeed);
+		WorkerScore=Score;
+		WorkerPeppers=Peppers;
+		WorkerEvents=RING_EVENT_RESET;
+		WorkerPlaying=1;
+	}
+
+	/* Outcome of the frame played. */
+	WorkerSlot->reward=Score-WorkerScore;
+	WorkerScore=Score;
+	if (GameScreen == GAME_SCREEN_LEVEL_LOSE || GameScreen == GAME_SCREEN_LEVEL_BONUS)
+		WorkerSlot->done=1;
+	writeObservation(&WorkerSlot->observation);
+	if (WorkerRing)
+		publishFrame();
+
+	/* Answer the step. A done environment answers without playing on. */
+	for (;;) {
+		atomic_store_explicit(&WorkerSlot->step,WorkerStep,memory_order_release);
+		waitForStep();
+		if (!WorkerSlot->done)
+			break;
+		WorkerSlot->reward=0;
+	}
+
+	/* Hold the buttons for the next frame. */
+	HostJoypad[0]=WorkerSlot->action;
+}
+
+
+/* Start a worker for an environment, killing the one before. */
+int startWorker(rlenv_t *env, unsigned int i, uint8_t level, uint16_t seed) {
+	rlenv_slot_t *slot=&env->shared->slots[i];
+	uint32_t step=atomic_load(&env->shared->step);
+	pid_t parent=getpid();
+
+	/* Kill the worker before. */
+	if (env->workers[i] > 0) {
+		kill(env->workers[i],SIGKILL);
+		waitpid(env->workers[i],NULL,0);
+	}
+
+	/* Not answered yet. */
+	atomic_store(&slot->step,step-1);
+	slot->done=0;
+
+	switch ((env->workers[i]=fork())) {
+		case -1:
+			perror("fork");
+			return -1;
+		case 0:
+			/* Go along with the caller. */
+			prctl(PR_SET_PDEATHSIG,SIGKILL);
+			if (getppid() != parent)
+				_exit(1);
+
+			/* Play. */
+			WorkerShared=env->shared;
+			WorkerSlot=slot;
+			WorkerRing=env->rings[i];
+			WorkerStep=step;
+			WorkerSeed=seed;
+			startEncoder();
+			runGame(level,&serveEnvironment);
+			_exit(0);
+	}
+
+	return 0;
+}
+
+
+/* Wait for an environment to answer a step. */
+int waitForWorker(rlenv_t *env, unsigned int i, uint32_t step) {
+	unsigned int spins=0;
+
+	while (atomic_load_explicit(&env->shared->slots[i].step,memory_order_acquire) != step) {
+		if (++spins < RLENV_SPINS) continue;
+		spins=0;
+		sched_yield();
+
+		/* Check if the worker died. */
+		if (waitpid(env->workers[i],NULL,WNOHANG) == env->workers[i]) {
+			fprintf(stderr,"environment %u: worker died\n",i);
+			env->workers[i]=0;
+			return -1;
+		}
+	}
+	return 0;
+}
+
+
+/* Open environments. Workers start on reset. */
+rlenv_t *openEnvironments(unsigned int count) {
+	rlenv_t *env;
+
+	if (!count || count > RLENV_MAX)
+		return NULL;
+	if (!(env=calloc(1,sizeof(rlenv_t))))
+		return NULL;
+	env->count=count;
+	env->size=sizeof(rlenv_shared_t)+count*sizeof(rlenv_slot_t);
+	env->shared=mmap(NULL,env->size,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_ANONYMOUS,-1,0);
+	if (env->shared == MAP_FAILED) {
+		free(env);
+		return NULL;
+	}
+	return env;
+}
+
+
+/* Publish the frames of all environments to ring files, path.0, path.1 etc. Call before the first reset. */
+int publishEnvironments(rlenv_t *env, const char *path, uint32_t slots) {
+	char name[PATH_MAX];
+	unsigned int i;
+
+	for (i=0;i<env->count;i++) {
+		snprintf(name,sizeof(name),"%s.%u",path,i);
+		if (!(env->rings[i]=createRing(name,slots))) {
+			perror(name);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+
+/* Close environments, killing the workers. */
+void closeEnvironments(rlenv_t *env) {
+	unsigned int i;
+
+	for (i=0;i<env->count;i++) {
+		if (env->workers[i] > 0) {
+			kill(env->workers[i],SIGKILL);
+			waitpid(env->workers[i],NULL,0);
+		}
+		if (env->rings[i])
+			closeRing(env->rings[i]);
+	}
+	munmap(env->shared,env->size);
+	free(env);
+}
+
+
+/* Reset environments to the start of a level, with a seed for the random generator. Level 0 leaves that one as it is. */
+int resetEnvironments(rlenv_t *env, const uint8_t levels[], const uint16_t seeds[], rlenv_observation_t observations[]) {
+	uint32_t step=atomic_load(&env->shared->step);
+	unsigned int i;
+	int result=0;
+
+	/* Start workers in parallel. */
+	for (i=0;i<env->count;i++)
+		if (levels[i] && startWorker(env,i,levels[i],seeds[i]))
+			return -1;
+
+	/* Wait for them to play. */
+	for (i=0;i<env->count;i++) {
+		if (levels[i] && waitForWorker(env,i,step))
+			result=-1;
+		memcpy(&observations[i],&env->shared->slots[i].observation,sizeof(rlenv_observation_t));
+	}
+
+	return result;
+}
+
+
+/* Play one frame in all environments. */
+void stepEnvironments(rlenv_t *env, const uint16_t actions[], int32_t rewards[], uint8_t dones[], rlenv_observation_t observations[]) {
+	rlenv_slot_t *slot;
+	uint32_t step;
+	unsigned int i;
+
+	/* Hand out actions, then count up the step. */
+	for (i=0;i<env->count;i++)
+		env->shared->slots[i].action=actions[i];
+	step=atomic_fetch_add(&env->shared->step,1)+1;
+	if (atomic_load(&env->shared->sleepers))
+		syscall(SYS_futex,(uint32_t *)&env->shared->step,FUTEX_WAKE,INT32_MAX,NULL,NULL,0);
+
+	/* Collect answers. An environment without a worker is done. */
+	for (i=0;i<env->count;i++) {
+		slot=&env->shared->slots[i];
+		if (!env->workers[i] || waitForWorker(env,i,step)) {
+			rewards[i]=0;
+			dones[i]=1;
+			continue;
+		}
+		rewards[i]=slot->reward;
+		dones[i]=slot->done;
+		memcpy(&observations[i],&slot->observation,sizeof(rlenv_observation_t));
+	}
+}
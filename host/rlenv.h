@@ -0,0 +1,78 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  rlenv.h - environments for training agents on the host build.
+ *
+ *  A number of independent games, each in a process of its own, stepped
+ *  one frame at a time together:
+ *
+ *    rlenv_t *env=openEnvironments(n);
+ *    resetEnvironments(env,levels,seeds,observations);
+ *    for (;;) {
+ *      ...choose actions[n] from observations...
+ *      stepEnvironments(env,actions,rewards,dones,observations);
+ *    }
+ *    closeEnvironments(env);
+ *
+ *  Actions are held buttons, BTN_LEFT|BTN_A etc. Rewards are the score
+ *  gained in that frame. An environment is done when the cook loses a
+ *  life or the level is won, it stays that way until it is reset again.
+ *  Observations go to a caller provided array of n rlenv_observation_t,
+ *  stepping doesn't allocate anything.
+ *
+ *  Other processes may follow the environments without the caller's
+ *  help: publishEnvironments(env,"/dev/shm/wuergertime",slots) has each
+ *  of them write its frames to a ring file, see ring.h.
+ */
+
+
+#ifndef RLENV_H
+#define RLENV_H
+
+
+#include <stdint.h>
+
+
+/* Local includes. */
+#include "encoder.h" /* for encoder_planes_t */
+
+
+/* Opponents in an observation, OPPONENT_MAX of the game. */
+#define RLENV_OPPONENTS 8
+
+/* Environments at most. */
+#define RLENV_MAX 1024
+
+
+/* A sprite in an observation. Type is the SPRITE_FLAGS_TYPE_... of the game shifted down, 0xff for none. */
+typedef struct {
+	uint8_t x, y, type;
+} rlenv_sprite_t;
+
+/* Observation after a frame. Planes tell what the tiles on screen mean, see encoder.h. */
+typedef struct {
+	encoder_planes_t planes;
+	rlenv_sprite_t cook, pepper;
+	rlenv_sprite_t opponents[RLENV_OPPONENTS];
+	uint8_t lives, peppers;
+	uint16_t bonus;
+} rlenv_observation_t;
+
+typedef struct rlenv rlenv_t;
+
+
+rlenv_t *openEnvironments(unsigned int count);
+void closeEnvironments(rlenv_t *env);
+int publishEnvironments(rlenv_t *env, const char *path, uint32_t slots);
+int resetEnvironments(rlenv_t *env, const uint8_t levels[], const uint16_t seeds[], rlenv_observation_t observations[]);
+void stepEnvironments(rlenv_t *env, const uint16_t actions[], int32_t rewards[], uint8_t dones[], rlenv_observation_t observations[]);
+
+
+#endif /* RLENV_H */
@@ -0,0 +1,478 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  spritebench.c - sprite load and game time per frame, on the host build.
+ *
+ *  Usage: spritebench [-l level] [-f frames] [-w opponent] [-h] [-u]
+ *
+ *    -l level     level to start at, default 1
+ *    -f frames    frames of level play to sample, default 20000
+ *    -w opponent  all attack waves bring that opponent, one of egghead,
+ *                 sausageman, mrmustard or anticook
+ *    -h           a horde of opponents, a new one each frame as long as
+ *                 there are kernel sprites for it
+ *    -u           time updateSprite() too, by rebuilding all occupied slots
+ *                 after each frame the multiplexer can't run in
+ *
+ *  Random buttons are held, each for a few frames, and the cook never runs
+ *  out of lives. For each number of opponents on screen it prints:
+ *    - frames sampled
+ *    - kernel sprites on screen, mean and max
+ *    - RAM tiles the sprites want, mean and max, and frames where they
+ *      wanted more than RAM_TILES_COUNT
+ *    - sprite blits into RAM tiles, mean and max
+ *    - frames where commitSprites() hid an opponent to stay within the
+ *      RAM tiles, so it flickers
+ *    - host CPU time of the game's frame, from one vsync to the next, mean
+ *      and max in ns
+ *    - host CPU time of commitSprites() within that frame, mean and max
+ *    - opponent moves within that frame, mean and max, each of them
+ *      selected a direction and moved an opponent on screen
+ *    - megasprite updates asked for by the game, mean and max, each of
+ *      them rebuilt the kernel sprites of its slot before they were
+ *      committed once per frame
+ *    - slots commitSprites() actually rebuilt, mean and max
+ *  The kernel's vsync sprite pass is one background copy per RAM tile and
+ *  one blit per sprite and RAM tile it covers, so the RAM tiles and blits
+ *  are what it takes on the real thing. Host times only compare builds and
+ *  settings against each other, they say nothing about AVR cycles.
+ *
+ *  Also prints the host CPU time of the level prepare screen, which draws
+ *  the level, and for each sprite slot the frames the multiplexer hid it.
+ *  Priority slots, the cook and the pepper, are marked by a *, they must
+ *  never be hidden. With -u the host CPU time of one updateSprite(). Last
+ *  the flash bytes read by drawShape() and drawShapeAnimated() for the run
+ *  length encoded shapes, against what the unencoded shapes took.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+
+/* Local includes. */
+#include "host.h"
+#include "../sprites.h" /* for commitSprites() */
+#include "../opponents.h" /* for OpponentFlags[] */
+#include "../screens.h" /* for GameScreen */
+#include "../draw.h" /* for drawShape() */
+
+
+/* Frames a random button is held. */
+#define SPRITEBENCH_HOLD 8
+
+/* Lives kept up. */
+#define SPRITEBENCH_LIVES 3
+
+/* Rebuilds of all occupied slots per frame with -u. */
+#define SPRITEBENCH_REBUILDS 64
+
+/* Sprites cover up to 2x2 background tiles. */
+#define SPRITEBENCH_CELLS_MAX 2
+
+
+/* Sum and maximum of a value per frame. */
+typedef struct {
+	uint64_t sum;
+	uint32_t max;
+} spritebench_value_t;
+
+/* Values by number of opponents on screen. */
+typedef struct {
+	uint32_t frames, overflows, hidden;
+	spritebench_value_t sprites, ramtiles, blits, frame, commit, moves, updates, rebuilds;
+} spritebench_row_t;
+
+/* Shapes drawn, flash bytes read and those unencoded shapes read. */
+typedef struct {
+	uint32_t count;
+	uint64_t encoded, unencoded;
+} spritebench_shapes_t;
+
+
+/* Buttons to choose from. */
+const uint16_t Buttons[]={ 0, BTN_LEFT, BTN_RIGHT, BTN_UP, BTN_DOWN, BTN_A };
+
+/* Opponent names by attack wave. */
+const char *Opponents[]={ "egghead", "sausageman", "mrmustard", "anticook" };
+
+/* Options. */
+uint32_t FramesMax=20000;
+int Wave=-1;
+int Horde;
+int Rebuild;
+
+/* Results. */
+spritebench_row_t Rows[OPPONENT_MAX+1];
+uint32_t Frames;
+uint64_t PrepareTime;
+uint32_t Prepares;
+spritebench_shapes_t Shapes, ShapesAnimated;
+uint64_t RebuildTime;
+uint32_t RebuildCount;
+
+/* Timing, whether the multiplexer hid a slot, and megasprite updates. */
+uint64_t FrameStart, CommitTime;
+uint8_t Hidden;
+uint32_t SlotHidden[SPRITE_SLOTS_MAX];
+uint32_t Moves, Updates, Rebuilds;
+uint32_t Random=1;
+
+
+/* Host CPU time in ns. */
+uint64_t getTime(void) {
+	struct timespec t;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID,&t);
+	return (uint64_t)t.tv_sec*1000000000+t.tv_nsec;
+}
+
+
+/* Add a value of a frame. */
+void addValue(spritebench_value_t *value, uint32_t v) {
+	value->sum+=v;
+	if (v > value->max)
+		value->max=v;
+}
+
+
+/* Count kernel sprites on screen, RAM tiles they want and blits into them, like the mode 3 kernel. */
+void countSprites(uint32_t *count, uint32_t *ramtiles, uint32_t *blits) {
+	uint8_t ramtile[SCREEN_TILES_V][SCREEN_TILES_H];
+	uint8_t i, j, k, cx, cy;
+
+	memset(ramtile,0,sizeof(ramtile));
+	*count=*ramtiles=*blits=0;
+	for (k=0;k<MAX_SPRITES;k++) {
+		if (sprites[k].x >= MODE3_WIDTH || sprites[k].y >= MODE3_HEIGHT)
+			continue;
+		(*count)++;
+
+		/* Each background tile covered needs a RAM tile, shared with other sprites. */
+		for (i=0;i<SPRITEBENCH_CELLS_MAX;i++) {
+			for (j=0;j<SPRITEBENCH_CELLS_MAX;j++) {
+				if ((i && !(sprites[k].y % TILE_HEIGHT)) || (j && !(sprites[k].x % TILE_WIDTH)))
+					continue;
+				cy=sprites[k].y/TILE_HEIGHT+i;
+				cx=sprites[k].x/TILE_WIDTH+j;
+				if (cy >= SCREEN_TILES_V || cx >= SCREEN_TILES_H)
+					continue;
+				if (!ramtile[cy][cx]) {
+					ramtile[cy][cx]=1;
+					(*ramtiles)++;
+				}
+
+				/* The kernel drops the blit if it ran out of RAM tiles. */
+				if (*ramtiles <= RAM_TILES_COUNT)
+					(*blits)++;
+			}
+		}
+	}
+}
+
+
+/*
+ *  Time rebuilding all occupied slots. Only when the multiplexer can't run,
+ *  so the commit does nothing but call updateSprite() for each of them.
+ */
+extern uint16_t GameSpriteSlotsDirty, GameSpriteSlotsPriority, GameSpriteSlotFlags[]; /* of sprites.c */
+extern uint8_t GameSpriteRamTilesWorst; /* of sprites.c */
+void __real_commitSprites(void);
+void timeRebuilds(void) {
+	uint64_t t;
+	uint16_t dirty;
+	uint8_t slot, n, i;
+
+	/* Occupied slots. */
+	if (GameSpriteRamTilesWorst > RAM_TILES_COUNT)
+		return;
+	for (dirty=0,n=0,slot=0;slot<SPRITE_SLOTS_MAX;slot++)
+		if (GameSpriteSlotFlags[slot] != SPRITE_FLAGS_FREE_SLOT) {
+			dirty|=(1<<slot);
+			n++;
+		}
+
+	/* Rebuild them. */
+	t=getTime();
+	for (i=0;i<SPRITEBENCH_REBUILDS;i++) {
+		GameSpriteSlotsDirty=dirty;
+		__real_commitSprites();
+	}
+	RebuildTime+=getTime()-t;
+	RebuildCount+=SPRITEBENCH_REBUILDS*n;
+}
+
+
+/* Called each frame. */
+void sampleFrame(void) {
+	static uint8_t previous;
+	spritebench_row_t *row;
+	uint32_t count, ramtiles, blits, frame;
+	uint8_t i, o;
+
+	/* Time of the frame just done. */
+	frame=getTime()-FrameStart;
+
+	/* Level prepare screen draws the level. */
+	if (GameScreen == GAME_SCREEN_LEVEL_PREPARE) {
+		PrepareTime+=frame;
+		if (previous != GAME_SCREEN_LEVEL_PREPARE)
+			Prepares++;
+	}
+	previous=GameScreen;
+
+	/* Sample level play only. */
+	if (GameScreen == GAME_SCREEN_LEVEL_PLAY) {
+		/* Count opponents on screen. */
+		for (o=0,i=0;i<OPPONENT_MAX;i++)
+			if (OpponentFlags[i] != OPPONENT_FLAGS_INVALID) o++;
+		row=&Rows[o];
+
+		/* Add frame. */
+		countSprites(&count,&ramtiles,&blits);
+		row->frames++;
+		if (ramtiles > RAM_TILES_COUNT)
+			row->overflows++;
+		row->hidden+=Hidden;
+		addValue(&row->sprites,count);
+		addValue(&row->ramtiles,ramtiles);
+		addValue(&row->blits,blits);
+		addValue(&row->frame,frame);
+		addValue(&row->commit,CommitTime);
+		addValue(&row->moves,Moves);
+		addValue(&row->updates,Updates);
+		addValue(&row->rebuilds,Rebuilds);
+		if (Rebuild)
+			timeRebuilds();
+		if (++Frames >= FramesMax)
+			stopGame();
+
+		/* Force the opponents asked for. The attack waves rotate, so all the same stay so. */
+		if (Wave >= 0)
+			OpponentAttackWaves=0x5555*Wave;
+		if (Horde) {
+			GameScreenOptions|=LEVEL_ITEM_OPTION_OPPONENT_QUAD|LEVEL_ITEM_OPTION_HORDE_EXTRA;
+			nextOpponent();
+		}
+	}
+
+	/* Keep the cook alive and moving. */
+	Lives=SPRITEBENCH_LIVES;
+	if (!(HostFrame % SPRITEBENCH_HOLD)) {
+		Random=Random*1103515245+12345;
+		HostJoypad[0]=Buttons[(Random>>16) % (sizeof(Buttons)/sizeof(Buttons[0]))];
+	}
+
+	/* Next frame starts now. */
+	CommitTime=0;
+	Hidden=0;
+	Moves=Updates=Rebuilds=0;
+	FrameStart=getTime();
+}
+
+
+/*
+ *  Time commitSprites() of the game, linked with --wrap. All slots it
+ *  updated are clean afterwards, but those it hid to stay within the RAM
+ *  tiles, they are drawn again on the next commit.
+ */
+void __wrap_commitSprites(void) {
+	uint64_t t;
+	uint8_t slot;
+
+	/* Each dirty slot is rebuilt once. */
+	for (slot=0;slot<SPRITE_SLOTS_MAX;slot++)
+		if (GameSpriteSlotsDirty & (1<<slot)) Rebuilds++;
+
+	t=getTime();
+	__real_commitSprites();
+	CommitTime+=getTime()-t;
+	if (GameSpriteSlotsDirty)
+		Hidden=1;
+	for (slot=0;slot<SPRITE_SLOTS_MAX;slot++)
+		if (GameSpriteSlotsDirty & (1<<slot)) SlotHidden[slot]++;
+}
+
+
+/* Count moves of opponents on screen, linked with --wrap. */
+void __real_moveOpponent(uint8_t index);
+void __wrap_moveOpponent(uint8_t index) {
+	if (OpponentFlags[index] != OPPONENT_FLAGS_INVALID)
+		Moves++;
+	__real_moveOpponent(index);
+}
+
+
+/*
+ *  Count megasprite updates of the game, linked with --wrap. Calls within
+ *  sprites.c aren't wrapped, moveSpriteIfNotBorder() counts for the
+ *  moveSprite() it does.
+ */
+void __real_placeSprite(uint8_t slot, uint8_t x, uint8_t y, uint16_t flags);
+void __wrap_placeSprite(uint8_t slot, uint8_t x, uint8_t y, uint16_t flags) {
+	Updates++;
+	__real_placeSprite(slot,x,y,flags);
+}
+
+uint8_t __real_moveSpriteIfNotBorder(uint8_t slot, int8_t x, int8_t y);
+uint8_t __wrap_moveSpriteIfNotBorder(uint8_t slot, int8_t x, int8_t y) {
+	if (!__real_moveSpriteIfNotBorder(slot,x,y))
+		return 0;
+	Updates++;
+	return 1;
+}
+
+void __real_moveSprite(uint8_t slot, int8_t x, int8_t y);
+void __wrap_moveSprite(uint8_t slot, int8_t x, int8_t y) {
+	Updates++;
+	__real_moveSprite(slot,x,y);
+}
+
+void __real_alignSpriteToPlatform(uint8_t slot);
+void __wrap_alignSpriteToPlatform(uint8_t slot) {
+	Updates++;
+	__real_alignSpriteToPlatform(slot);
+}
+
+void __real_changeSpriteDirection(uint8_t slot, uint8_t direction);
+void __wrap_changeSpriteDirection(uint8_t slot, uint8_t direction) {
+	Updates++;
+	__real_changeSpriteDirection(slot,direction);
+}
+
+void __real_setSpriteTransparency(uint8_t slot, uint16_t transparent);
+void __wrap_setSpriteTransparency(uint8_t slot, uint16_t transparent) {
+	Updates++;
+	__real_setSpriteTransparency(slot,transparent);
+}
+
+
+/* Flash bytes the decoder reads for the first tiles of a run length encoded shape, after width and height. */
+uint32_t getShapeBytes(const uint8_t *p, uint16_t tiles) {
+	const uint8_t *q=p;
+	uint8_t run=0;
+
+	while (tiles--) {
+		if (run) {
+			run--;
+			continue;
+		}
+		if (*q++ == SHAPE_RLE_RUN) {
+			run=*q-1;
+			q+=2;
+		}
+	}
+	return q-p;
+}
+
+
+/*
+ *  Count flash bytes read for shapes, linked with --wrap. Unencoded, a
+ *  shape was a byte per tile, and drawShapeAnimated() skipped the undrawn
+ *  lines without reading them.
+ */
+void __real_drawShape(uint8_t x, uint8_t y, const uint8_t *p, uint8_t options);
+void __wrap_drawShape(uint8_t x, uint8_t y, const uint8_t *p, uint8_t options) {
+	Shapes.count++;
+	Shapes.encoded+=2+getShapeBytes(p+2,p[0]*p[1]);
+	Shapes.unencoded+=2+p[0]*p[1];
+	__real_drawShape(x,y,p,options);
+}
+
+void __real_drawShapeAnimated(uint8_t x, uint8_t y, const uint8_t *p, uint8_t phase);
+void __wrap_drawShapeAnimated(uint8_t x, uint8_t y, const uint8_t *p, uint8_t phase) {
+	ShapesAnimated.count++;
+	ShapesAnimated.encoded+=2;
+	ShapesAnimated.unencoded+=2;
+	if (phase <= p[1]) {
+		ShapesAnimated.encoded+=getShapeBytes(p+2,p[0]*p[1]);
+		ShapesAnimated.unencoded+=p[0]*phase;
+	}
+	__real_drawShapeAnimated(x,y,p,phase);
+}
+
+
+/* Print shape counts. */
+void printShapes(const char *name, const spritebench_shapes_t *shapes) {
+	if (shapes->count)
+		printf("%s %u shapes, %llu flash bytes read, unencoded %llu\n",name,shapes->count,
+			(unsigned long long)shapes->encoded,(unsigned long long)shapes->unencoded);
+}
+
+
+/* Print a mean and a maximum. */
+void printValue(const spritebench_value_t *value, uint32_t frames) {
+	printf(" %8.1f %6u",(double)value->sum/frames,value->max);
+}
+
+
+int main(int argc, char *argv[]) {
+	unsigned int level=1, i;
+	int c;
+
+	/* Get options. */
+	while ((c=getopt(argc,argv,"l:f:w:hu")) != -1) {
+		switch (c) {
+			case 'l': level=strtoul(optarg,NULL,0); break;
+			case 'f': FramesMax=strtoul(optarg,NULL,0); break;
+			case 'w':
+				for (Wave=0;Wave<4;Wave++)
+					if (!strcmp(optarg,Opponents[Wave])) break;
+				break;
+			case 'h': Horde=1; break;
+			case 'u': Rebuild=1; break;
+			default:
+				fprintf(stderr,"Usage: %s [-l level] [-f frames] [-w opponent] [-h] [-u]\n",argv[0]);
+				return 1;
+		}
+	}
+	if (optind != argc || !level || level > getHostLevelsCount() || !FramesMax || Wave > 3) {
+		fprintf(stderr,"Usage: %s [-l level] [-f frames] [-w opponent] [-h] [-u]\n",argv[0]);
+		return 1;
+	}
+
+	/* Play. */
+	FrameStart=getTime();
+	runGame(level,sampleFrame);
+
+	/* Summary. */
+	printf("opponents   frames  sprites mean/max  ramtiles mean/max over  blits mean/max hidden   frame ns mean/max   commit ns mean/max  moves mean/max  updates mean/max rebuilds mean/max\n");
+	for (i=0;i<=OPPONENT_MAX;i++) {
+		if (!Rows[i].frames)
+			continue;
+		printf("%9u %8u",i,Rows[i].frames);
+		printValue(&Rows[i].sprites,Rows[i].frames);
+		printValue(&Rows[i].ramtiles,Rows[i].frames);
+		printf(" %4u",Rows[i].overflows);
+		printValue(&Rows[i].blits,Rows[i].frames);
+		printf(" %6u",Rows[i].hidden);
+		printValue(&Rows[i].frame,Rows[i].frames);
+		printValue(&Rows[i].commit,Rows[i].frames);
+		printValue(&Rows[i].moves,Rows[i].frames);
+		printValue(&Rows[i].updates,Rows[i].frames);
+		printValue(&Rows[i].rebuilds,Rows[i].frames);
+		printf("\n");
+	}
+	if (Prepares)
+		printf("level prepare %.0f ns each, %u times\n",(double)PrepareTime/Prepares,Prepares);
+	printf("hidden frames by slot:");
+	for (i=0;i<SPRITE_SLOTS_MAX;i++)
+		printf(" %u%s",SlotHidden[i],(GameSpriteSlotsPriority & (1<<i))?"*":"");
+	printf("\n");
+	if (RebuildCount)
+		printf("updateSprite() %.1f ns each, %u times\n",(double)RebuildTime/RebuildCount,RebuildCount);
+	printShapes("drawShape()",&Shapes);
+	printShapes("drawShapeAnimated()",&ShapesAnimated);
+	return 0;
+}
@@ -0,0 +1,187 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  thumbnails.c - render level previews on the host build.
+ *
+ *  Usage: thumbnails [-j jobs] [-l first[-last]] [-z zoom] [-t] [-o directory]
+ *
+ *    -j jobs       levels rendered in parallel, default number of CPUs
+ *    -l first-last levels to render, default all in data/levels.inc
+ *    -z zoom       scale up by that factor, e.g. for the level editor
+ *    -t            scale down to half size for thumbnails
+ *    -o directory  where to put levelNN.png, default current directory
+ *
+ *  Each level gets its own process. Start is pressed and the game runs
+ *  through the level description and prepareLevel()/animateLevelStart()
+ *  of the prepare screen. The first frame of the level start screen, the
+ *  level completely built with the cook in place, is written as PNG.
+ *  The level editor may shell out to this for a preview with e.g.
+ *
+ *    thumbnails -l 5 -z 3 -o /tmp
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/wait.h>
+
+
+/* Local includes. */
+#include "host.h"
+#include "mode3.h"
+#include "png.h"
+#include "../screens.h" /* for GameScreen */
+
+
+/* Frames to wait for the level start screen. */
+#define THUMBNAILS_FRAMES_MAX 10000
+
+/* Zoom limit. */
+#define THUMBNAILS_ZOOM_MAX 8
+
+
+/* Options. */
+unsigned int Zoom=1;
+int Half;
+const char *OutputDirectory=".";
+
+/* Level being rendered. */
+uint8_t RunLevel;
+
+
+/* Write current frame. */
+void writeThumbnail(void) {
+	static mode3_frame_t frame;
+	static uint8_t rgb[MODE3_WIDTH*MODE3_HEIGHT*3];
+	static uint8_t image[MODE3_WIDTH*THUMBNAILS_ZOOM_MAX*MODE3_HEIGHT*THUMBNAILS_ZOOM_MAX*3];
+	mode3_state_t state;
+	char filename[4096];
+	unsigned int width, height, x, y, c, i;
+
+	/* Render. */
+	getMode3State(&state);
+	renderMode3(&frame,&state);
+	convertMode3ToRgb(rgb,&frame);
+
+	/* Scale. Half size averages 2x2 pixels. */
+	if (Half) {
+		width=MODE3_WIDTH/2;
+		height=MODE3_HEIGHT/2;
+		for (y=0;y<height;y++)
+			for (x=0;x<width;x++)
+				for (c=0;c<3;c++) {
+					i=(y*2*MODE3_WIDTH+x*2)*3+c;
+					image[(y*width+x)*3+c]=(rgb[i]+rgb[i+3]+rgb[i+MODE3_WIDTH*3]+rgb[i+MODE3_WIDTH*3+3]+2)/4;
+				}
+	} else {
+		width=MODE3_WIDTH*Zoom;
+		height=MODE3_HEIGHT*Zoom;
+		for (y=0;y<height;y++)
+			for (x=0;x<width;x++)
+				for (c=0;c<3;c++)
+					image[(y*width+x)*3+c]=rgb[((y/Zoom)*MODE3_WIDTH+x/Zoom)*3+c];
+	}
+
+	/* Write. */
+	snprintf(filename,sizeof(filename),"%s/level%02u.png",OutputDirectory,RunLevel);
+	if (writePng(filename,image,width,height)) {
+		perror(filename);
+		exit(1);
+	}
+	printf("level %02u: %s\n",RunLevel,filename);
+}
+
+
+/* Called each frame. */
+void checkFrame(void) {
+	/* Level start screen reached? */
+	if (GameScreenPrevious == GAME_SCREEN_LEVEL_START) {
+		writeThumbnail();
+		stopGame();
+	}
+
+	/* Give up? */
+	if (HostFrame >= THUMBNAILS_FRAMES_MAX) {
+		fprintf(stderr,"level %02u: level start screen not reached.\n",RunLevel);
+		exit(1);
+	}
+
+	/* Press start once the start screen faded in. */
+	HostJoypad[0]=(HostFrame >= HOST_FADER_STEPS*2 && HostFrame < HOST_FADER_STEPS*2+2)?BTN_START:0;
+}
+
+
+int main(int argc, char *argv[]) {
+	unsigned int first=1, last, level, jobs, running=0, errors=0;
+	struct timespec start, end;
+	int c, status;
+	char *end_of_number;
+
+	/* Get options. */
+	last=getHostLevelsCount();
+	jobs=sysconf(_SC_NPROCESSORS_ONLN);
+	while ((c=getopt(argc,argv,"j:l:z:to:")) != -1) {
+		switch (c) {
+			case 'j': jobs=strtoul(optarg,NULL,0); break;
+			case 'l':
+				first=last=strtoul(optarg,&end_of_number,0);
+				if (*end_of_number == '-')
+					last=strtoul(end_of_number+1,NULL,0);
+				break;
+			case 'z': Zoom=strtoul(optarg,NULL,0); break;
+			case 't': Half=1; break;
+			case 'o': OutputDirectory=optarg; break;
+			default:
+				fprintf(stderr,"Usage: %s [-j jobs] [-l first[-last]] [-z zoom] [-t] [-o directory]\n",argv[0]);
+				return 1;
+		}
+	}
+	if (optind != argc || !first || first > last || last > 255 || !jobs || !Zoom || Zoom > THUMBNAILS_ZOOM_MAX) {
+		fprintf(stderr,"Usage: %s [-j jobs] [-l first[-last]] [-z zoom] [-t] [-o directory]\n",argv[0]);
+		return 1;
+	}
+
+	/* Render levels in parallel, a process each. */
+	clock_gettime(CLOCK_MONOTONIC,&start);
+	setvbuf(stdout,NULL,_IOLBF,0);
+	for (level=first;level<=last || running;) {
+		/* Start another one? */
+		if (level<=last && running<jobs) {
+			switch (fork()) {
+				case -1:
+					perror("fork");
+					return 1;
+				case 0:
+					RunLevel=level;
+					runGame(level,&checkFrame);
+					exit(0);
+			}
+			level++;
+			running++;
+			continue;
+		}
+
+		/* Wait for one to finish. */
+		if (wait(&status) < 0)
+			break;
+		running--;
+		if (!WIFEXITED(status) || WEXITSTATUS(status))
+			errors++;
+	}
+	clock_gettime(CLOCK_MONOTONIC,&end);
+
+	/* Summary on stderr, stdout lists the files. */
+	fprintf(stderr,"%u levels, %u errors, %.1f s\n",last-first+1,errors,
+		(end.tv_sec-start.tv_sec)+(end.tv_nsec-start.tv_nsec)/1e9);
+	return !!errors;
+}
@@ -0,0 +1,123 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  uzebox.h - host build replacement for the kernel API used by the game.
+ */
+
+
+#ifndef HOST_UZEBOX_H
+#define HOST_UZEBOX_H
+
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/* Screen and kernel configuration. */
+#include "mode3.h"
+#define TILE_WIDTH 8
+#define TILE_HEIGHT 8
+#define VRAM_TILES_V SCREEN_TILES_V
+#define OFF_SCREEN ((SCREEN_TILES_H*TILE_WIDTH))
+
+
+/* Kernel types. */
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+
+
+/* Video. */
+struct SpriteStruct {
+	uint8_t x;
+	uint8_t y;
+	uint8_t tileIndex;
+	uint8_t flags;
+};
+extern struct SpriteStruct sprites[MAX_SPRITES];
+extern uint8_t vram[];
+
+void SetTile(char x, char y, unsigned int tileId);
+void Fill(int x, int y, int width, int height, int tile);
+void Print(int x, int y, const char *string);
+void SetTileTable(const char *data);
+void SetFontTilesIndex(unsigned char index);
+void SetSpritesTileTable(const char *data);
+void FadeIn(unsigned char speed, bool blocking);
+void FadeOut(unsigned char speed, bool blocking);
+void WaitVsync(int count);
+
+
+/* Controllers. */
+#define BTN_B      ((1<<0))
+#define BTN_Y      ((1<<1))
+#define BTN_SELECT ((1<<2))
+#define BTN_START  ((1<<3))
+#define BTN_UP     ((1<<4))
+#define BTN_DOWN   ((1<<5))
+#define BTN_LEFT   ((1<<6))
+#define BTN_RIGHT  ((1<<7))
+#define BTN_A      ((1<<8))
+#define BTN_X      ((1<<9))
+#define BTN_SL     ((1<<10))
+#define BTN_SR     ((1<<11))
+
+unsigned int ReadJoypad(unsigned char joypadNo);
+
+
+/* EEPROM, same block format as the kernel. */
+#define EEPROM_BLOCK_SIZE 32
+#define EEPROM_SIZE 2048
+#define EEPROM_SIGNATURE 0x555a
+#define EEPROM_FREE_BLOCK 0xffff
+#define EEPROM_OK 0
+#define EEPROM_ERROR_INVALID_BLOCK 1
+#define EEPROM_ERROR_FULL 2
+#define EEPROM_ERROR_BLOCK_NOT_FOUND 3
+#define EEPROM_ERROR_NOT_FORMATTED 4
+
+struct EepromBlockStruct {
+	uint16_t id;
+	uint8_t data[EEPROM_BLOCK_SIZE-2];
+};
+
+char EepromWriteBlock(struct EepromBlockStruct *block);
+char EepromReadBlock(unsigned int blockId, struct EepromBlockStruct *block);
+char EepromBlockExists(unsigned int blockId, uint16_t *eepromAddr, uint8_t *nextFreeBlockId);
+void WriteEeprom(unsigned int addr, unsigned char value);
+unsigned char ReadEeprom(unsigned int addr);
+
+
+/* Sound, silent on the host. */
+enum {
+	PC_ENV_SPEED=0, PC_NOISE_PARAMS, PC_WAVE, PC_NOTE_UP, PC_NOTE_DOWN, PC_NOTE_CUT, PC_NOTE_HOLD,
+	PC_ENV_VOL, PC_PITCH, PC_TREMOLO_LEVEL, PC_TREMOLO_RATE, PC_SLIDE, PC_SLIDE_SPEED, PC_LOOP_START, PC_LOOP_END,
+	PATCH_END=0xff
+};
+struct PatchStruct {
+	unsigned char type;
+	const char *pcmData;
+	const char *cmdStream;
+	unsigned int loopStart;
+	unsigned int loopEnd;
+};
+
+void InitMusicPlayer(const struct PatchStruct *patchPointersParam);
+void TriggerFx(unsigned char patch, unsigned char volume, bool retrig);
+
+
+/* Start level, a compile time constant on the real thing. */
+extern uint8_t HostStartLevel;
+
+/* Demo input instead of the one built in, if not NULL. */
+extern const char *HostDemoInput;
+
+
+#endif /* HOST_UZEBOX_H */
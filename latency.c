@@ -0,0 +1,169 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  latency.c - input to display latency probe for the emulator.
+ *
+ *  Whenever the cook has been standing still for a while on an in-game
+ *  screen, a direction button is injected into controller 0 and held until
+ *  the cook's first kernel sprite in sprites[] changes, or a timeout. The
+ *  number of frames from sampling the button to the vsync showing the
+ *  change is written to the emulator's whisper port as a line
+ *
+ *    LATENCY <screen> <hurry> <phase parity> <button> <frames>
+ *
+ *  with frames 0 on timeout. Out of game, start is pressed now and then to
+ *  get into the game again. Run the emulator with its output piped into
+ *  tools/latency.tcl for a report.
+ */
+
+
+#include <avr/io.h> /* for uint8_t */
+#include <avr/pgmspace.h> /* for PSTR() */
+#include <uzebox.h> /* for sprites[] */
+
+
+/* Local includes. */
+#include "latency.h"
+#include "controllers.h"
+#include "screens.h"
+#include "sprites.h"
+#include "player.h"
+
+
+/* Emulator whisper port, writes are printed as characters. */
+#define LATENCY_WHISPER_CHAR _SFR_MEM8(0x3a)
+
+
+/* Buttons injected, in turn. */
+const uint16_t LatencyProbeButtons[] PROGMEM = { BTN_LEFT, BTN_RIGHT, BTN_UP, BTN_DOWN };
+#define LATENCY_PROBE_BUTTONS ((sizeof(LatencyProbeButtons)/sizeof(LatencyProbeButtons[0])))
+
+
+/* Probe state, number of probes and frame counter. */
+uint8_t LatencyProbeState;
+uint8_t LatencyProbeCount;
+uint8_t LatencyProbeFrames;
+uint8_t LatencyProbeFrame;
+
+/* Screen and state when the button was sampled. */
+uint8_t LatencyProbeScreen;
+uint8_t LatencyProbeHurry;
+uint8_t LatencyProbeParity;
+
+/* Cook's first kernel sprite when the button was injected. */
+struct SpriteStruct LatencyProbeSprite;
+
+
+/* Write string from program memory to whisper port. */
+void whisperString(const char *s) {
+	char c;
+
+	while ((c=pgm_read_byte(s++)))
+		LATENCY_WHISPER_CHAR=c;
+}
+
+
+/* Write decimal number to whisper port, with a leading space. */
+void whisperNumber(uint8_t n) {
+	LATENCY_WHISPER_CHAR=' ';
+	if (n >= 100) LATENCY_WHISPER_CHAR='0'+n/100;
+	if (n >= 10) LATENCY_WHISPER_CHAR='0'+(n/10)%10;
+	LATENCY_WHISPER_CHAR='0'+n%10;
+}
+
+
+/* Report a probe. */
+void reportLatencyProbe(uint8_t frames) {
+	whisperString(PSTR("LATENCY"));
+	whisperNumber(LatencyProbeScreen);
+	whisperNumber(LatencyProbeHurry);
+	whisperNumber(LatencyProbeParity);
+	whisperNumber(LatencyProbeCount % LATENCY_PROBE_BUTTONS);
+	whisperNumber(frames);
+	LATENCY_WHISPER_CHAR='\n';
+}
+
+
+/* Add injected buttons to sampled ones. Called by sampleControllers(). */
+uint16_t probeLatencyInput(uint8_t n, uint16_t buttons) {
+	/* Only controller 0 is used. */
+	if (n)
+		return buttons;
+
+	/* Out of game, press start now and then. */
+	if (GameScreen & GAME_SCREEN_OUTOFGAME)
+		return buttons|(((LatencyProbeFrame % LATENCY_PROBE_START_INTERVAL) < 2)?BTN_START:0);
+
+	switch (LatencyProbeState) {
+		case LATENCY_PROBE_STATE_INJECT:
+			/* Button is sampled now. Remember screen and state. */
+			LatencyProbeScreen=GameScreen;
+			LatencyProbeHurry=(Bonus < HURRY_BONUS);
+			LatencyProbeParity=(GameScreenAnimationPhase & 1);
+			LatencyProbeFrames=0;
+			LatencyProbeState=LATENCY_PROBE_STATE_WAIT;
+
+			/* Fallthrough. */
+		case LATENCY_PROBE_STATE_WAIT:
+			/* Hold button. */
+			return buttons|pgm_read_word(&LatencyProbeButtons[LatencyProbeCount % LATENCY_PROBE_BUTTONS]);
+	}
+
+	return buttons;
+}
+
+
+/* Check cook's sprite for a response. Called after sprites are committed. */
+void checkLatencyProbe(void) {
+	struct SpriteStruct *s=&sprites[getSpriteKernelIndex(Player.sprite)];
+	uint8_t changed;
+
+	/* Next frame. */
+	LatencyProbeFrame++;
+
+	/* Compare with remembered sprite. */
+	changed=(s->x != LatencyProbeSprite.x)
+		|| (s->y != LatencyProbeSprite.y)
+		|| (s->tileIndex != LatencyProbeSprite.tileIndex)
+		|| (s->flags != LatencyProbeSprite.flags);
+
+	switch (LatencyProbeState) {
+		case LATENCY_PROBE_STATE_SETTLE:
+			/* Count frames the cook stands still on an in-game screen. Vary count so both frame parities get probed. */
+			if (changed || (GameScreen & GAME_SCREEN_OUTOFGAME))
+				LatencyProbeFrames=0;
+			else if (++LatencyProbeFrames >= LATENCY_PROBE_SETTLE+(LatencyProbeCount & 7))
+				LatencyProbeState=LATENCY_PROBE_STATE_INJECT;
+			break;
+		case LATENCY_PROBE_STATE_WAIT:
+			/* Drop the probe if the screen changed meanwhile. */
+			LatencyProbeFrames++;
+			if (GameScreen != LatencyProbeScreen) {
+				LatencyProbeState=LATENCY_PROBE_STATE_SETTLE;
+				LatencyProbeCount++;
+				LatencyProbeFrames=0;
+				break;
+			}
+
+			/* Report response or timeout. */
+			if (changed || LatencyProbeFrames >= LATENCY_PROBE_TIMEOUT) {
+				reportLatencyProbe(changed?LatencyProbeFrames:0);
+				LatencyProbeState=LATENCY_PROBE_STATE_SETTLE;
+				LatencyProbeCount++;
+				LatencyProbeFrames=0;
+			}
+
+			/* Keep the sprite from injection time for comparison. */
+			return;
+	}
+
+	/* Remember sprite. */
+	LatencyProbeSprite=*s;
+}
@@ -0,0 +1,51 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  latency.h - input to display latency probe for the emulator.
+ */
+
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+
+#include <avr/io.h> /* for uint8_t */
+
+
+#ifdef LATENCY_PROBE
+
+/* Frames the cook has to stand still before a button is injected. */
+#define LATENCY_PROBE_SETTLE 8
+
+/* Frames to wait for a response. */
+#define LATENCY_PROBE_TIMEOUT 30
+
+/* Out of game, start is pressed every that many frames to get into the game. */
+#define LATENCY_PROBE_START_INTERVAL 64
+
+/* Probe states. */
+#define LATENCY_PROBE_STATE_SETTLE  0
+#define LATENCY_PROBE_STATE_INJECT  1
+#define LATENCY_PROBE_STATE_WAIT    2
+
+
+uint16_t probeLatencyInput(uint8_t n, uint16_t buttons);
+void checkLatencyProbe(void);
+
+#else
+
+/* No latency probe. */
+#define probeLatencyInput(n,buttons) (buttons)
+#define checkLatencyProbe()
+
+#endif /* LATENCY_PROBE */
+
+
+#endif /* LATENCY_H */
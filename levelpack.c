@@ -0,0 +1,166 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  levelpack.c - loading levels from a level pack on SD card.
+ *
+ *  The level pack is built by tools/levelpack.tcl and must be stored as
+ *  WUERGERT.PAK in the root directory of a FAT16 formatted SD card or SD
+ *  card image for the emulator. The file must not be fragmented, as only
+ *  its first sector is looked up.
+ *
+ *  The level record is loaded in small chunks, one per frame, while the
+ *  level description screen is shown.
+ */
+
+
+#include <avr/io.h> /* for uint8_t */
+#include <avr/pgmspace.h> /* for PROGMEM */
+#include <string.h> /* for memcmp_P(), memchr() */
+#include <uzebox.h>
+#include <sdBase.h> /* for sdCardDirectRead() and friends */
+
+
+/* Local includes. */
+#include "levelpack.h"
+#include "screens.h"
+
+
+/* Level pack file name and magic. */
+const char LevelPackFilename[] PROGMEM = LEVELPACK_FILENAME;
+const char LevelPackMagic[] PROGMEM = "WTLP";
+
+
+/* First sector of level pack file and number of levels in it. Zero if there is no level pack. */
+uint32_t LevelPackSector;
+uint8_t LevelPackLevels;
+
+/* Level record being loaded. */
+uint32_t LevelPackOffset;
+uint16_t LevelPackSize;
+uint16_t LevelPackLoaded;
+
+/* Level loading state. */
+uint8_t LevelLoading;
+uint8_t LevelPackInRam;
+
+/* Level record buffer. */
+uint8_t LevelPackBuffer[LEVELPACK_BUFFER_SIZE];
+
+
+/* Read from level pack file. Reads are split at sector boundaries. */
+void readLevelPack(void *dest, uint32_t offset, uint16_t count) {
+	uint16_t o, n;
+
+	while (count) {
+		/* Read up to end of sector. */
+		o=offset & 511;
+		n=512-o;
+		if (n > count) n=count;
+		sdCardDirectRead(dest,LevelPackSector+(offset>>9),o,n);
+
+		/* Advance. */
+		dest=(uint8_t *)dest+n;
+		offset+=n;
+		count-=n;
+	}
+}
+
+
+/* Look for a level pack on SD card. */
+void initLevelPack(void) {
+	uint8_t header[LEVELPACK_HEADER_SIZE];
+
+	/* No level pack yet. */
+	LevelPackLevels=0;
+	LevelLoading=0;
+	LevelPackInRam=0;
+
+	/* Initialize SD card. */
+	if (sdCardInitNoBuffer())
+		return;
+
+	/* Find level pack file. */
+	LevelPackSector=sdCardFindFileFirstSectorFlash(LevelPackFilename);
+	if (!LevelPackSector)
+		return;
+
+	/* Check header. */
+	readLevelPack(header,0,LEVELPACK_HEADER_SIZE);
+	if (memcmp_P(header,LevelPackMagic,LEVELPACK_MAGIC_SIZE) || header[LEVELPACK_MAGIC_SIZE] != LEVELPACK_VERSION)
+		return;
+
+	/* Remember number of levels. */
+	LevelPackLevels=header[LEVELPACK_MAGIC_SIZE+1];
+}
+
+
+/* Start loading a level from the level pack. Returns 0 if the level has to be taken from flash. */
+uint8_t selectLevelPackLevel(uint8_t level) {
+	uint32_t entry;
+
+	/* Level data is in flash until loaded. */
+	LevelPackInRam=0;
+	LevelLoading=0;
+
+	/* Use flash if there is no level pack. */
+	if (!LevelPackLevels)
+		return 0;
+
+	/* Get level record offset and size from index. Restart with first level if end of level pack reached. */
+	entry=LEVELPACK_HEADER_SIZE+((uint8_t)(level-1)%LevelPackLevels)*LEVELPACK_INDEX_ENTRY_SIZE;
+	readLevelPack(&LevelPackOffset,entry,sizeof(LevelPackOffset));
+	readLevelPack(&LevelPackSize,entry+sizeof(LevelPackOffset),sizeof(LevelPackSize));
+
+	/* Use flash if the record doesn't fit into the buffer. */
+	if (LevelPackSize > LEVELPACK_BUFFER_SIZE)
+		return 0;
+
+	/* Start loading. */
+	LevelPackLoaded=0;
+	LevelLoading=1;
+	return 1;
+}
+
+
+/* Load next chunk of selected level. Returns 1 when the level has just been loaded completely. */
+uint8_t loadLevelChunk(void) {
+	const uint8_t *p;
+	uint16_t n;
+
+	/* Nothing to do if no level is being loaded. */
+	if (!LevelLoading)
+		return 0;
+
+	/* Load next chunk. */
+	n=LevelPackSize-LevelPackLoaded;
+	if (n > LEVELPACK_CHUNK_SIZE) n=LEVELPACK_CHUNK_SIZE;
+	readLevelPack(LevelPackBuffer+LevelPackLoaded,LevelPackOffset+LevelPackLoaded,n);
+	LevelPackLoaded+=n;
+
+	/* Done if not complete yet. */
+	if (LevelPackLoaded < LevelPackSize)
+		return 0;
+
+	/* Level drawing is at start of record, the component blocks follow it. */
+	LevelLoading=0;
+	p=memchr(LevelPackBuffer,0,LevelPackSize);
+
+	/* Take the level from flash if the drawing isn't terminated within the record. */
+	if (!p) {
+		selectFlashLevel(Level);
+		return 1;
+	}
+
+	/* Level is in RAM now. */
+	LevelDrawing=LevelPackBuffer;
+	LevelComponentsBase=(const level_item_t *)(p+1);
+	LevelPackInRam=1;
+	return 1;
+}
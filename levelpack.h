@@ -0,0 +1,66 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  levelpack.h - loading levels from a level pack on SD card.
+ */
+
+
+#ifndef LEVELPACK_H
+#define LEVELPACK_H
+
+
+#include <avr/io.h> /* for uint8_t */
+#include <avr/pgmspace.h> /* for pgm_read_byte() */
+
+
+#ifdef LEVELPACK
+
+/* Level pack file name on SD card, 8.3 without the dot. */
+#define LEVELPACK_FILENAME "WUERGERTPAK"
+
+/* Level pack file format. */
+#define LEVELPACK_MAGIC_SIZE 4
+#define LEVELPACK_VERSION 1
+#define LEVELPACK_HEADER_SIZE 6
+#define LEVELPACK_INDEX_ENTRY_SIZE 6
+
+/* Maximum level record size. See tools/levelpack.tcl. */
+#define LEVELPACK_BUFFER_SIZE 320
+
+/* Bytes loaded per frame. */
+#define LEVELPACK_CHUNK_SIZE 64
+
+
+extern uint8_t LevelLoading;
+extern uint8_t LevelPackInRam;
+
+/* Level data is either in flash or in the level pack buffer in RAM. */
+#define readLevelByte(p) ((LevelPackInRam?(*(const uint8_t *)(p)):pgm_read_byte(p)))
+#define readLevelWord(p) ((LevelPackInRam?(*(const uint16_t *)(p)):pgm_read_word(p)))
+
+
+void initLevelPack(void);
+uint8_t selectLevelPackLevel(uint8_t level);
+uint8_t loadLevelChunk(void);
+
+#else
+
+/* No level pack support. Level data is always in flash. */
+#define LevelLoading 0
+#define readLevelByte(p) pgm_read_byte(p)
+#define readLevelWord(p) pgm_read_word(p)
+#define initLevelPack()
+#define selectLevelPackLevel(level) 0
+#define loadLevelChunk() 0
+
+#endif /* LEVELPACK */
+
+
+#endif /* LEVELPACK_H */
@@ -27,8 +27,12 @@
 #include "patches.h"
 
 
-/* Opponent data. */
-opponent_t Opponent[OPPONENT_MAX];
+/* Opponent data, one array per attribute. */
+uint8_t OpponentFlags[OPPONENT_MAX];
+uint8_t OpponentDirection[OPPONENT_MAX];
+uint8_t OpponentSpeed[OPPONENT_MAX];
+uint8_t OpponentSprite[OPPONENT_MAX];
+opponent_info_t OpponentInfo[OPPONENT_MAX];
 position_t OpponentStartPosition[OPPONENT_START_POSITION_MAX];
 uint8_t OpponentsInLevel;
 uint16_t OpponentAttackWaves;
@@ -47,10 +51,11 @@ const uint8_t OpponentRandomnessMasks[] PROGMEM = {
 void unmapOpponents(void) {
 	uint8_t i;
 
-	/* Clear opponent slots and unmap sprites. */
+	/* Clear opponent slots and free sprites. */
 	for (i=0;i<OPPONENT_MAX;i++) {
-		Opponent[i].flags=OPPONENT_FLAGS_INVALID;
-		unmapSprite(Opponent[i].sprite);
+		OpponentFlags[i]=OPPONENT_FLAGS_INVALID;
+		freeSpriteSlot(OpponentSprite[i]);
+		OpponentSprite[i]=SPRITE_SLOTS_FULL;
 	}
 }
 
@@ -71,25 +76,35 @@ void resetOpponents(void) {
 }
 
 
-/* Create new opponent, if there isn't the maximum active for this level. */
+/* Create new opponent, if there isn't the maximum active for this level and the sprite budget allows. */
 void nextOpponent(void) {
-	uint8_t i,o;
+	uint8_t i,o,n;
 	uint16_t s=0;
 
 	/* Count occupied opponent slots. */
 	o=0;
 	for (i=0;i<OPPONENT_MAX;i++)
-		if (Opponent[i].flags != OPPONENT_FLAGS_INVALID) o++;
+		if (OpponentFlags[i] != OPPONENT_FLAGS_INVALID) o++;
 
-	/* Skip if selected number of opponents is already active. */
-	if (o>((GameScreenOptions & LEVEL_ITEM_OPTION_OPPONENT_MASK)>>LEVEL_ITEM_OPTION_OPPONENT_SHIFT)) return;
+	/* Skip if selected number of opponents is already active. A horde brings some extra. */
+	if (o>(((GameScreenOptions & LEVEL_ITEM_OPTION_OPPONENT_MASK)>>LEVEL_ITEM_OPTION_OPPONENT_SHIFT)
+			+((GameScreenOptions & LEVEL_ITEM_OPTION_HORDE_MASK)?OPPONENT_HORDE_EXTRA:0))) return;
+
+	/* Count valid start positions. Skip if there is none. */
+	for (n=0;n<OPPONENT_START_POSITION_MAX;n++)
+		if (OpponentStartPosition[n].x == OPPONENT_START_POSITION_INVALID) break;
+	if (!n) return;
 
 	/* Get free opponent slot. */
 	for (i=0;i<OPPONENT_MAX;i++)
-		if (Opponent[i].flags == OPPONENT_FLAGS_INVALID) {
+		if (OpponentFlags[i] == OPPONENT_FLAGS_INVALID) {
 			/* Slot found. Get next opponent type. */
 			o=(OpponentAttackWaves & LEVEL_ITEM_ATTACK_WAVE_MASK);
 
+			/* Get a sprite slot. Mr. Mustard is narrow. Skip if over sprite budget, retry on next attack wave. */
+			OpponentSprite[i]=occupySpriteSlot((o == LEVEL_ITEM_ATTACK_WAVE_MRMUSTARD)?SPRITE_PIECES_TALLDUO:SPRITE_PIECES_BLOCK,SPRITE_SLOT_MULTIPLEXED);
+			if (OpponentSprite[i] == SPRITE_SLOTS_FULL) return;
+
 			/* Stuff it back into last position of the attack waves. */
 			OpponentAttackWaves>>=LEVEL_ITEM_ATTACK_WAVE_SHIFT;
 			OpponentAttackWaves|=(o<<(16-LEVEL_ITEM_ATTACK_WAVE_SHIFT));
@@ -98,30 +113,36 @@ void nextOpponent(void) {
 			switch (o) {
 				case LEVEL_ITEM_ATTACK_WAVE_EGGHEAD:
 					s=SPRITE_FLAGS_TYPE_EGGHEAD|SPRITE_FLAGS_DIRECTION_RIGHT;
-					Opponent[i].flags=OPPONENT_FLAGS_SPEED_SLOW|OPPONENT_FLAGS_DIRECTION_RIGHT|OPPONENT_FLAGS_ALGORITHM_BURGER_PATROLLER;
-					Opponent[i].info.target=getRandomBurgerComponentPosition();
+					OpponentFlags[i]=OPPONENT_FLAGS_ALGORITHM_BURGER_PATROLLER;
+					OpponentDirection[i]=OPPONENT_DIRECTION_RIGHT;
+					OpponentInfo[i].target=getRandomBurgerComponentPosition();
 					break;
 				case LEVEL_ITEM_ATTACK_WAVE_SAUSAGEMAN:
 					s=SPRITE_FLAGS_TYPE_SAUSAGEMAN|SPRITE_FLAGS_DIRECTION_LEFT;
-					Opponent[i].flags=OPPONENT_FLAGS_SPEED_SLOW|OPPONENT_FLAGS_DIRECTION_LEFT|OPPONENT_FLAGS_ALGORITHM_FOLLOW_PLAYER;
+					OpponentFlags[i]=OPPONENT_FLAGS_ALGORITHM_FOLLOW_PLAYER;
+					OpponentDirection[i]=OPPONENT_DIRECTION_LEFT;
 					break;
 				case LEVEL_ITEM_ATTACK_WAVE_MRMUSTARD:
 					s=SPRITE_FLAGS_TYPE_MRMUSTARD|SPRITE_FLAGS_DIRECTION_RIGHT;
-					Opponent[i].flags=OPPONENT_FLAGS_SPEED_SLOW|OPPONENT_FLAGS_DIRECTION_RIGHT|OPPONENT_FLAGS_ALGORITHM_MESS_UP_LADDERS;
+					OpponentFlags[i]=OPPONENT_FLAGS_ALGORITHM_MESS_UP_LADDERS;
+					OpponentDirection[i]=OPPONENT_DIRECTION_RIGHT;
 					break;
 				case LEVEL_ITEM_ATTACK_WAVE_ANTICOOK:
 					s=SPRITE_FLAGS_TYPE_ANTICOOK|SPRITE_FLAGS_DIRECTION_LEFT;
-					Opponent[i].flags=OPPONENT_FLAGS_SPEED_SLOW|OPPONENT_FLAGS_DIRECTION_LEFT|OPPONENT_FLAGS_ALGORITHM_STOMPER;
-					Opponent[i].info.target=getRandomBurgerComponentPosition();
+					OpponentFlags[i]=OPPONENT_FLAGS_ALGORITHM_STOMPER;
+					OpponentDirection[i]=OPPONENT_DIRECTION_LEFT;
+					OpponentInfo[i].target=getRandomBurgerComponentPosition();
 					break;
 			}
 
-			/* Setup flags. */
+			/* All opponents start slow. */
+			OpponentSpeed[i]=OPPONENT_SPEED_SLOW;
 
-			/* Setup opponent sprite. */
-			placeSprite(Opponent[i].sprite,
-				OpponentStartPosition[i].x*8+SPRITE_BORDER_WIDTH,
-				OpponentStartPosition[i].y*8,
+			/* Setup opponent sprite. Opponents share start positions if there are more of them. */
+			n=i%n;
+			placeSprite(OpponentSprite[i],
+				OpponentStartPosition[n].x*8+SPRITE_BORDER_WIDTH,
+				OpponentStartPosition[n].y*8,
 				s);
 
 			/* Trigger opponent sound. */
@@ -142,29 +163,29 @@ void nextAttackWave(void) {
 
 /* Change moving/facing direction of opponent. */
 void changeOpponentDirectionWithoutAnimationReset(uint8_t index, uint8_t direction) {
-	Opponent[index].flags=(Opponent[index].flags & ~OPPONENT_FLAGS_DIRECTION_MASK)|direction;
+	OpponentDirection[index]=direction;
 }
 
 void changeOpponentDirection(uint8_t index, uint8_t direction) {
 	/* Skip if direction is same as before. */
-	if ((Opponent[index].flags & OPPONENT_FLAGS_DIRECTION_MASK) == direction) return;
+	if (OpponentDirection[index] == direction) return;
 
 	/* Remember new direction. */
 	changeOpponentDirectionWithoutAnimationReset(index,direction);
 
 	/* Change sprite direction. */
 	switch (direction) {
-		case OPPONENT_FLAGS_DIRECTION_LEFT:
-			changeSpriteDirection(Opponent[index].sprite,SPRITE_FLAGS_DIRECTION_LEFT);
+		case OPPONENT_DIRECTION_LEFT:
+			changeSpriteDirection(OpponentSprite[index],SPRITE_FLAGS_DIRECTION_LEFT);
 			break;
-		case OPPONENT_FLAGS_DIRECTION_RIGHT:
-			changeSpriteDirection(Opponent[index].sprite,SPRITE_FLAGS_DIRECTION_RIGHT);
+		case OPPONENT_DIRECTION_RIGHT:
+			changeSpriteDirection(OpponentSprite[index],SPRITE_FLAGS_DIRECTION_RIGHT);
 			break;
-		case OPPONENT_FLAGS_DIRECTION_SQUIRT:
-			changeSpriteDirection(Opponent[index].sprite,SPRITE_FLAGS_DIRECTION_SQUIRT);
+		case OPPONENT_DIRECTION_SQUIRT:
+			changeSpriteDirection(OpponentSprite[index],SPRITE_FLAGS_DIRECTION_SQUIRT);
 			break;
 		default:
-			changeSpriteDirection(Opponent[index].sprite,SPRITE_FLAGS_DIRECTION_LADDER);
+			changeSpriteDirection(OpponentSprite[index],SPRITE_FLAGS_DIRECTION_LADDER);
 	}
 }
 
@@ -174,7 +195,7 @@ uint8_t selectPossibleOpponentDirectionRandomly(uint8_t index, uint8_t direction
 	uint8_t d, e, s;
 
 	/* Set mad flag for this opponent. This avoids opponents stick in a dead end. */
-	Opponent[index].flags|=OPPONENT_FLAGS_MAD;
+	OpponentFlags[index]|=OPPONENT_FLAGS_MAD;
 
 	/* Get number of other possible directions. */
 	s=0;
@@ -194,7 +215,7 @@ uint8_t selectPossibleOpponentDirectionRandomly(uint8_t index, uint8_t direction
 		/* Check if possible direction found. */
 		if (directions & 0x01) {
 			/* Yes. Return if enough skipped. */
-			if (s==0) return (e<<OPPONENT_FLAGS_DIRECTION_SHIFT);
+			if (s==0) return e;
 
 			/* Skip one less. */
 			s--;
@@ -212,7 +233,7 @@ uint8_t selectPossibleOpponentDirectionRandomly(uint8_t index, uint8_t direction
 /* Select a possible opponent direction randomly, prefer current direction. */
 uint8_t selectPossibleOpponentDirection(uint8_t index, uint8_t directions) {
 	/* Stay in current direction if possible. */
-	if ((1<<((Opponent[index].flags & OPPONENT_FLAGS_DIRECTION_MASK)>>OPPONENT_FLAGS_DIRECTION_SHIFT)) & directions) return (Opponent[index].flags & OPPONENT_FLAGS_DIRECTION_MASK);
+	if ((1<<OpponentDirection[index]) & directions) return OpponentDirection[index];
 
 	/* Select a possible opponent direction randomly. */
 	return selectPossibleOpponentDirectionRandomly(index,directions);
@@ -227,7 +248,7 @@ void selectOpponentDirectionNearerToTarget(uint8_t index, uint8_t directions, ui
 	r=fastrandom() & OpponentRandomness;
 
 	/* Make opponent movement more random if mad flag was set. */
-	if (Opponent[index].flags & OPPONENT_FLAGS_MAD) r&=OPPONENT_MAD_RANDOMNESS;
+	if (OpponentFlags[index] & OPPONENT_FLAGS_MAD) r&=OPPONENT_MAD_RANDOMNESS;
 
 	/* Choose direction randomly? */
 	if (!r) {
@@ -237,51 +258,51 @@ void selectOpponentDirectionNearerToTarget(uint8_t index, uint8_t directions, ui
 	}
 
 	/* Not randomly. On same floor as target? */
-	if (y == getSpriteY(Opponent[index].sprite)) {
+	if (y == getSpriteY(OpponentSprite[index])) {
 		/* Yes. Try to catch the target on this floor. */
-		if ((x < getSpriteX(Opponent[index].sprite)) && (directions & (1<<OPPONENT_DIRECTION_LEFT)))
-			changeOpponentDirection(index,OPPONENT_FLAGS_DIRECTION_LEFT);
-		else if ((x > getSpriteX(Opponent[index].sprite)) && (directions & (1<<OPPONENT_DIRECTION_RIGHT)))
-			changeOpponentDirection(index,OPPONENT_FLAGS_DIRECTION_RIGHT);
+		if ((x < getSpriteX(OpponentSprite[index])) && (directions & (1<<OPPONENT_DIRECTION_LEFT)))
+			changeOpponentDirection(index,OPPONENT_DIRECTION_LEFT);
+		else if ((x > getSpriteX(OpponentSprite[index])) && (directions & (1<<OPPONENT_DIRECTION_RIGHT)))
+			changeOpponentDirection(index,OPPONENT_DIRECTION_RIGHT);
 		else
 			/* Not possible to catch the target on this floor. Choose a possible direction randomly, prefer current direction. */
 			changeOpponentDirection(index,selectPossibleOpponentDirection(index,directions));
 	} else {
 		/* On same ladder? */
-		if (x == getSpriteX(Opponent[index].sprite)) {
+		if (x == getSpriteX(OpponentSprite[index])) {
 			/* Yes. Try to catch the target on this ladder. */
-			if ((y < getSpriteY(Opponent[index].sprite)) && (directions & (1<<OPPONENT_DIRECTION_UP)))
-				changeOpponentDirection(index,OPPONENT_FLAGS_DIRECTION_UP);
-			else if ((x > getSpriteX(Opponent[index].sprite)) && (directions & (1<<OPPONENT_DIRECTION_DOWN)))
-				changeOpponentDirection(index,OPPONENT_FLAGS_DIRECTION_DOWN);
+			if ((y < getSpriteY(OpponentSprite[index])) && (directions & (1<<OPPONENT_DIRECTION_UP)))
+				changeOpponentDirection(index,OPPONENT_DIRECTION_UP);
+			else if ((x > getSpriteX(OpponentSprite[index])) && (directions & (1<<OPPONENT_DIRECTION_DOWN)))
+				changeOpponentDirection(index,OPPONENT_DIRECTION_DOWN);
 			else
 				/* Not possible to catch the target on this ladder. Choose a possible direction randomly, prefer current direction. */
 				changeOpponentDirection(index,selectPossibleOpponentDirection(index,directions));
 		} else {
 			/* Neither on same floor nor ladder. Check if we are on floor or ladder. */
-			switch (Opponent[index].flags & OPPONENT_FLAGS_DIRECTION_MASK) {
-				case OPPONENT_FLAGS_DIRECTION_LEFT:
-				case OPPONENT_FLAGS_DIRECTION_RIGHT:
+			switch (OpponentDirection[index]) {
+				case OPPONENT_DIRECTION_LEFT:
+				case OPPONENT_DIRECTION_RIGHT:
 					/* Currently on a floor. Take the next ladder leading in the right direction. */
-					if ((y < getSpriteY(Opponent[index].sprite))
+					if ((y < getSpriteY(OpponentSprite[index]))
 							&& (directions & (1<<OPPONENT_DIRECTION_UP)))
-						changeOpponentDirection(index,OPPONENT_FLAGS_DIRECTION_UP);
-					else if ((y > getSpriteY(Opponent[index].sprite))
+						changeOpponentDirection(index,OPPONENT_DIRECTION_UP);
+					else if ((y > getSpriteY(OpponentSprite[index]))
 							&& (directions & (1<<OPPONENT_DIRECTION_DOWN)))
-						changeOpponentDirection(index,OPPONENT_FLAGS_DIRECTION_DOWN);
+						changeOpponentDirection(index,OPPONENT_DIRECTION_DOWN);
 					else
 						/* Not possible to change direction on ladder. Choose a possible direction randomly, prefer current direction. */
 						changeOpponentDirection(index,selectPossibleOpponentDirection(index,directions));
 					break;
-				case OPPONENT_FLAGS_DIRECTION_UP:
-				case OPPONENT_FLAGS_DIRECTION_DOWN:
+				case OPPONENT_DIRECTION_UP:
+				case OPPONENT_DIRECTION_DOWN:
 					/* Currently on a ladder. Take the next floor leading in the right direction. */
-					if ((x < getSpriteX(Opponent[index].sprite))
+					if ((x < getSpriteX(OpponentSprite[index]))
 							&& (directions & (1<<OPPONENT_DIRECTION_LEFT)))
-						changeOpponentDirection(index,OPPONENT_FLAGS_DIRECTION_LEFT);
-					else if ((x > getSpriteX(Opponent[index].sprite))
+						changeOpponentDirection(index,OPPONENT_DIRECTION_LEFT);
+					else if ((x > getSpriteX(OpponentSprite[index]))
 							&& (directions & (1<<OPPONENT_DIRECTION_LEFT)))
-						changeOpponentDirection(index,OPPONENT_FLAGS_DIRECTION_RIGHT);
+						changeOpponentDirection(index,OPPONENT_DIRECTION_RIGHT);
 					else
 						/* Not possible to change direction on floor. Choose a possible direction randomly, prefer current direction. */
 						changeOpponentDirection(index,selectPossibleOpponentDirection(index,directions));
@@ -292,200 +313,279 @@ void selectOpponentDirectionNearerToTarget(uint8_t index, uint8_t directions, ui
 }
 
 
-/* Select a new opponent direction. */
-void selectOpponentDirection(uint8_t index) {
-	uint8_t i, directions=0;
-
-	/* Skip invalid opponent. */
-	if (Opponent[index].flags == OPPONENT_FLAGS_INVALID) return;
+/* Get possible directions depending on current position. */
+uint8_t getPossibleOpponentDirections(uint8_t index) {
+	uint8_t directions=0;
 
-	/* Check possible directions depending on current position. */
-	switch (Opponent[index].flags & OPPONENT_FLAGS_DIRECTION_MASK) {
-		case OPPONENT_FLAGS_DIRECTION_LEFT:
-		case OPPONENT_FLAGS_DIRECTION_RIGHT:
+	switch (OpponentDirection[index]) {
+		case OPPONENT_DIRECTION_LEFT:
+		case OPPONENT_DIRECTION_RIGHT:
 			/* Walking on a floor. Check for floor ends. */
-			directions|=((checkSpriteAtLeftFloorEnd(Opponent[index].sprite))^1)<<OPPONENT_DIRECTION_LEFT;
-			directions|=((checkSpriteAtRightFloorEnd(Opponent[index].sprite))^1)<<OPPONENT_DIRECTION_RIGHT;
+			directions|=((checkSpriteAtLeftFloorEnd(OpponentSprite[index]))^1)<<OPPONENT_DIRECTION_LEFT;
+			directions|=((checkSpriteAtRightFloorEnd(OpponentSprite[index]))^1)<<OPPONENT_DIRECTION_RIGHT;
 
 			/* Check if we could step on a ladder downwards. */
-			directions|=(checkSpriteAtLadderEntryDown(Opponent[index].sprite))<<OPPONENT_DIRECTION_DOWN;
-
-			/* Check if we could step on a ladder upwards. */
-			if (checkSpriteAtLadderEntryUp(Opponent[index].sprite)) {
-				/*
-				 * Yes. Check if the opponent should mess up ladders.
-				 * Squirt if the player is above the opponent.
-				 * Add up as a possible direction if not.
-				 */
-				if (((Opponent[index].flags & OPPONENT_FLAGS_ALGORITHM_MASK) == OPPONENT_FLAGS_ALGORITHM_MESS_UP_LADDERS)
-					&& (getSpriteY(Player.sprite) < getSpriteY(Opponent[index].sprite)))
-					changeOpponentDirection(index,OPPONENT_FLAGS_DIRECTION_SQUIRT);
-				else
-					directions|=1<<OPPONENT_DIRECTION_UP;
-			} else if (checkSpriteAtSquirtedLadderEntryUp(Opponent[index].sprite))
+			directions|=(checkSpriteAtLadderEntryDown(OpponentSprite[index]))<<OPPONENT_DIRECTION_DOWN;
+
+			/* Check if we could step on a ladder upwards, blocked ones too. */
+			if (checkSpriteAtLadderEntryUp(OpponentSprite[index])
+					|| checkSpriteAtBlockedLadder(OpponentSprite[index]))
 				directions|=1<<OPPONENT_DIRECTION_UP;
 			break;
-		case OPPONENT_FLAGS_DIRECTION_UP:
-		case OPPONENT_FLAGS_DIRECTION_DOWN:
+		case OPPONENT_DIRECTION_UP:
+		case OPPONENT_DIRECTION_DOWN:
 			/* Climbing/stepping down a ladder. Check for ladder end. */
-			directions|=((checkSpriteAtLadderTop(Opponent[index].sprite))^1)<<OPPONENT_DIRECTION_UP;
-			directions|=((checkSpriteAtLadderBottom(Opponent[index].sprite))^1)<<OPPONENT_DIRECTION_DOWN;
+			directions|=((checkSpriteAtLadderTop(OpponentSprite[index]))^1)<<OPPONENT_DIRECTION_UP;
+			directions|=((checkSpriteAtLadderBottom(OpponentSprite[index]))^1)<<OPPONENT_DIRECTION_DOWN;
 
 			/* Check if we could step on a floor. */
-			if (checkSpriteAtLadderExit(Opponent[index].sprite)) {
-				directions|=((checkSpriteAtLeftFloorEnd(Opponent[index].sprite))^1)<<OPPONENT_DIRECTION_LEFT;
-				directions|=((checkSpriteAtRightFloorEnd(Opponent[index].sprite))^1)<<OPPONENT_DIRECTION_RIGHT;
-			}
-			break;
-		case OPPONENT_FLAGS_DIRECTION_SQUIRT:
-			/* Check if the player is still above the opponent. */
-			if (getSpriteY(Player.sprite) < getSpriteY(Opponent[index].sprite)) {
-				/* Yes. Continue squirting until the whole ladder is messed up. */
-				if (!(GameScreenAnimationPhase & OPPONENT_SQUIRT_PHASE)) {
-					if (!(squirtOnLadderAtSprite(Opponent[index].sprite))) {
-						/* Trigger squirt sound. */
-						TriggerFx(PATCH_SQUIRT_LADDER,63,true);
-
-						/* Do not select a new direction. */
-						return;
-					}
-				} else {
-					/* Do not select a new direction. */
-					return;
-				}
+			if (checkSpriteAtLadderExit(OpponentSprite[index])) {
+				directions|=((checkSpriteAtLeftFloorEnd(OpponentSprite[index]))^1)<<OPPONENT_DIRECTION_LEFT;
+				directions|=((checkSpriteAtRightFloorEnd(OpponentSprite[index]))^1)<<OPPONENT_DIRECTION_RIGHT;
 			}
-
-			/* Add up to possible directions. */
-			directions|=1<<OPPONENT_DIRECTION_UP;
 			break;
-		case OPPONENT_FLAGS_DIRECTION_HIT_LEFT:
-		case OPPONENT_FLAGS_DIRECTION_HIT_RIGHT:
-			/* Do not select a new direction once an opponent is hit. */
-			return;
 	}
 
-	/*
-	 *  Check if this opponent has nearly the same coordinates
-	 *  as another opponent with the same direction and algorithm.
-	 */
+	/* Return possible directions. */
+	return directions;
+}
+
+
+/*
+ *  Check if this opponent has nearly the same coordinates
+ *  as another opponent with the same direction and algorithm.
+ *  Change direction randomly if so.
+ */
+uint8_t checkCrowdedOpponent(uint8_t index, uint8_t directions) {
+	uint8_t i;
+
 	for (i=0;i<OPPONENT_MAX;i++) {
-		/* Skip self */
-		if (i==index) continue;
+		/* Skip self and invalid opponents. */
+		if ((i==index) || (OpponentFlags[i] == OPPONENT_FLAGS_INVALID)) continue;
 
 		/* Skip if different direction or algorithm. */
-		if ((Opponent[index].flags & (OPPONENT_FLAGS_DIRECTION_MASK|OPPONENT_FLAGS_ALGORITHM_MASK))
-				!= (Opponent[i].flags & (OPPONENT_FLAGS_DIRECTION_MASK|OPPONENT_FLAGS_ALGORITHM_MASK)))
+		if ((OpponentDirection[index] != OpponentDirection[i])
+				|| ((OpponentFlags[index] & OPPONENT_FLAGS_ALGORITHM_MASK) != (OpponentFlags[i] & OPPONENT_FLAGS_ALGORITHM_MASK)))
 			continue;
 
 		/* Check coordinates. */
-		if (((getSpriteX(Opponent[index].sprite) & 0xf0) == ((getSpriteX(Opponent[i].sprite) & 0xf0)))
-				&& ((getSpriteY(Opponent[index].sprite) & 0xf0) == ((getSpriteY(Opponent[i].sprite) & 0xf0)))) {
+		if (((getSpriteX(OpponentSprite[index]) & 0xf0) == ((getSpriteX(OpponentSprite[i]) & 0xf0)))
+				&& ((getSpriteY(OpponentSprite[index]) & 0xf0) == ((getSpriteY(OpponentSprite[i]) & 0xf0)))) {
 			/* Same. Change oppenent direction randomly. */
 			changeOpponentDirection(index,selectPossibleOpponentDirectionRandomly(index,directions));
-			return;
+			return 1;
 		}
 	}
 
+	/* Not crowded. */
+	return 0;
+}
+
+
+/* Select direction nearer to the player. */
+void selectOpponentDirectionNearerToPlayer(uint8_t index, uint8_t directions) {
+	/* Target position is player position. */
+	selectOpponentDirectionNearerToTarget(index,directions,
+		getSpriteX(Player.sprite),getSpriteY(Player.sprite));
+
+	/* Reset mad flag every other animation phase. */
+	if (!(GameScreenAnimationPhase & OPPONENT_MAD_RESET_PHASE))
+		OpponentFlags[index]&=~OPPONENT_FLAGS_MAD;
+}
+
+
+/* Select direction nearer to a random burger component. */
+void selectOpponentDirectionNearerToBurger(uint8_t index, uint8_t directions) {
+	/* Target reached? */
+	if (((getSpriteX(OpponentSprite[index]) & 0xf0) == (OpponentInfo[index].target.x & 0xf0))
+			&& ((getSpriteY(OpponentSprite[index]) & 0xf0) == (OpponentInfo[index].target.y & 0xf0))) {
+		/* Yes. Get a new target position, random buntop. */
+		OpponentInfo[index].target=getRandomBurgerComponentPosition();
+
+		/* Reset mad flag. */
+		OpponentFlags[index]&=~OPPONENT_FLAGS_MAD;
+	}
+
+	/* Move nearer to target. */
+	selectOpponentDirectionNearerToTarget(index,directions,
+		OpponentInfo[index].target.x,OpponentInfo[index].target.y);
+}
+
+
+/* Select a new direction for an opponent following the player. */
+void selectFollowPlayerDirection(uint8_t index) {
+	uint8_t directions;
+
+	/* Check possible directions depending on current position. */
+	directions=getPossibleOpponentDirections(index);
+
 	/* Feed possible directions into movement algorithm. */
-	switch (Opponent[index].flags & OPPONENT_FLAGS_ALGORITHM_MASK) {
-		case OPPONENT_FLAGS_ALGORITHM_FOLLOW_PLAYER:
-		case OPPONENT_FLAGS_ALGORITHM_MESS_UP_LADDERS:
-			/* Target position is player position. */
-			selectOpponentDirectionNearerToTarget(index,directions,
-				getSpriteX(Player.sprite),getSpriteY(Player.sprite));
+	if (!checkCrowdedOpponent(index,directions))
+		selectOpponentDirectionNearerToPlayer(index,directions);
+}
 
-			/* Reset mad flag every other animation phase. */
-			if (!(GameScreenAnimationPhase & OPPONENT_MAD_RESET_PHASE))
-				Opponent[index].flags&=~OPPONENT_FLAGS_MAD;
 
-			break;
-		case OPPONENT_FLAGS_ALGORITHM_BURGER_PATROLLER:
-		case OPPONENT_FLAGS_ALGORITHM_STOMPER:
-			/* Target reached? */
-			if (((getSpriteX(Opponent[index].sprite) & 0xf0) == (Opponent[index].info.target.x & 0xf0))
-					&& ((getSpriteY(Opponent[index].sprite) & 0xf0) == (Opponent[index].info.target.y & 0xf0))) {
-				/* Yes. Get a new target position, random buntop. */
-				Opponent[index].info.target=getRandomBurgerComponentPosition();
-
-				/* Reset mad flag. */
-				Opponent[index].flags&=~OPPONENT_FLAGS_MAD;
+/* Select a new direction for an opponent patrolling around burgers. */
+void selectBurgerPatrollerDirection(uint8_t index) {
+	uint8_t directions;
+
+	/* Check possible directions depending on current position. */
+	directions=getPossibleOpponentDirections(index);
+
+	/* Feed possible directions into movement algorithm. */
+	if (!checkCrowdedOpponent(index,directions))
+		selectOpponentDirectionNearerToBurger(index,directions);
+}
+
+
+/* Select a new direction for an opponent messing up ladders. */
+void selectMessUpLaddersDirection(uint8_t index) {
+	uint8_t directions;
+
+	if (OpponentDirection[index] == OPPONENT_DIRECTION_SQUIRT) {
+		/* Check if the player is still above the opponent. */
+		if (getSpriteY(Player.sprite) < getSpriteY(OpponentSprite[index])) {
+			/* Yes. Continue squirting until the whole ladder is messed up. */
+			if (!(GameScreenAnimationPhase & OPPONENT_SQUIRT_PHASE)) {
+				if (!(squirtOnLadderAtSprite(OpponentSprite[index]))) {
+					/* Trigger squirt sound. */
+					TriggerFx(PATCH_SQUIRT_LADDER,63,true);
+
+					/* Do not select a new direction. */
+					return;
+				}
+			} else {
+				/* Do not select a new direction. */
+				return;
 			}
+		}
 
-			/* Move nearer to target. */
-			selectOpponentDirectionNearerToTarget(index,directions,
-				Opponent[index].info.target.x,Opponent[index].info.target.y);
-			break;
+		/* Only up is possible when done with squirting. */
+		directions=1<<OPPONENT_DIRECTION_UP;
+	} else {
+		/* Check possible directions depending on current position. */
+		directions=getPossibleOpponentDirections(index);
+
+		/* Squirt instead of going up a ladder if the player is above the opponent. */
+		if (((OpponentDirection[index] == OPPONENT_DIRECTION_LEFT) || (OpponentDirection[index] == OPPONENT_DIRECTION_RIGHT))
+				&& checkSpriteAtLadderEntryUp(OpponentSprite[index])
+				&& (getSpriteY(Player.sprite) < getSpriteY(OpponentSprite[index]))) {
+			directions&=~(1<<OPPONENT_DIRECTION_UP);
+			changeOpponentDirection(index,OPPONENT_DIRECTION_SQUIRT);
+		}
 	}
+
+	/* Feed possible directions into movement algorithm. */
+	if (!checkCrowdedOpponent(index,directions))
+		selectOpponentDirectionNearerToPlayer(index,directions);
 }
 
 
+/* Select a new direction for an opponent stomping on burgers. */
+void selectStomperDirection(uint8_t index) {
+	uint8_t directions;
+
+	/* Check possible directions depending on current position. */
+	directions=getPossibleOpponentDirections(index);
+
+	/* Feed possible directions into movement algorithm. */
+	if (!checkCrowdedOpponent(index,directions))
+		selectOpponentDirectionNearerToBurger(index,directions);
+}
+
 
 /* Move opponent into selected direction. */
-void moveOpponent(uint8_t index) {
+void moveOpponentStraight(uint8_t index) {
 	int16_t y;
 	int8_t dir=1;
 
-	/* Skip invalid opponent. */
-	if (Opponent[index].flags == OPPONENT_FLAGS_INVALID) return;
-
 	/* Move by direction. */
-	switch (Opponent[index].flags & OPPONENT_FLAGS_DIRECTION_MASK) {
-		case OPPONENT_FLAGS_DIRECTION_LEFT:
-			/* Move opponent. */
-			moveSprite(Opponent[index].sprite,-(1<<((Opponent[index].flags & OPPONENT_FLAGS_SPEED_MASK)>>OPPONENT_FLAGS_SPEED_SHIFT)),0);
-
-			/* Stomp tiles under stomper opponents. */
-			if ((Opponent[index].flags & OPPONENT_FLAGS_ALGORITHM_MASK) == OPPONENT_FLAGS_ALGORITHM_STOMPER)
-				stompUnderSprite(Opponent[index].sprite);
-
+	switch (OpponentDirection[index]) {
+		case OPPONENT_DIRECTION_LEFT:
+			moveSprite(OpponentSprite[index],-OpponentSpeed[index],0);
 			break;
-		case OPPONENT_FLAGS_DIRECTION_RIGHT:
-			/* Move opponent. */
-			moveSprite(Opponent[index].sprite,1<<((Opponent[index].flags & OPPONENT_FLAGS_SPEED_MASK)>>OPPONENT_FLAGS_SPEED_SHIFT),0);
-
-			/* Stomp tiles under stomper opponents. */
-			if ((Opponent[index].flags & OPPONENT_FLAGS_ALGORITHM_MASK) == OPPONENT_FLAGS_ALGORITHM_STOMPER)
-				stompUnderSprite(Opponent[index].sprite);
-
+		case OPPONENT_DIRECTION_RIGHT:
+			moveSprite(OpponentSprite[index],OpponentSpeed[index],0);
 			break;
-		case OPPONENT_FLAGS_DIRECTION_UP:
-			moveSprite(Opponent[index].sprite,0,-(1<<((Opponent[index].flags & OPPONENT_FLAGS_SPEED_MASK)>>OPPONENT_FLAGS_SPEED_SHIFT)));
+		case OPPONENT_DIRECTION_UP:
+			moveSprite(OpponentSprite[index],0,-OpponentSpeed[index]);
 			break;
-		case OPPONENT_FLAGS_DIRECTION_DOWN:
-			moveSprite(Opponent[index].sprite,0,1<<((Opponent[index].flags & OPPONENT_FLAGS_SPEED_MASK)>>OPPONENT_FLAGS_SPEED_SHIFT));
+		case OPPONENT_DIRECTION_DOWN:
+			moveSprite(OpponentSprite[index],0,OpponentSpeed[index]);
 			break;
-		case OPPONENT_FLAGS_DIRECTION_SQUIRT:
-			moveSprite(Opponent[index].sprite,0,0);
+		case OPPONENT_DIRECTION_SQUIRT:
+			moveSprite(OpponentSprite[index],0,0);
 			break;
-		case OPPONENT_FLAGS_DIRECTION_HIT_LEFT:
+		case OPPONENT_DIRECTION_HIT_LEFT:
 			dir=-1;
-		case OPPONENT_FLAGS_DIRECTION_HIT_RIGHT:
+		case OPPONENT_DIRECTION_HIT_RIGHT:
 			/* Move to invalid coordinate? */
-			y=getSpriteY(Opponent[index].sprite);
-			y+=Opponent[index].info.hit_speed;
+			y=getSpriteY(OpponentSprite[index]);
+			y+=OpponentInfo[index].hit_speed;
 			if (y>(SCREEN_HEIGHT*8)) {
-				/* Yes. Remove opponent from screen. */
-				unmapSprite(Opponent[index].sprite);
+				/* Yes. Remove opponent from screen and free its sprite. */
+				freeSpriteSlot(OpponentSprite[index]);
+				OpponentSprite[index]=SPRITE_SLOTS_FULL;
 
 				/* Mark opponent as removed. */
-				Opponent[index].flags=OPPONENT_FLAGS_INVALID;
+				OpponentFlags[index]=OPPONENT_FLAGS_INVALID;
 			} else {
 				/* No. Move with hit speed. */
-				moveSprite(Opponent[index].sprite,dir*OPPONENT_HIT_SPEED_X,Opponent[index].info.hit_speed);
+				moveSprite(OpponentSprite[index],dir*OPPONENT_HIT_SPEED_X,OpponentInfo[index].hit_speed);
 
 				/* Turn hit speed from negative to more positive for next step. */
-				Opponent[index].info.hit_speed++;
+				OpponentInfo[index].hit_speed++;
 			}
 			break;
 	}
 }
 
 
+/* Move stomper opponent, stomp tiles under it when walking on a floor. */
+void moveStomper(uint8_t index) {
+	/* Move opponent. */
+	moveOpponentStraight(index);
+
+	/* Stomp tiles under stomper opponents. */
+	if ((OpponentDirection[index] == OPPONENT_DIRECTION_LEFT) || (OpponentDirection[index] == OPPONENT_DIRECTION_RIGHT))
+		stompUnderSprite(OpponentSprite[index]);
+}
+
+
+/* Opponent handlers by movement algorithm. */
+const opponent_algorithm_t OpponentAlgorithms[] PROGMEM = {
+	[OPPONENT_FLAGS_ALGORITHM_FOLLOW_PLAYER>>OPPONENT_FLAGS_ALGORITHM_SHIFT]    = { selectFollowPlayerDirection, moveOpponentStraight },
+	[OPPONENT_FLAGS_ALGORITHM_BURGER_PATROLLER>>OPPONENT_FLAGS_ALGORITHM_SHIFT] = { selectBurgerPatrollerDirection, moveOpponentStraight },
+	[OPPONENT_FLAGS_ALGORITHM_MESS_UP_LADDERS>>OPPONENT_FLAGS_ALGORITHM_SHIFT]  = { selectMessUpLaddersDirection, moveOpponentStraight },
+	[OPPONENT_FLAGS_ALGORITHM_STOMPER>>OPPONENT_FLAGS_ALGORITHM_SHIFT]          = { selectStomperDirection, moveStomper },
+};
+
+
+/* Select a new opponent direction. */
+void selectOpponentDirection(uint8_t index) {
+	/* Skip invalid and hit opponent. */
+	if (checkInvalidOrHitOpponent(index)) return;
+
+	/* Call handler for movement algorithm. */
+	((opponent_handler_t)pgm_read_word(&OpponentAlgorithms[(OpponentFlags[index] & OPPONENT_FLAGS_ALGORITHM_MASK)>>OPPONENT_FLAGS_ALGORITHM_SHIFT].select))(index);
+}
+
+
+/* Move opponent into selected direction. */
+void moveOpponent(uint8_t index) {
+	/* Skip invalid opponent. */
+	if (OpponentFlags[index] == OPPONENT_FLAGS_INVALID) return;
+
+	/* Call handler for movement algorithm. */
+	((opponent_handler_t)pgm_read_word(&OpponentAlgorithms[(OpponentFlags[index] & OPPONENT_FLAGS_ALGORITHM_MASK)>>OPPONENT_FLAGS_ALGORITHM_SHIFT].move))(index);
+}
+
+
 /* Check for invalid and hit opponent. */
 uint8_t checkInvalidOrHitOpponent(uint8_t index) {
-	return ((Opponent[index].flags == OPPONENT_FLAGS_INVALID)
-			|| ((Opponent[index].flags & OPPONENT_FLAGS_DIRECTION_MASK) == OPPONENT_FLAGS_DIRECTION_HIT_LEFT)
-			|| ((Opponent[index].flags & OPPONENT_FLAGS_DIRECTION_MASK) == OPPONENT_FLAGS_DIRECTION_HIT_RIGHT));
+	return ((OpponentFlags[index] == OPPONENT_FLAGS_INVALID)
+			|| (OpponentDirection[index] == OPPONENT_DIRECTION_HIT_LEFT)
+			|| (OpponentDirection[index] == OPPONENT_DIRECTION_HIT_RIGHT));
 }
 
 
@@ -495,7 +595,7 @@ void kickOpponentInDirection(uint8_t index, uint8_t direction) {
 	changeOpponentDirection(index,direction);
 
 	/* Initialize hit speed. */
-	Opponent[index].info.hit_speed=min(getSpriteY(Opponent[index].sprite)*getSpriteY(Opponent[index].sprite),OPPONENT_START_HIT_SPEED_Y);
+	OpponentInfo[index].hit_speed=min(getSpriteY(OpponentSprite[index])*getSpriteY(OpponentSprite[index]),OPPONENT_START_HIT_SPEED_Y);
 }
 
 
@@ -506,14 +606,14 @@ void kickOpponent(uint8_t index) {
 		return;
 
 	/* Kick opponent off the screen. */
-	switch (Opponent[index].flags & OPPONENT_FLAGS_DIRECTION_MASK) {
-		case OPPONENT_FLAGS_DIRECTION_NONE:
-		case OPPONENT_FLAGS_DIRECTION_RIGHT:
-		case OPPONENT_FLAGS_DIRECTION_UP:
-			kickOpponentInDirection(index,OPPONENT_FLAGS_DIRECTION_HIT_RIGHT);
+	switch (OpponentDirection[index]) {
+		case OPPONENT_DIRECTION_NONE:
+		case OPPONENT_DIRECTION_RIGHT:
+		case OPPONENT_DIRECTION_UP:
+			kickOpponentInDirection(index,OPPONENT_DIRECTION_HIT_RIGHT);
 			break;
 		default:
-			kickOpponentInDirection(index,OPPONENT_FLAGS_DIRECTION_HIT_LEFT);
+			kickOpponentInDirection(index,OPPONENT_DIRECTION_HIT_LEFT);
 	}
 }
 
@@ -525,7 +625,7 @@ void kickOpponentIfHit(uint8_t index) {
 		return;
 
 	/* Skip if opponent is not hit by any burger component. */
-	if (!checkFallingBurgerComponentPosition(getSpriteX(Opponent[index].sprite)-SPRITE_BORDER_WIDTH,getSpriteY(Opponent[index].sprite)))
+	if (!checkFallingBurgerComponentPosition(getSpriteX(OpponentSprite[index])-SPRITE_BORDER_WIDTH,getSpriteY(OpponentSprite[index])))
 		return;
 
 	/* Collision. Kick it off the screen. */
@@ -554,8 +654,8 @@ void kickOpponentIfPeppered(uint8_t index) {
 	/* Get coordinates. */
 	px=getSpriteX(Pepper.sprite);
 	py=getSpriteY(Pepper.sprite);
-	ox=getSpriteX(Opponent[index].sprite);
-	oy=getSpriteY(Opponent[index].sprite);
+	ox=getSpriteX(OpponentSprite[index]);
+	oy=getSpriteY(OpponentSprite[index]);
 
 	/* Skip if the opponent is roughly on same floor as the pepper. */
 	if (abs(py-oy) > OPPONENT_PEPPER_COLLISION_DISTANCE_FLOOR)
@@ -568,10 +668,10 @@ void kickOpponentIfPeppered(uint8_t index) {
 	/* Collision. Kick opponent off the screen. */
 	switch (Pepper.flags & PEPPER_FLAGS_DIRECTION_MASK) {
 		case PEPPER_FLAGS_DIRECTION_RIGHT:
-			kickOpponentInDirection(index,OPPONENT_FLAGS_DIRECTION_HIT_RIGHT);
+			kickOpponentInDirection(index,OPPONENT_DIRECTION_HIT_RIGHT);
 			break;
 		default:
-			kickOpponentInDirection(index,OPPONENT_FLAGS_DIRECTION_HIT_LEFT);
+			kickOpponentInDirection(index,OPPONENT_DIRECTION_HIT_LEFT);
 	}
 
 	/* Score for hit opponent. */
@@ -593,8 +693,8 @@ uint8_t checkIfOpponentCaughtPlayer(uint8_t index) {
 	/* Get coordinates. */
 	px=getSpriteX(Player.sprite);
 	py=getSpriteY(Player.sprite);
-	ox=getSpriteX(Opponent[index].sprite);
-	oy=getSpriteY(Opponent[index].sprite);
+	ox=getSpriteX(OpponentSprite[index]);
+	oy=getSpriteY(OpponentSprite[index]);
 
 	/* Check if the opponent is roughly on same floor as the player. */
 	if (abs(py-oy) <= OPPONENT_PLAYER_COLLISION_DISTANCE_FLOOR) {
@@ -23,37 +23,40 @@
 #include "utils.h"
 
 
-/* Opponent basics. */
-#define OPPONENT_MAX 4
+/*
+ *  Opponent basics. There are no more opponents than kernel sprites for
+ *  them: the cook and the pepper take 5 of the 24, the remaining 19 are
+ *  enough for four block opponents (4 each) and a Mr. Mustard, or eight
+ *  Mr. Mustards (2 each). RAM tiles running out are left to the sprite
+ *  multiplexer in commitSprites(). A horde brings up to four more
+ *  opponents than the quad setting.
+ */
+#define OPPONENT_MAX 8
+#define OPPONENT_HORDE_EXTRA ((OPPONENT_MAX-4))
 #define OPPONENT_START_POSITION_MAX 8
 #define OPPONENT_START_POSITION_INVALID 0xff
 #define OPPONENT_TARGET_POSITION_INVALID 0xff
 #define OPPONENT_ATTACK_WAVE_DEFAULT_SHIFT 9
 
 
-/* Opponent flags: direction, speed, movement algorithm. */
-#define OPPONENT_DIRECTION_LEFT  1
-#define OPPONENT_DIRECTION_RIGHT 2
-#define OPPONENT_DIRECTION_UP    3
-#define OPPONENT_DIRECTION_DOWN  4
+/* Opponent directions. */
+#define OPPONENT_DIRECTION_NONE      0
+#define OPPONENT_DIRECTION_LEFT      1
+#define OPPONENT_DIRECTION_RIGHT     2
+#define OPPONENT_DIRECTION_UP        3
+#define OPPONENT_DIRECTION_DOWN      4
+#define OPPONENT_DIRECTION_HIT_LEFT  5
+#define OPPONENT_DIRECTION_HIT_RIGHT 6
+#define OPPONENT_DIRECTION_SQUIRT    7
+
+/* Opponent speeds, in pixels per move. */
+#define OPPONENT_SPEED_SLOW   1
+#define OPPONENT_SPEED_NORMAL 2
+#define OPPONENT_SPEED_FAST   4
+#define OPPONENT_SPEED_DASH   8
 
+/* Opponent flags: movement algorithm, mad state. */
 #define OPPONENT_FLAGS_INVALID             0xff
-#define OPPONENT_FLAGS_DIRECTION_SHIFT     0
-#define OPPONENT_FLAGS_DIRECTION_MASK      ((0x07<<OPPONENT_FLAGS_DIRECTION_SHIFT))
-#define OPPONENT_FLAGS_DIRECTION_NONE      ((0<<OPPONENT_FLAGS_DIRECTION_SHIFT))
-#define OPPONENT_FLAGS_DIRECTION_LEFT      ((OPPONENT_DIRECTION_LEFT<<OPPONENT_FLAGS_DIRECTION_SHIFT))
-#define OPPONENT_FLAGS_DIRECTION_RIGHT     ((OPPONENT_DIRECTION_RIGHT<<OPPONENT_FLAGS_DIRECTION_SHIFT))
-#define OPPONENT_FLAGS_DIRECTION_UP        ((OPPONENT_DIRECTION_UP<<OPPONENT_FLAGS_DIRECTION_SHIFT))
-#define OPPONENT_FLAGS_DIRECTION_DOWN      ((OPPONENT_DIRECTION_DOWN<<OPPONENT_FLAGS_DIRECTION_SHIFT))
-#define OPPONENT_FLAGS_DIRECTION_HIT_LEFT  ((5<<OPPONENT_FLAGS_DIRECTION_SHIFT))
-#define OPPONENT_FLAGS_DIRECTION_HIT_RIGHT ((6<<OPPONENT_FLAGS_DIRECTION_SHIFT))
-#define OPPONENT_FLAGS_DIRECTION_SQUIRT    ((7<<OPPONENT_FLAGS_DIRECTION_SHIFT))
-#define OPPONENT_FLAGS_SPEED_SHIFT         3
-#define OPPONENT_FLAGS_SPEED_MASK          ((0x03<<OPPONENT_FLAGS_SPEED_SHIFT))
-#define OPPONENT_FLAGS_SPEED_SLOW          ((0<<OPPONENT_FLAGS_SPEED_SHIFT))
-#define OPPONENT_FLAGS_SPEED_NORMAL        ((1<<OPPONENT_FLAGS_SPEED_SHIFT))
-#define OPPONENT_FLAGS_SPEED_FAST          ((2<<OPPONENT_FLAGS_SPEED_SHIFT))
-#define OPPONENT_FLAGS_SPEED_DASH          ((3<<OPPONENT_FLAGS_SPEED_SHIFT))
 #define OPPONENT_FLAGS_ALGORITHM_SHIFT            5
 #define OPPONENT_FLAGS_ALGORITHM_MASK             ((0x03<<OPPONENT_FLAGS_ALGORITHM_SHIFT))
 #define OPPONENT_FLAGS_ALGORITHM_FOLLOW_PLAYER    ((0<<OPPONENT_FLAGS_ALGORITHM_SHIFT))
@@ -88,16 +91,24 @@
 #define OPPONENT_PEPPER_COLLISION_DISTANCE_FLOOR 4
 #define OPPONENT_PEPPER_COLLISION_DISTANCE_ON_FLOOR 8
 
+typedef union {
+	position_t target;
+	int8_t hit_speed;
+} opponent_info_t;
+
+/* Opponent handlers, by movement algorithm. */
+typedef void (*opponent_handler_t)(uint8_t index);
+
 typedef struct {
-	uint8_t flags;
-	uint8_t sprite;
-	union {
-		position_t target;
-		int8_t hit_speed;
-	} info;
-} opponent_t;
-
-extern opponent_t Opponent[OPPONENT_MAX];
+	opponent_handler_t select;
+	opponent_handler_t move;
+} opponent_algorithm_t;
+
+extern uint8_t OpponentFlags[OPPONENT_MAX];
+extern uint8_t OpponentDirection[OPPONENT_MAX];
+extern uint8_t OpponentSpeed[OPPONENT_MAX];
+extern uint8_t OpponentSprite[OPPONENT_MAX];
+extern opponent_info_t OpponentInfo[OPPONENT_MAX];
 extern position_t OpponentStartPosition[OPPONENT_START_POSITION_MAX];
 extern uint16_t OpponentAttackWaves;
 extern uint8_t OpponentRandomness;
@@ -23,6 +23,7 @@
 #include "tiles.h"
 #include "sprites.h"
 #include "patches.h"
+#include "levelpack.h"
 
 
 /* Maximum number of burger components per screen. */
@@ -73,6 +74,8 @@ struct {
 	burger_component_place_t place[SCREEN_BURGER_PLACE_MAX];
 	burger_component_t component[SCREEN_BURGER_COMPONENT_MAX];
 } GameScreenBurger[SCREEN_BURGER_MAX];
+ladder_t GameScreenLadder[SCREEN_LADDER_MAX];
+uint8_t GameScreenLadderColumn[SCREEN_LADDER_COLUMNS];
 uint8_t HurryBuffer[3];
 
 
@@ -80,17 +83,24 @@ uint8_t HurryBuffer[3];
 uint8_t Level;
 const uint8_t *LevelDrawing;
 
+/* Pointer to component blocks of current level, in flash or level pack buffer. */
+const level_item_t *LevelComponentsBase;
 
-/* Select a level. */
-void selectLevel(uint8_t level) {
+
+/* Select a level from flash. */
+void selectFlashLevel(uint8_t level) {
 	const uint8_t *p=LevelDrawings;
 
-	/* Remember level number. */
-	Level=level;
+	/* Level data is in flash. */
+	LevelComponentsBase=LevelComponents;
 
 	/* Start level descriptions with level 1. */
 	level--;
 
+#ifdef LEVEL_INDEX
+	/* Look up level drawing. Restart with first level if end of level descriptions reached. */
+	p+=pgm_read_word(&LevelDrawingsIndex[level % pgm_read_byte(&LevelDrawingsCount)]);
+#else
 	/* Skip level drawings to given level. */
 	while (level--) {
 		/* Skip to next level description. */
@@ -100,12 +110,47 @@ void selectLevel(uint8_t level) {
 		/* Restart with first level if end of level descriptions reached. */
 		if (!pgm_read_byte(p)) p=LevelDrawings;
 	}
+#endif
 
 	/* Remember level drawing pointer. */
 	LevelDrawing=p;
 }
 
 
+/* Select a level. */
+void selectLevel(uint8_t level) {
+	/* Remember level number. */
+	Level=level;
+
+	/* Load level from level pack if there is one. */
+	if (selectLevelPackLevel(level))
+		return;
+
+	/* Level data is in flash. */
+	selectFlashLevel(level);
+}
+
+
+/* Get first item of a component block of the current level. Blocks are counted from 1. */
+const level_item_t *getLevelComponentBlock(uint8_t b) {
+	const level_item_t *q=LevelComponentsBase;
+
+#ifdef LEVEL_INDEX
+	/* Look up component block if level data is in flash. */
+	if (q == LevelComponents)
+		return q+pgm_read_word(&LevelComponentsIndex[b-1]);
+#endif
+
+	/* Skip to selected drawing components block. */
+	while (--b) {
+		while (readLevelByte(&(q->component))) q++;
+		q++;
+	}
+
+	return q;
+}
+
+
 /* Prepare current level description. */
 void prepareLevelDescription(uint8_t sy) {
 	const uint8_t *p=LevelDrawing;
@@ -113,21 +158,15 @@ void prepareLevelDescription(uint8_t sy) {
 	uint8_t b, c, x, y, cy;
 
 	/* Go through level specific screen list. */
-	while ((b=pgm_read_byte(p))) {
-		/* Start at first component block. */
-		q=LevelComponents;
-
-		/* Skip to selected drawing components block. */
-		while (--b) {
-			while (pgm_read_byte(&(q->component))) q++;
-			q++;
-		}
+	while ((b=readLevelByte(p))) {
+		/* Get selected drawing components block. */
+		q=getLevelComponentBlock(b);
 
 		/* Go through all drawing components in that block. */
-		while ((c=pgm_read_byte(&(q->component)))) {
+		while ((c=readLevelByte(&(q->component)))) {
 			/* Get coordinate */
-			x=pgm_read_byte(&(q->position.x));
-			y=pgm_read_byte(&(q->position.y));
+			x=readLevelByte(&(q->position.x));
+			y=readLevelByte(&(q->position.y));
 
 			/* Check for type of level item. */
 			switch (c) {
@@ -188,7 +227,7 @@ void prepareLevel(void) {
 	const uint8_t *p=LevelDrawing;
 	const level_item_t *q;
 	uint8_t b, c, x, y, burger, place, component;
-	uint8_t i, opponent_start_index;
+	uint8_t i, opponent_start_index, ladder, *l;
 
 	/* Reset options. */
 	GameScreenOptions=LEVEL_ITEM_OPTION_STOMP_ONCE|LEVEL_ITEM_OPTION_OPPONENT_DUO;
@@ -202,6 +241,13 @@ void prepareLevel(void) {
 			GameScreenBurger[burger].component[component].type=LEVEL_ITEM_INVALID;
 	}
 
+	/* Reset ladders. */
+	ladder=0;
+	for (i=0;i<SCREEN_LADDER_MAX;i++)
+		GameScreenLadder[i].x=SCREEN_LADDER_INVALID;
+	for (i=0;i<SCREEN_LADDER_COLUMNS;i++)
+		GameScreenLadderColumn[i]=SCREEN_LADDER_INVALID;
+
 	/* Reset opponent start positions. */
 	opponent_start_index=0;
 	for (i=0;i<OPPONENT_START_POSITION_MAX;i++)
@@ -209,21 +255,15 @@ void prepareLevel(void) {
 
 
 	/* Go through level specific screen list. */
-	while ((b=pgm_read_byte(p))) {
-		/* Start at first component block. */
-		q=LevelComponents;
-
-		/* Skip to selected drawing components block. */
-		while (--b) {
-			while (pgm_read_byte(&(q->component))) q++;
-			q++;
-		}
+	while ((b=readLevelByte(p))) {
+		/* Get selected drawing components block. */
+		q=getLevelComponentBlock(b);
 
 		/* Go through all drawing components in that block. */
-		while ((c=pgm_read_byte(&(q->component)))) {
+		while ((c=readLevelByte(&(q->component)))) {
 			/* Get coordinates */
-			x=pgm_read_byte(&(q->position.x));
-			y=pgm_read_byte(&(q->position.y));
+			x=readLevelByte(&(q->position.x));
+			y=readLevelByte(&(q->position.y));
 
 			/* Check for type of level item. */
 			switch (c) {
@@ -242,11 +282,11 @@ void prepareLevel(void) {
 					break;
 				case LEVEL_ITEM_ATTACKWAVES:
 					/* Remember attack waves. */
-					OpponentAttackWaves=pgm_read_word(&(q->options));
+					OpponentAttackWaves=readLevelWord(&(q->options));
 					break;
 				case LEVEL_ITEM_OPTIONS:
 					/* Use x and y values as option field. */
-					GameScreenOptions=pgm_read_word(&(q->options));
+					GameScreenOptions=readLevelWord(&(q->options));
 					break;
 				case LEVEL_ITEM_PLATE:
 				case LEVEL_ITEM_BURGER_PLACEHOLDER:
@@ -350,6 +390,21 @@ void prepareLevel(void) {
 				default:
 					/* Ladders and floors. */
 					if ((c & LEVEL_ITEM_LADDER) == LEVEL_ITEM_LADDER) {
+						/* Ladder. Remember position of top and bottom exit, nothing squirted yet. */
+						if (ladder<SCREEN_LADDER_MAX && x<SCREEN_LADDER_COLUMNS) {
+							GameScreenLadder[ladder].x=x;
+							GameScreenLadder[ladder].top=y;
+							GameScreenLadder[ladder].bottom=y+(c & LEVEL_ITEM_LADDER_LENGTH);
+							GameScreenLadder[ladder].squirted=0;
+							GameScreenLadder[ladder].wailed=0;
+							GameScreenLadder[ladder].cleaned=0;
+							GameScreenLadder[ladder].next=SCREEN_LADDER_INVALID;
+
+							/* Chain it to the end of its column, so overlapping ladders are found in level order. */
+							for (l=&GameScreenLadderColumn[x];*l != SCREEN_LADDER_INVALID;l=&GameScreenLadder[*l].next);
+							*l=ladder;
+							ladder++;
+						}
 					} else {
 					}
 			}
@@ -430,21 +485,15 @@ void animateLevelStart(void) {
 	uint8_t b, c, x, y, length, pos;
 
 	/* Go through level specific screen list. */
-	while ((b=pgm_read_byte(p))) {
-		/* Start at first component block. */
-		q=LevelComponents;
-
-		/* Skip to selected drawing components block. */
-		while (--b) {
-			while (pgm_read_byte(&(q->component))) q++;
-			q++;
-		}
+	while ((b=readLevelByte(p))) {
+		/* Get selected drawing components block. */
+		q=getLevelComponentBlock(b);
 
 		/* Go through all drawing components in that block. */
-		while ((c=pgm_read_byte(&(q->component))) != 0) {
+		while ((c=readLevelByte(&(q->component))) != 0) {
 			/* Get coordinates */
-			x=pgm_read_byte(&(q->position.x));
-			y=pgm_read_byte(&(q->position.y));
+			x=readLevelByte(&(q->position.x));
+			y=readLevelByte(&(q->position.y));
 
 			/* Check for type of level item. */
 			switch (c) {
@@ -780,6 +829,25 @@ uint8_t checkFallingBurgerComponentPosition(uint8_t x, uint8_t y) {
 }
 
 
+/* Get ladder with pieces at a tile position. */
+uint8_t getLadder(uint8_t x, uint8_t y) {
+	uint8_t i;
+
+	/* No ladders off screen. */
+	if (x >= SCREEN_LADDER_COLUMNS) return SCREEN_LADDER_INVALID;
+
+	/* Go through the ladders of that column only. */
+	for (i=GameScreenLadderColumn[x];i != SCREEN_LADDER_INVALID;i=GameScreenLadder[i].next) {
+		/* Found if position is between the exits. */
+		if ((GameScreenLadder[i].top < y) && (y < GameScreenLadder[i].bottom))
+			return i;
+	}
+
+	/* No ladder there. */
+	return SCREEN_LADDER_INVALID;
+}
+
+
 /* Update statistics on screen (score, level, bonus, lives, peppers etc.) */
 void updateGameScreenStatistics(void) {
 	/* Crawl to actual score. */
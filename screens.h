@@ -103,6 +103,10 @@
 #define LEVEL_ITEM_OPTION_WRAP_MASK  ((0x01<<LEVEL_ITEM_OPTION_WRAP_SHIFT))
 #define LEVEL_ITEM_OPTION_WRAP_NONE     ((0<<LEVEL_ITEM_OPTION_WRAP_SHIFT))
 #define LEVEL_ITEM_OPTION_WRAP_EASTWEST ((1<<LEVEL_ITEM_OPTION_WRAP_SHIFT))
+#define LEVEL_ITEM_OPTION_HORDE_SHIFT 11
+#define LEVEL_ITEM_OPTION_HORDE_MASK  ((0x01<<LEVEL_ITEM_OPTION_HORDE_SHIFT))
+#define LEVEL_ITEM_OPTION_HORDE_NONE  ((0<<LEVEL_ITEM_OPTION_HORDE_SHIFT))
+#define LEVEL_ITEM_OPTION_HORDE_EXTRA ((1<<LEVEL_ITEM_OPTION_HORDE_SHIFT))
 #define LEVEL_ITEM_PLAYERSTARTPOINT     0x91
 #define LEVEL_ITEM_OPPONENTSTARTPOINT   0x92
 #define LEVEL_ITEM_ATTACKWAVES          0x93
@@ -152,6 +156,12 @@ typedef struct {
 /* Levels */
 extern const uint8_t LevelDrawings[] PROGMEM;
 extern const level_item_t LevelComponents[] PROGMEM;
+#ifdef LEVEL_INDEX
+/* Index of levels written by tools/levelcompiler.tcl. */
+extern const uint8_t LevelDrawingsCount PROGMEM;
+extern const uint16_t LevelDrawingsIndex[] PROGMEM;
+extern const uint16_t LevelComponentsIndex[] PROGMEM;
+#endif
 
 
 /* Start animation phases. */
@@ -205,10 +215,30 @@ extern uint16_t GameScreenAnimationPhase;
 extern uint16_t GameScreenOptions;
 extern void (*GameScreenUpdateFunction)(void);
 extern uint8_t Level;
+extern const uint8_t *LevelDrawing;
+extern const level_item_t *LevelComponentsBase;
 extern position_t GameScreenScorePosition;
 extern position_t GameScreenLevelPosition;
 
 
+/*
+ *  Ladders of current level. Squirted, wailed and cleaned pieces are counted from the bottom.
+ *  The ladders of a column are chained, starting at GameScreenLadderColumn[].
+ */
+#define SCREEN_LADDER_MAX 28
+#define SCREEN_LADDER_INVALID 0xff
+#define SCREEN_LADDER_COLUMNS 30 /* SCREEN_WIDTH */
+
+typedef struct {
+	uint8_t x, top, bottom;
+	uint8_t squirted, wailed, cleaned;
+	uint8_t next;
+} ladder_t;
+
+extern ladder_t GameScreenLadder[SCREEN_LADDER_MAX];
+extern uint8_t GameScreenLadderColumn[SCREEN_LADDER_COLUMNS];
+
+
 /* Games stats. */
 #define SCORE_STOMPED_TILE                1
 #define SCORE_COMPONENT_FALLING          10
@@ -237,7 +267,9 @@ static inline void ChangeGameScreen(uint8_t screen) {
 }
 
 
+void selectFlashLevel(uint8_t level);
 void selectLevel(uint8_t level);
+const level_item_t *getLevelComponentBlock(uint8_t b);
 void prepareLevelDescription(uint8_t sy);
 void prepareLevel(void);
 uint8_t animateBurgers(void);
@@ -247,6 +279,7 @@ void dropHattedComponents(void);
 uint8_t stomp(uint8_t x, uint8_t y);
 position_t getRandomBurgerComponentPosition();
 uint8_t checkFallingBurgerComponentPosition(uint8_t x, uint8_t y);
+uint8_t getLadder(uint8_t x, uint8_t y);
 void updateGameScreenStatistics(void);
 uint8_t decrementBonus(void);
 uint8_t decrementBonusFast(void);
@@ -26,6 +26,8 @@
 #include "pepper.h"
 #include "opponents.h"
 #include "patches.h"
+#include "levelpack.h"
+#include "statistics.h"
 
 
 /* Fixed strings. */
@@ -41,7 +43,10 @@ void initInGameDescriptionScreen(void) {
 	/* Draw level description picture. */
 	clearScreen();
 	drawFloor(0,20,SCREEN_WIDTH,DRAW_OPTION_FLOOR_FORCE_WRAP);
-	prepareLevelDescription(20);
+
+	/* Level description is drawn as soon the level is loaded from a level pack. */
+	if (!LevelLoading)
+		prepareLevelDescription(20);
 
 	/* Fade in.*/
 	FadeIn(1,0);
@@ -55,6 +60,10 @@ void initInGameDescriptionScreen(void) {
 }
 
 void updateInGameDescriptionScreen(void) {
+	/* Load level from level pack while the cook walks. Draw description when done. */
+	if (loadLevelChunk())
+		prepareLevelDescription(20);
+
 	/* Animate "Ready for Heat Up". */
 	if (GameScreenAnimationPhase & 8) {
 		drawStringCentered(8,TextHeatUp);
@@ -66,10 +75,10 @@ void updateInGameDescriptionScreen(void) {
 	if (!(GameScreenAnimationPhase & 63))
 		TriggerFx(PATCH_HEAT_UP,127,true);
 
-	/* Move cook until end position reached. */
+	/* Move cook until end position reached and level loaded. */
 	if (getSpriteTileX(Player.sprite,0) < DESCRIPTION_COOK_END_POSITION_X)
 		moveSprite(Player.sprite,1,0);
-	else
+	else if (!LevelLoading)
 		ChangeGameScreen(GAME_SCREEN_LEVEL_PREPARE);
 }
 
@@ -95,6 +104,9 @@ void initInGamePrepareScreen(void) {
 
 	/* Prepare level by description. */
 	prepareLevel();
+
+	/* Count a play of this level. */
+	beginLevelStatistics();
 }
 
 void updateInGamePrepareScreen(void) {
@@ -111,14 +123,11 @@ void updateInGamePrepareScreen(void) {
 }
 
 void cleanupInGamePrepareScreen(void) {
-	/* Reset sprites. */
+	/* Reset sprites. Cook and pepper are never multiplexed. Opponents occupy theirs when they appear. */
+	unmapOpponents();
 	resetSpriteSlots();
-	Player.sprite=occupySpriteSlot();
-	Pepper.sprite=occupySpriteSlot();
-	Opponent[0].sprite=occupySpriteSlot();
-	Opponent[1].sprite=occupySpriteSlot();
-	Opponent[2].sprite=occupySpriteSlot();
-	Opponent[3].sprite=occupySpriteSlot();
+	Player.sprite=occupySpriteSlot(SPRITE_PIECES_BLOCK,SPRITE_SLOT_PRIORITY);
+	Pepper.sprite=occupySpriteSlot(SPRITE_PIECES_SINGLE,SPRITE_SLOT_PRIORITY);
 
 	/* Reset opponent positions. */
 	resetOpponents();
@@ -180,11 +189,9 @@ void updateInGamePlayScreen(void) {
 		if (blink((GameScreenAnimationPhase)>>PLAYER_START_BLINKING_SHIFT,PLAYER_START_BLINKCODE)) {
 			/* Normal player. */
 			setSpriteTransparency(Player.sprite,0);
-			updateSprite(Player.sprite);
 		}	else {
 			/* Transparent player. */
 			setSpriteTransparency(Player.sprite,SPRITE_FLAGS_TRANSPARENT);
-			updateSprite(Player.sprite);
 		}
 	}
 
@@ -225,10 +232,15 @@ void updateInGamePlayScreen(void) {
 			selectOpponentDirection(i);
 			moveOpponent(i);
 
-			/* Change to lose screen when an opponent caught a player. */
-			if ((GameScreenAnimationPhase >= PLAYER_START_BLINKING_ENDED)
-				&& (checkIfOpponentCaughtPlayer(i) || checkIfPlayerIsHit()))
-				ChangeGameScreen(GAME_SCREEN_LEVEL_LOSE);
+			/* Change to lose screen when an opponent caught a player. Remember who it was. */
+			if (GameScreenAnimationPhase >= PLAYER_START_BLINKING_ENDED) {
+				if (checkIfOpponentCaughtPlayer(i)) {
+					setLevelStatisticsCause(getSpriteType(OpponentSprite[i]));
+					ChangeGameScreen(GAME_SCREEN_LEVEL_LOSE);
+				} else if (checkIfPlayerIsHit()) {
+					ChangeGameScreen(GAME_SCREEN_LEVEL_LOSE);
+				}
+			}
 
 		}
 	}
@@ -243,6 +255,9 @@ void updateInGamePlayScreen(void) {
 	if (decrementBonus())
 		ChangeGameScreen(GAME_SCREEN_LEVEL_LOSE);
 
+	/* Count time played. */
+	countLevelStatisticsFrame();
+
 	/* Check if we are at hurry moment. */
 	if (Bonus == HURRY_BONUS)
 		ChangeGameScreen(GAME_SCREEN_LEVEL_HURRY);
@@ -280,6 +295,9 @@ void cleanupInGameHurryScreen(void) {
 void initInGameBonusScreen(void) {
 	uint8_t i, p, start_positions=0;
 
+	/* Level cleared. */
+	endLevelStatistics(1);
+
 	/* Fast bonus counting. */
 	GameScreenOptions&=~LEVEL_ITEM_OPTION_BONUS_MASK;
 
@@ -307,7 +325,7 @@ void initInGameBonusScreen(void) {
 
 		/* Draw bonus item depending on opponent over roach. */
 		drawBonusItem(OpponentStartPosition[p].x-1,OpponentStartPosition[p].y-2,
-			((Opponent[i].flags & OPPONENT_FLAGS_ALGORITHM_MASK)>>OPPONENT_FLAGS_ALGORITHM_SHIFT)+1);
+			((OpponentFlags[i] & OPPONENT_FLAGS_ALGORITHM_MASK)>>OPPONENT_FLAGS_ALGORITHM_SHIFT)+1);
 
 		/* Kick opponent off-screen. */
 		kickOpponent(i);
@@ -447,6 +465,9 @@ void initInGameLoseScreen(void) {
 
 	/* Trigger hit sound. */
 	TriggerFx(PATCH_HIT_COOK,255,true);
+
+	/* Count death. */
+	countLevelStatisticsDeath();
 }
 
 void updateInGameLoseScreen(void) {
@@ -505,6 +526,9 @@ void initInGameOverScreen(void) {
 
 	/* Trigger game over sound. */
 	TriggerFx(PATCH_GAME_OVER,255,true);
+
+	/* Level left without clearing it. */
+	endLevelStatistics(0);
 }
 
 void updateInGameOverScreen(void) {
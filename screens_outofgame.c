@@ -21,6 +21,12 @@
 #define START_AT_LEVEL 1
 #endif
 
+/* Recorded demo input, see data/demo.in. */
+#include "data/demo.inc"
+#ifndef DEMO_INPUT
+#define DEMO_INPUT Demo
+#endif
+
 /* Local includes. */
 #include "screens.h"
 #include "draw.h"
@@ -29,6 +35,9 @@
 #include "highscores.h"
 #include "player.h"
 #include "sprites.h"
+#include "opponents.h"
+#include "pepper.h"
+#include "utils.h"
 
 
 /* Fixed strings. */
@@ -43,16 +52,26 @@ const char TextGameOver[] PROGMEM = "GAME OVER";
 const char TextGameOverOff[] PROGMEM = "         ";
 
 
+/* Random generator state from before the demo, the entropy gathered so far. */
+uint16_t DemoSavedRandomState;
+
+
+/* Reset game stats. */
+void resetGameStats(void) {
+	Score=0;
+	Bonus=0;
+	Lives=DEFAULT_LIVES;
+	Peppers=DEFAULT_PEPPERS;
+}
+
+
 /*
  *  The start screen is showed immediately after the game starts
  *  and in rotation with credits, demo and highscores.
  */
 void initStartScreen(void) {
 	/* Reset game stats. */
-	Score=0;
-	Bonus=0;
-	Lives=DEFAULT_LIVES;
-	Peppers=DEFAULT_PEPPERS;
+	resetGameStats();
 
 	/* Fade into clear screen */
 	clearScreen();
@@ -173,9 +192,9 @@ void updateHighscoresScreen(void) {
 			ChangeGameScreen(GAME_SCREEN_LEVEL_DESCRIPTION);
 			break;
 		default:
-			/* Switch to start screen after a while. */
+			/* Switch to demo after a while. */
 			if (GameScreenAnimationPhase>500)
-				ChangeGameScreen(GAME_SCREEN_START);
+				ChangeGameScreen(GAME_SCREEN_DEMO);
 	}
 }
 
@@ -185,6 +204,54 @@ void cleanupHighscoresScreen(void) {
 }
 
 
+/*
+ *  The demo screen is showed in rotation with start, credits and highscores.
+ *  It plays a level with recorded input on the in-game screens. The input
+ *  starts with the level and the random seed, low byte first, followed by
+ *  the runs of buttons played by the controllers.
+ */
+void initDemoScreen(void) {
+	/* Start as a new game would. */
+	resetGameStats();
+}
+
+void updateDemoScreen(void) {
+	const char *input=DEMO_INPUT;
+
+	/* Go to the level, with the random generator as it was recorded. */
+	selectLevel(pgm_read_byte(input));
+	DemoSavedRandomState=getRandomState();
+	seedRandom(pgm_read_byte(input+1)|(pgm_read_byte(input+2)<<8));
+	startControllerDemo(input+3);
+	ChangeGameScreen(GAME_SCREEN_LEVEL_DESCRIPTION);
+}
+
+void cleanupDemoScreen(void) {
+}
+
+/* Leave for the start screen when the demo ended or is about to leave the game. Called each frame. */
+void checkDemo(void) {
+	/* Skip if not playing. */
+	if (ControllerDemoState == CONTROLLER_DEMO_STATE_OFF)
+		return;
+
+	/* Still playing? */
+	if (ControllerDemoState == CONTROLLER_DEMO_STATE_PLAYING && !(GameScreen & GAME_SCREEN_OUTOFGAME))
+		return;
+
+	/* Take the level off. */
+	stopControllerDemo();
+	unmapOpponents();
+	if (Pepper.flags)
+		removePepper();
+	unmapSprite(Player.sprite);
+
+	/* Go on with the random generator state from before the demo. */
+	seedRandom(DemoSavedRandomState);
+	ChangeGameScreen(GAME_SCREEN_START);
+}
+
+
 /*
  *  The game over screen is shown after the in-game over screen.
  */
@@ -351,6 +418,8 @@ void cleanupNewHighscoreScreen(void) {
  *  The enter highscore screen is showed after the new highscore screen.
  */
 void initEnterHighscoreScreen(void) {
+	/* Forget buttons pressed before. */
+	flushControllerEvents();
 }
 
 void updateEnterHighscoreScreen(void) {
@@ -372,8 +441,8 @@ void updateEnterHighscoreScreen(void) {
 		return;
 	}
 
-	/* Otherwise check buttons. */
-	switch (checkControllerButtonsPressed(0,BTN_ALL)) {
+	/* Otherwise check buttons. Presses made while the cook moved are handled one by one. */
+	switch (getControllerButtonPressed(0,BTN_ALL)) {
 		case BTN_UP:
 			/* Roll through alphabet backwards. */
 			setTile(x,y,(((getTile(x,y)-1)-16) % 32)+FONT_ALPHA_TILE);
@@ -427,6 +496,10 @@ void cleanupEnterHighscoreScreen(void) {
 
 	/* Replace highscore in EEPROM. */
 	replaceHighscoreEntry(Scratchpad,name,Score);
+
+	/* Drop the presses this screen took from the event queue, so they don't start a game. */
+	checkControllerButtonsPressed(0,BTN_ALL);
+	flushControllerEvents();
 }
 
 
@@ -31,6 +31,7 @@ void cleanupCreditsScreen(void);
 void initDemoScreen(void);
 void updateDemoScreen(void);
 void cleanupDemoScreen(void);
+void checkDemo(void);
 
 void initHighscoresScreen(void);
 void updateHighscoresScreen(void);
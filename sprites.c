@@ -25,126 +25,274 @@
 #include "data/sprites.inc"
 
 
-/* Actual sprite tile data, generated by pcxtotiles.tcl tool */
+/* Actual sprite tile data, generated by pcxtotiles tool */
 #include "data/sprites0.inc"
 
+/* Image tile index to deduplicated tile index, mirror bit set for mirrored tiles. Identity if not deduplicated. */
+#ifndef SPRITE_TILE_REMAP
+#define SPRITE_TILE_REMAP(t) (t)
+#endif
+
+
+/* Kernel sprite descriptor, relative to megasprite position. */
+typedef struct {
+	uint8_t tile;
+	uint8_t flags;
+	int8_t x;
+	int8_t y;
+} sprite_piece_t;
+
+
+/* Megasprite animation, frames are ready to copy into the kernel sprites. */
+typedef struct {
+	const sprite_piece_t *frames;
+	uint8_t mask;
+	uint8_t pieces;
+} sprite_animation_t;
+
+
+/* Kernel sprite descriptors by tile, view, vertical flip and offset. A mirrored tile in a mirrored view isn't flipped. */
+#define SPRITE_TILE(t) ((SPRITE_TILE_REMAP((t) & (~SPRITE_MIRROR))^((t) & SPRITE_MIRROR)))
+#define SPRITE_PIECE(t,v,f,x,y) { (SPRITE_TILE(t) & (~SPRITE_MIRROR)), (((((SPRITE_TILE(t) & SPRITE_MIRROR)?1:0)^(v))?SPRITE_FLIP_X:0)|((f)*SPRITE_FLIP_Y)), (x), (y) }
+
+/* Animation frames made of 2x2, 1x2 and 1x1 kernel sprites. */
+#define SPRITE_FRAME_BLOCK(c,v,f) { \
+	SPRITE_PIECE(c ## _UPPER_LEFT,v,f,-((0^(v))?0:8)-SPRITE_BORDER_WIDTH,-8-((~0^((f)*2))&2)*4), \
+	SPRITE_PIECE(c ## _UPPER_RIGHT,v,f,-((1^(v))?0:8)-SPRITE_BORDER_WIDTH,-8-((~1^((f)*2))&2)*4), \
+	SPRITE_PIECE(c ## _LOWER_LEFT,v,f,-((0^(v))?0:8)-SPRITE_BORDER_WIDTH,-8-((~2^((f)*2))&2)*4), \
+	SPRITE_PIECE(c ## _LOWER_RIGHT,v,f,-((1^(v))?0:8)-SPRITE_BORDER_WIDTH,-8-((~3^((f)*2))&2)*4) }
+#define SPRITE_FRAME_TALLDUO(c,v) { \
+	SPRITE_PIECE(c ## _TOP,v,0,-4-SPRITE_BORDER_WIDTH,-16), \
+	SPRITE_PIECE(c ## _BOTTOM,v,0,-4-SPRITE_BORDER_WIDTH,-8) }
+#define SPRITE_FRAME_SINGLE(c,v) { \
+	SPRITE_PIECE(c ## _UPPER_LEFT,v,0,-4-SPRITE_BORDER_WIDTH,-16) }
+
+/* Animation by frame table. Frame counts have to be powers of two. */
+#define SPRITE_ANIMATION(frames) { &frames[0][0], sizeof(frames)/sizeof(frames[0])-1, sizeof(frames[0])/sizeof(sprite_piece_t) }
+
+/* Animation index by sprite type and direction. */
+#define SPRITE_ANIMATION_INDEX(flags) ((((flags)>>SPRITE_FLAGS_DIRECTION_SHIFT) & 0x07)|(((flags)>>(SPRITE_FLAGS_TYPE_SHIFT-3)) & 0x38))
+#define SPRITE_ANIMATION_INDEX_MAX 64
+
+/* Animations, numbered densely. The first is none. */
+#define SPRITE_ANIMATION_NONE                  0
+#define SPRITE_ANIMATION_COOK_SIDE_LEFT        1
+#define SPRITE_ANIMATION_COOK_SIDE_RIGHT       2
+#define SPRITE_ANIMATION_COOK_LADDER           3
+#define SPRITE_ANIMATION_COOK_CAUGHT           4
+#define SPRITE_ANIMATION_COOK_SLIDE            5
+#define SPRITE_ANIMATION_EGGHEAD_SIDE_LEFT     6
+#define SPRITE_ANIMATION_EGGHEAD_SIDE_RIGHT    7
+#define SPRITE_ANIMATION_EGGHEAD_LADDER        8
+#define SPRITE_ANIMATION_SAUSAGEMAN_SIDE_LEFT  9
+#define SPRITE_ANIMATION_SAUSAGEMAN_SIDE_RIGHT 10
+#define SPRITE_ANIMATION_SAUSAGEMAN_LADDER     11
+#define SPRITE_ANIMATION_MRMUSTARD_SIDE_LEFT   12
+#define SPRITE_ANIMATION_MRMUSTARD_SIDE_RIGHT  13
+#define SPRITE_ANIMATION_MRMUSTARD_SQUIRT      14
+#define SPRITE_ANIMATION_PEPPER_LEFT           15
+#define SPRITE_ANIMATION_PEPPER_RIGHT          16
+#define SPRITE_ANIMATIONS_MAX                  17
 
-/* Transparent sprite. */
-const uint8_t SpriteTransparent[1][4] PROGMEM = {
-	TILES_BLOCK(TILES2_TRANSPARENT)
+
+/* Megasprite animations. */
+const sprite_piece_t SpriteFramesCookSideLeft[4][4] PROGMEM = {
+	SPRITE_FRAME_BLOCK(TILES2_COOK_SIDE_ANIMATE0,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_COOK_SIDE_ANIMATE1,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_COOK_SIDE_ANIMATE2,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_COOK_SIDE_ANIMATE3,0,0),
 };
 
+const sprite_piece_t SpriteFramesCookSideRight[4][4] PROGMEM = {
+	SPRITE_FRAME_BLOCK(TILES2_COOK_SIDE_ANIMATE0,1,0),
+	SPRITE_FRAME_BLOCK(TILES2_COOK_SIDE_ANIMATE1,1,0),
+	SPRITE_FRAME_BLOCK(TILES2_COOK_SIDE_ANIMATE2,1,0),
+	SPRITE_FRAME_BLOCK(TILES2_COOK_SIDE_ANIMATE3,1,0),
+};
 
-/* Pepper sprite. */
-const uint8_t SpritePepper[1][4] PROGMEM = {
-	TILES_BLOCK(TILES2_PEPPER)
+
+const sprite_piece_t SpriteFramesCookLadder[8][4] PROGMEM = {
+	SPRITE_FRAME_BLOCK(TILES2_COOK_LADDER_ANIMATE0,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_COOK_LADDER_ANIMATE1,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_COOK_LADDER_ANIMATE2,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_COOK_LADDER_ANIMATE3,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_COOK_LADDER_ANIMATE4,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_COOK_LADDER_ANIMATE5,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_COOK_LADDER_ANIMATE6,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_COOK_LADDER_ANIMATE7,0,0),
 };
 
 
-/* Megasprite animations. */
-#define SPRITE_ANIMATION_COOK_SIDE_MAX 4
-const uint8_t SpriteAnimationCookSide[SPRITE_ANIMATION_COOK_SIDE_MAX][4] PROGMEM = {
-	TILES_BLOCK(TILES2_COOK_SIDE_ANIMATE0),
-	TILES_BLOCK(TILES2_COOK_SIDE_ANIMATE1),
-	TILES_BLOCK(TILES2_COOK_SIDE_ANIMATE2),
-	TILES_BLOCK(TILES2_COOK_SIDE_ANIMATE3),
+/* Caught cook is flipped vertically. */
+const sprite_piece_t SpriteFramesCookCaught[4][4] PROGMEM = {
+	SPRITE_FRAME_BLOCK(TILES2_COOK_FACING_ANIMATE0,0,1),
+	SPRITE_FRAME_BLOCK(TILES2_COOK_FACING_ANIMATE1,0,1),
+	SPRITE_FRAME_BLOCK(TILES2_COOK_FACING_ANIMATE2,0,1),
+	SPRITE_FRAME_BLOCK(TILES2_COOK_FACING_ANIMATE3,0,1),
+};
+
+
+const sprite_piece_t SpriteFramesCookSlide[1][4] PROGMEM = {
+	SPRITE_FRAME_BLOCK(TILES2_COOK_LADDER_ANIMATE0,0,0),
+};
+
+
+const sprite_piece_t SpriteFramesEggheadSideLeft[4][4] PROGMEM = {
+	SPRITE_FRAME_BLOCK(TILES2_EGGHEAD_SIDE_ANIMATE0,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_EGGHEAD_SIDE_ANIMATE1,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_EGGHEAD_SIDE_ANIMATE2,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_EGGHEAD_SIDE_ANIMATE3,0,0),
+};
+
+const sprite_piece_t SpriteFramesEggheadSideRight[4][4] PROGMEM = {
+	SPRITE_FRAME_BLOCK(TILES2_EGGHEAD_SIDE_ANIMATE0,1,0),
+	SPRITE_FRAME_BLOCK(TILES2_EGGHEAD_SIDE_ANIMATE1,1,0),
+	SPRITE_FRAME_BLOCK(TILES2_EGGHEAD_SIDE_ANIMATE2,1,0),
+	SPRITE_FRAME_BLOCK(TILES2_EGGHEAD_SIDE_ANIMATE3,1,0),
 };
 
 
-#define SPRITE_ANIMATION_COOK_LADDER_MAX 8
-const uint8_t SpriteAnimationCookLadder[SPRITE_ANIMATION_COOK_LADDER_MAX][4] PROGMEM = {
-	TILES_BLOCK(TILES2_COOK_LADDER_ANIMATE0),
-	TILES_BLOCK(TILES2_COOK_LADDER_ANIMATE1),
-	TILES_BLOCK(TILES2_COOK_LADDER_ANIMATE2),
-	TILES_BLOCK(TILES2_COOK_LADDER_ANIMATE3),
-	TILES_BLOCK(TILES2_COOK_LADDER_ANIMATE4),
-	TILES_BLOCK(TILES2_COOK_LADDER_ANIMATE5),
-	TILES_BLOCK(TILES2_COOK_LADDER_ANIMATE6),
-	TILES_BLOCK(TILES2_COOK_LADDER_ANIMATE7),
+const sprite_piece_t SpriteFramesEggheadLadder[4][4] PROGMEM = {
+	SPRITE_FRAME_BLOCK(TILES2_EGGHEAD_LADDER_ANIMATE0,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_EGGHEAD_LADDER_ANIMATE1,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_EGGHEAD_LADDER_ANIMATE2,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_EGGHEAD_LADDER_ANIMATE3,0,0),
 };
 
 
-#define SPRITE_ANIMATION_COOK_CAUGHT_MAX 4
-const uint8_t SpriteAnimationCookCaught[SPRITE_ANIMATION_COOK_CAUGHT_MAX][4] PROGMEM = {
-	TILES_BLOCK(TILES2_COOK_FACING_ANIMATE0),
-	TILES_BLOCK(TILES2_COOK_FACING_ANIMATE1),
-	TILES_BLOCK(TILES2_COOK_FACING_ANIMATE2),
-	TILES_BLOCK(TILES2_COOK_FACING_ANIMATE3),
+const sprite_piece_t SpriteFramesSausagemanSideLeft[8][4] PROGMEM = {
+	SPRITE_FRAME_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE0,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE1,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE2,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE3,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE4,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE5,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE6,0,0),
+	SPRITE_FRAME_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE7,0,0),
+};
+
+const sprite_piece_t SpriteFramesSausagemanSideRight[8][4] PROGMEM = {
+	SPRITE_FRAME_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE0,1,0),
+	SPRITE_FRAME_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE1,1,0),
+	SPRITE_FRAME_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE2,1,0),
+	SPRITE_FRAME_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE3,1,0),
+	SPRITE_FRAME_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE4,1,0),
+	SPRITE_FRAME_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE5,1,0),
+	SPRITE_FRAME_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE6,1,0),
+	SPRITE_FRAME_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE7,1,0),
 };
 
 
-#define SPRITE_ANIMATION_COOK_SLIDE_MAX 1
-const uint8_t SpriteAnimationCookSlide[SPRITE_ANIMATION_COOK_SLIDE_MAX][4] PROGMEM = {
-	TILES_BLOCK(TILES2_COOK_LADDER_ANIMATE0),
+const sprite_piece_t SpriteFramesSausagemanLadder[4][2] PROGMEM = {
+	SPRITE_FRAME_TALLDUO(TILES2_SAUSAGEMAN_LADDER_ANIMATE0,0),
+	SPRITE_FRAME_TALLDUO(TILES2_SAUSAGEMAN_LADDER_ANIMATE0,0),
+	SPRITE_FRAME_TALLDUO(TILES2_SAUSAGEMAN_LADDER_ANIMATE1,0),
+	SPRITE_FRAME_TALLDUO(TILES2_SAUSAGEMAN_LADDER_ANIMATE1,0),
 };
 
 
-#define SPRITE_ANIMATION_EGGHEAD_SIDE_MAX 4
-const uint8_t SpriteAnimationEggheadSide[SPRITE_ANIMATION_EGGHEAD_SIDE_MAX][4] PROGMEM = {
-	TILES_BLOCK(TILES2_EGGHEAD_SIDE_ANIMATE0),
-	TILES_BLOCK(TILES2_EGGHEAD_SIDE_ANIMATE1),
-	TILES_BLOCK(TILES2_EGGHEAD_SIDE_ANIMATE2),
-	TILES_BLOCK(TILES2_EGGHEAD_SIDE_ANIMATE3),
+const sprite_piece_t SpriteFramesMrMustardSideLeft[4][2] PROGMEM = {
+	SPRITE_FRAME_TALLDUO(TILES2_MRMUSTARD_SIDE_ANIMATE0,0),
+	SPRITE_FRAME_TALLDUO(TILES2_MRMUSTARD_SIDE_ANIMATE1,0),
+	SPRITE_FRAME_TALLDUO(TILES2_MRMUSTARD_SIDE_ANIMATE2,0),
+	SPRITE_FRAME_TALLDUO(TILES2_MRMUSTARD_SIDE_ANIMATE3,0),
+};
+
+const sprite_piece_t SpriteFramesMrMustardSideRight[4][2] PROGMEM = {
+	SPRITE_FRAME_TALLDUO(TILES2_MRMUSTARD_SIDE_ANIMATE0,1),
+	SPRITE_FRAME_TALLDUO(TILES2_MRMUSTARD_SIDE_ANIMATE1,1),
+	SPRITE_FRAME_TALLDUO(TILES2_MRMUSTARD_SIDE_ANIMATE2,1),
+	SPRITE_FRAME_TALLDUO(TILES2_MRMUSTARD_SIDE_ANIMATE3,1),
 };
 
 
-#define SPRITE_ANIMATION_EGGHEAD_LADDER_MAX 4
-const uint8_t SpriteAnimationEggheadLadder[SPRITE_ANIMATION_EGGHEAD_LADDER_MAX][4] PROGMEM = {
-	TILES_BLOCK(TILES2_EGGHEAD_LADDER_ANIMATE0),
-	TILES_BLOCK(TILES2_EGGHEAD_LADDER_ANIMATE1),
-	TILES_BLOCK(TILES2_EGGHEAD_LADDER_ANIMATE2),
-	TILES_BLOCK(TILES2_EGGHEAD_LADDER_ANIMATE3),
+/* Seven squirt frames, padded to eight as the animation step wraps to the first. */
+const sprite_piece_t SpriteFramesMrMustardSquirt[8][2] PROGMEM = {
+	SPRITE_FRAME_TALLDUO(TILES2_MRMUSTARD_SQUIRT_ANIMATE0,0),
+	SPRITE_FRAME_TALLDUO(TILES2_MRMUSTARD_SQUIRT_ANIMATE1,0),
+	SPRITE_FRAME_TALLDUO(TILES2_MRMUSTARD_SQUIRT_ANIMATE2,0),
+	SPRITE_FRAME_TALLDUO(TILES2_MRMUSTARD_SQUIRT_ANIMATE3,0),
+	SPRITE_FRAME_TALLDUO(TILES2_MRMUSTARD_SQUIRT_ANIMATE4,0),
+	SPRITE_FRAME_TALLDUO(TILES2_MRMUSTARD_SQUIRT_ANIMATE5,0),
+	SPRITE_FRAME_TALLDUO(TILES2_MRMUSTARD_SQUIRT_ANIMATE6,0),
+	SPRITE_FRAME_TALLDUO(TILES2_MRMUSTARD_SQUIRT_ANIMATE0,0),
 };
 
 
-#define SPRITE_ANIMATION_SAUSAGEMAN_SIDE_MAX 8
-const uint8_t SpriteAnimationSausagemanSide[SPRITE_ANIMATION_SAUSAGEMAN_SIDE_MAX][4] PROGMEM = {
-	TILES_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE0),
-	TILES_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE1),
-	TILES_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE2),
-	TILES_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE3),
-	TILES_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE4),
-	TILES_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE5),
-	TILES_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE6),
-	TILES_BLOCK(TILES2_SAUSAGEMAN_SIDE_ANIMATE7),
+const sprite_piece_t SpriteFramesPepperLeft[1][1] PROGMEM = {
+	SPRITE_FRAME_SINGLE(TILES2_PEPPER,0),
 };
 
-#define SPRITE_ANIMATION_SAUSAGEMAN_LADDER_MAX 4
-const uint8_t SpriteAnimationSausagemanLadder[SPRITE_ANIMATION_SAUSAGEMAN_LADDER_MAX][2] PROGMEM = {
-	TILES_TALLDUO(TILES2_SAUSAGEMAN_LADDER_ANIMATE0),
-	TILES_TALLDUO(TILES2_SAUSAGEMAN_LADDER_ANIMATE0),
-	TILES_TALLDUO(TILES2_SAUSAGEMAN_LADDER_ANIMATE1),
-	TILES_TALLDUO(TILES2_SAUSAGEMAN_LADDER_ANIMATE1),
+const sprite_piece_t SpriteFramesPepperRight[1][1] PROGMEM = {
+	SPRITE_FRAME_SINGLE(TILES2_PEPPER,1),
 };
 
 
-#define SPRITE_ANIMATION_MRMUSTARD_SIDE_MAX 4
-const uint8_t SpriteAnimationMrMustardSide[SPRITE_ANIMATION_MRMUSTARD_SIDE_MAX][2] PROGMEM = {
-	TILES_TALLDUO(TILES2_MRMUSTARD_SIDE_ANIMATE0),
-	TILES_TALLDUO(TILES2_MRMUSTARD_SIDE_ANIMATE1),
-	TILES_TALLDUO(TILES2_MRMUSTARD_SIDE_ANIMATE2),
-	TILES_TALLDUO(TILES2_MRMUSTARD_SIDE_ANIMATE3),
+/* Animations. */
+const sprite_animation_t SpriteAnimations[SPRITE_ANIMATIONS_MAX] PROGMEM = {
+	[SPRITE_ANIMATION_COOK_SIDE_LEFT]        = SPRITE_ANIMATION(SpriteFramesCookSideLeft),
+	[SPRITE_ANIMATION_COOK_SIDE_RIGHT]       = SPRITE_ANIMATION(SpriteFramesCookSideRight),
+	[SPRITE_ANIMATION_COOK_LADDER]           = SPRITE_ANIMATION(SpriteFramesCookLadder),
+	[SPRITE_ANIMATION_COOK_CAUGHT]           = SPRITE_ANIMATION(SpriteFramesCookCaught),
+	[SPRITE_ANIMATION_COOK_SLIDE]            = SPRITE_ANIMATION(SpriteFramesCookSlide),
+	[SPRITE_ANIMATION_EGGHEAD_SIDE_LEFT]     = SPRITE_ANIMATION(SpriteFramesEggheadSideLeft),
+	[SPRITE_ANIMATION_EGGHEAD_SIDE_RIGHT]    = SPRITE_ANIMATION(SpriteFramesEggheadSideRight),
+	[SPRITE_ANIMATION_EGGHEAD_LADDER]        = SPRITE_ANIMATION(SpriteFramesEggheadLadder),
+	[SPRITE_ANIMATION_SAUSAGEMAN_SIDE_LEFT]  = SPRITE_ANIMATION(SpriteFramesSausagemanSideLeft),
+	[SPRITE_ANIMATION_SAUSAGEMAN_SIDE_RIGHT] = SPRITE_ANIMATION(SpriteFramesSausagemanSideRight),
+	[SPRITE_ANIMATION_SAUSAGEMAN_LADDER]     = SPRITE_ANIMATION(SpriteFramesSausagemanLadder),
+	[SPRITE_ANIMATION_MRMUSTARD_SIDE_LEFT]   = SPRITE_ANIMATION(SpriteFramesMrMustardSideLeft),
+	[SPRITE_ANIMATION_MRMUSTARD_SIDE_RIGHT]  = SPRITE_ANIMATION(SpriteFramesMrMustardSideRight),
+	[SPRITE_ANIMATION_MRMUSTARD_SQUIRT]      = SPRITE_ANIMATION(SpriteFramesMrMustardSquirt),
+	[SPRITE_ANIMATION_PEPPER_LEFT]           = SPRITE_ANIMATION(SpriteFramesPepperLeft),
+	[SPRITE_ANIMATION_PEPPER_RIGHT]          = SPRITE_ANIMATION(SpriteFramesPepperRight),
 };
 
 
-#define SPRITE_ANIMATION_MRMUSTARD_SQUIRT_MAX 7
-const uint8_t SpriteAnimationMrMustardSquirt[SPRITE_ANIMATION_MRMUSTARD_SQUIRT_MAX][2] PROGMEM = {
-	TILES_TALLDUO(TILES2_MRMUSTARD_SQUIRT_ANIMATE0),
-	TILES_TALLDUO(TILES2_MRMUSTARD_SQUIRT_ANIMATE1),
-	TILES_TALLDUO(TILES2_MRMUSTARD_SQUIRT_ANIMATE2),
-	TILES_TALLDUO(TILES2_MRMUSTARD_SQUIRT_ANIMATE3),
-	TILES_TALLDUO(TILES2_MRMUSTARD_SQUIRT_ANIMATE4),
-	TILES_TALLDUO(TILES2_MRMUSTARD_SQUIRT_ANIMATE5),
-	TILES_TALLDUO(TILES2_MRMUSTARD_SQUIRT_ANIMATE6),
+/* Animation by sprite type and direction. Anticook looks the other way. */
+const uint8_t SpriteAnimationIndex[SPRITE_ANIMATION_INDEX_MAX] PROGMEM = {
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_COOK|SPRITE_FLAGS_DIRECTION_LEFT)]         = SPRITE_ANIMATION_COOK_SIDE_LEFT,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_COOK|SPRITE_FLAGS_DIRECTION_RIGHT)]        = SPRITE_ANIMATION_COOK_SIDE_RIGHT,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_COOK|SPRITE_FLAGS_DIRECTION_LADDER)]       = SPRITE_ANIMATION_COOK_LADDER,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_COOK|SPRITE_FLAGS_DIRECTION_CAUGHT)]       = SPRITE_ANIMATION_COOK_CAUGHT,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_COOK|SPRITE_FLAGS_DIRECTION_SLIDE)]        = SPRITE_ANIMATION_COOK_SLIDE,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_ANTICOOK|SPRITE_FLAGS_DIRECTION_LEFT)]     = SPRITE_ANIMATION_COOK_SIDE_RIGHT,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_ANTICOOK|SPRITE_FLAGS_DIRECTION_RIGHT)]    = SPRITE_ANIMATION_COOK_SIDE_LEFT,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_ANTICOOK|SPRITE_FLAGS_DIRECTION_LADDER)]   = SPRITE_ANIMATION_COOK_LADDER,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_ANTICOOK|SPRITE_FLAGS_DIRECTION_SLIDE)]    = SPRITE_ANIMATION_COOK_SLIDE,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_EGGHEAD|SPRITE_FLAGS_DIRECTION_LEFT)]      = SPRITE_ANIMATION_EGGHEAD_SIDE_LEFT,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_EGGHEAD|SPRITE_FLAGS_DIRECTION_RIGHT)]     = SPRITE_ANIMATION_EGGHEAD_SIDE_RIGHT,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_EGGHEAD|SPRITE_FLAGS_DIRECTION_LADDER)]    = SPRITE_ANIMATION_EGGHEAD_LADDER,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_SAUSAGEMAN|SPRITE_FLAGS_DIRECTION_LEFT)]   = SPRITE_ANIMATION_SAUSAGEMAN_SIDE_LEFT,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_SAUSAGEMAN|SPRITE_FLAGS_DIRECTION_RIGHT)]  = SPRITE_ANIMATION_SAUSAGEMAN_SIDE_RIGHT,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_SAUSAGEMAN|SPRITE_FLAGS_DIRECTION_LADDER)] = SPRITE_ANIMATION_SAUSAGEMAN_LADDER,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_MRMUSTARD|SPRITE_FLAGS_DIRECTION_LEFT)]    = SPRITE_ANIMATION_MRMUSTARD_SIDE_LEFT,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_MRMUSTARD|SPRITE_FLAGS_DIRECTION_RIGHT)]   = SPRITE_ANIMATION_MRMUSTARD_SIDE_RIGHT,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_MRMUSTARD|SPRITE_FLAGS_DIRECTION_LADDER)]  = SPRITE_ANIMATION_MRMUSTARD_SIDE_LEFT,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_MRMUSTARD|SPRITE_FLAGS_DIRECTION_SQUIRT)]  = SPRITE_ANIMATION_MRMUSTARD_SQUIRT,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_PEPPER|SPRITE_FLAGS_DIRECTION_LEFT)]       = SPRITE_ANIMATION_PEPPER_LEFT,
+	[SPRITE_ANIMATION_INDEX(SPRITE_FLAGS_TYPE_PEPPER|SPRITE_FLAGS_DIRECTION_RIGHT)]      = SPRITE_ANIMATION_PEPPER_RIGHT,
 };
 
 
-/* Megasprite slots. */
-struct {
-	uint8_t x;
-	int16_t y;
-	uint16_t flags;
-} GameSpriteSlots[SPRITE_SLOTS_MAX];
+/* Megasprite slots, one array per attribute. */
+uint8_t GameSpriteSlotX[SPRITE_SLOTS_MAX];
+uint8_t GameSpriteSlotY[SPRITE_SLOTS_MAX];
+uint16_t GameSpriteSlotFlags[SPRITE_SLOTS_MAX];
+uint8_t GameSpriteSlotBase[SPRITE_SLOTS_MAX];
+uint8_t GameSpriteSlotPieces[SPRITE_SLOTS_MAX];
+
+/* Kernel sprites in use by occupied slots, and the RAM tiles they take at worst. */
+uint32_t GameSpritesOccupied;
+uint8_t GameSpriteRamTilesWorst;
+
+/* Slots always drawn when multiplexing, and the first other slot to draw. */
+uint16_t GameSpriteSlotsPriority;
+uint8_t GameSpriteMultiplexOffset;
+
+
+/* Megasprite slots with changes not yet committed to the kernel sprites. */
+uint16_t GameSpriteSlotsDirty;
 
 
 /* Reset sprite slots. */
@@ -152,24 +300,62 @@ void resetSpriteSlots(void) {
 	uint8_t i;
 
 	for(i=0;i<SPRITE_SLOTS_MAX;i++)
-		GameSpriteSlots[i].flags=SPRITE_FLAGS_FREE_SLOT;
+		GameSpriteSlotFlags[i]=SPRITE_FLAGS_FREE_SLOT;
+
+	/* All kernel sprites off screen and available, as well as RAM tiles. */
+	for(i=0;i<MAX_SPRITES;i++)
+		sprites[i].x=OFF_SCREEN;
+	GameSpritesOccupied=0;
+	GameSpriteRamTilesWorst=0;
+	GameSpriteSlotsPriority=0;
+	GameSpriteMultiplexOffset=0;
+
+	/* Nothing to commit. */
+	GameSpriteSlotsDirty=0;
 }
 
 
-/* Occupy a sprite slot. */
-uint8_t occupySpriteSlot(void) {
-	uint8_t i;
+/*
+ *  Occupy a sprite slot with the given number of kernel sprites. Fails only
+ *  if there are no kernel sprites left, running out of RAM tiles is left
+ *  to the multiplexer. Priority slots are never multiplexed.
+ */
+uint8_t occupySpriteSlot(uint8_t pieces, uint8_t priority) {
+	uint8_t i, k, b;
+	uint32_t m;
 
 	/* Get a free sprite slot. */
 	for(i=0;i<SPRITE_SLOTS_MAX;i++)
-		if (GameSpriteSlots[i].flags == SPRITE_FLAGS_FREE_SLOT) break;
-
-	/* Occupy free slot. */
-	if (i<SPRITE_SLOTS_MAX)
-		GameSpriteSlots[i].flags=SPRITE_FLAGS_OCCUPIED_SLOT;
+		if (GameSpriteSlotFlags[i] == SPRITE_FLAGS_FREE_SLOT) break;
+
+	/* Fail if there is none. */
+	if (i==SPRITE_SLOTS_MAX)
+		return SPRITE_SLOTS_FULL;
+
+	/*
+	 *  Get free kernel sprites, aligned to their number.
+	 *  Blocks are taken from the start, smaller ones from the end, to keep fragmentation low.
+	 */
+	for (k=0;k<MAX_SPRITES/pieces;k++) {
+		b=(pieces == SPRITE_PIECES_BLOCK)?(k*pieces):(MAX_SPRITES-(k+1)*pieces);
+		m=((1UL<<pieces)-1)<<b;
+		if (!(GameSpritesOccupied & m)) {
+			/* Occupy free slot and kernel sprites. */
+			GameSpritesOccupied|=m;
+			GameSpriteRamTilesWorst+=SPRITE_RAM_TILES_WORST(pieces);
+			GameSpriteSlotBase[i]=b;
+			GameSpriteSlotPieces[i]=pieces;
+			GameSpriteSlotFlags[i]=SPRITE_FLAGS_OCCUPIED_SLOT;
+			if (priority)
+				GameSpriteSlotsPriority|=(1<<i);
+
+			/* Return slot number. */
+			return i;
+		}
+	}
 
-	/* Return slot number or full marker. */
-	return i;
+	/* No kernel sprites left. */
+	return SPRITE_SLOTS_FULL;
 }
 
 
@@ -177,190 +363,163 @@ uint8_t occupySpriteSlot(void) {
 void unmapSprite(uint8_t slot) {
 	uint8_t i;
 
+	/* Skip invalid slot. */
+	if (slot >= SPRITE_SLOTS_MAX) return;
+
+	/* Drop any pending update, it would map the sprite again. */
+	GameSpriteSlotsDirty&=~(1<<slot);
+
 	/* Unmap kernel sprites for that slot. */
-	for(i=0;i<4;i++)
-		sprites[slot*4+i].x=OFF_SCREEN; /* invalid coordinate */
+	for(i=0;i<GameSpriteSlotPieces[slot];i++)
+		sprites[GameSpriteSlotBase[slot]+i].x=OFF_SCREEN; /* invalid coordinate */
 }
 
 
 /* Free a sprite slot. */
 void freeSpriteSlot(uint8_t slot) {
-	/* Skip if the slot is free already. */
-	if (GameSpriteSlots[slot].flags == SPRITE_FLAGS_FREE_SLOT) return;
+	/* Skip if the slot is invalid or free already. */
+	if ((slot >= SPRITE_SLOTS_MAX) || (GameSpriteSlotFlags[slot] == SPRITE_FLAGS_FREE_SLOT)) return;
 
 	/* Unmap sprite. */
 	unmapSprite(slot);
 
+	/* Release its kernel sprites and RAM tiles. */
+	GameSpritesOccupied&=~(((1UL<<GameSpriteSlotPieces[slot])-1)<<GameSpriteSlotBase[slot]);
+	GameSpriteRamTilesWorst-=SPRITE_RAM_TILES_WORST(GameSpriteSlotPieces[slot]);
+
 	/* Free the slot. */
-	GameSpriteSlots[slot].flags=SPRITE_FLAGS_FREE_SLOT;
+	GameSpriteSlotsPriority&=~(1<<slot);
+	GameSpriteSlotFlags[slot]=SPRITE_FLAGS_FREE_SLOT;
+}
+
+
+/* Update kernel sprites for a megasprite slot. */
+static void updateSprite(uint8_t slot) {
+	uint8_t i, j, n;
+	const sprite_animation_t *a;
+	const sprite_piece_t *p;
+
+	/* Get animation for sprite type and direction. Skip if there is none. */
+	a=&SpriteAnimations[pgm_read_byte(&SpriteAnimationIndex[SPRITE_ANIMATION_INDEX(GameSpriteSlotFlags[slot])])];
+	n=pgm_read_byte(&a->pieces);
+	if (!n) return;
+
+	/* Get descriptors of current animation frame. */
+	p=(const sprite_piece_t *)pgm_read_word(&a->frames)+(((GameSpriteSlotFlags[slot] & SPRITE_FLAGS_ANIMATION_MASK)>>1) & pgm_read_byte(&a->mask))*n;
+
+	/* Never exceed the kernel sprites occupied by the slot. */
+	if (n>GameSpriteSlotPieces[slot])
+		n=GameSpriteSlotPieces[slot];
+
+	/* Copy descriptors into kernel sprites, add position. Transparent sprites use the transparent tile. */
+	i=GameSpriteSlotBase[slot];
+	for (j=0;j<n;j++) {
+		sprites[i].tileIndex=(GameSpriteSlotFlags[slot] & SPRITE_FLAGS_TRANSPARENT)?(SPRITE_TILE(TILES2_TRANSPARENT_UPPER_LEFT) & (~SPRITE_MIRROR)):pgm_read_byte(&p->tile);
+		sprites[i].flags=pgm_read_byte(&p->flags);
+		sprites[i].x=GameSpriteSlotX[slot]+(int8_t)pgm_read_byte(&p->x);
+		sprites[i].y=GameSpriteSlotY[slot]+(int8_t)pgm_read_byte(&p->y);
+		p++;
+		i++;
+	}
+
+	/* Remove unneeded sprite tiles from screen. */
+	for (;j<GameSpriteSlotPieces[slot];j++) {
+		sprites[i].x=OFF_SCREEN;
+		i++;
+	}
 }
 
 
-/* Update sprite on screen. */
-void updateSprite(uint8_t slot) {
-	uint8_t tile, i, j, view_right, flip_y;
-	const uint8_t *p;
+/* Get RAM tiles needed by a megasprite at its current position. */
+uint8_t getSpriteRamTiles(uint8_t slot) {
+	uint8_t n, b, i;
 
-	/* Setup kernel sprite shape according to flags. */
-	if (GameSpriteSlots[slot].flags & SPRITE_FLAGS_TRANSPARENT) {
-		/* Transparent sprite. */
-		p=&SpriteTransparent[0][0];
-	} else {
-		/* Non-transparent sprite. */
-		switch (GameSpriteSlots[slot].flags & (SPRITE_FLAGS_TYPE_MASK|SPRITE_FLAGS_DIRECTION_MASK)) {
-			case SPRITE_FLAGS_TYPE_COOK|SPRITE_FLAGS_DIRECTION_LEFT:
-			case SPRITE_FLAGS_TYPE_COOK|SPRITE_FLAGS_DIRECTION_RIGHT:
-			case SPRITE_FLAGS_TYPE_ANTICOOK|SPRITE_FLAGS_DIRECTION_LEFT:
-			case SPRITE_FLAGS_TYPE_ANTICOOK|SPRITE_FLAGS_DIRECTION_RIGHT:
-				p=&SpriteAnimationCookSide[((GameSpriteSlots[slot].flags & SPRITE_FLAGS_ANIMATION_MASK)>>1) % SPRITE_ANIMATION_COOK_SIDE_MAX][0];
-				break;
-			case SPRITE_FLAGS_TYPE_COOK|SPRITE_FLAGS_DIRECTION_LADDER:
-			case SPRITE_FLAGS_TYPE_ANTICOOK|SPRITE_FLAGS_DIRECTION_LADDER:
-				p=&SpriteAnimationCookLadder[((GameSpriteSlots[slot].flags & SPRITE_FLAGS_ANIMATION_MASK)>>1) % SPRITE_ANIMATION_COOK_LADDER_MAX][0];
-				break;
-			case SPRITE_FLAGS_TYPE_COOK|SPRITE_FLAGS_DIRECTION_CAUGHT:
-			case SPRITE_FLAGS_TYPE_ANTICOOK|SPRITE_FLAGS_DIRECTION_CAUGHT:
-				p=&SpriteAnimationCookCaught[((GameSpriteSlots[slot].flags & SPRITE_FLAGS_ANIMATION_MASK)>>1) % SPRITE_ANIMATION_COOK_CAUGHT_MAX][0];
-				break;
-			case SPRITE_FLAGS_TYPE_COOK|SPRITE_FLAGS_DIRECTION_SLIDE:
-			case SPRITE_FLAGS_TYPE_ANTICOOK|SPRITE_FLAGS_DIRECTION_SLIDE:
-				p=&SpriteAnimationCookSlide[((GameSpriteSlots[slot].flags & SPRITE_FLAGS_ANIMATION_MASK)>>1) % SPRITE_ANIMATION_COOK_SLIDE_MAX][0];
-				break;
-			case SPRITE_FLAGS_TYPE_EGGHEAD|SPRITE_FLAGS_DIRECTION_LEFT:
-			case SPRITE_FLAGS_TYPE_EGGHEAD|SPRITE_FLAGS_DIRECTION_RIGHT:
-				p=&SpriteAnimationEggheadSide[((GameSpriteSlots[slot].flags & SPRITE_FLAGS_ANIMATION_MASK)>>1) % SPRITE_ANIMATION_EGGHEAD_SIDE_MAX][0];
-				break;
-			case SPRITE_FLAGS_TYPE_EGGHEAD|SPRITE_FLAGS_DIRECTION_LADDER:
-				p=&SpriteAnimationEggheadLadder[((GameSpriteSlots[slot].flags & SPRITE_FLAGS_ANIMATION_MASK)>>1) % SPRITE_ANIMATION_EGGHEAD_LADDER_MAX][0];
-				break;
-			case SPRITE_FLAGS_TYPE_SAUSAGEMAN|SPRITE_FLAGS_DIRECTION_LEFT:
-			case SPRITE_FLAGS_TYPE_SAUSAGEMAN|SPRITE_FLAGS_DIRECTION_RIGHT:
-				p=&SpriteAnimationSausagemanSide[((GameSpriteSlots[slot].flags & SPRITE_FLAGS_ANIMATION_MASK)>>1) % SPRITE_ANIMATION_SAUSAGEMAN_SIDE_MAX][0];
-				break;
-			case SPRITE_FLAGS_TYPE_SAUSAGEMAN|SPRITE_FLAGS_DIRECTION_LADDER:
-				p=&SpriteAnimationSausagemanLadder[((GameSpriteSlots[slot].flags & SPRITE_FLAGS_ANIMATION_MASK)>>1) % SPRITE_ANIMATION_SAUSAGEMAN_LADDER_MAX][0];
-				break;
-			case SPRITE_FLAGS_TYPE_MRMUSTARD|SPRITE_FLAGS_DIRECTION_LEFT:
-			case SPRITE_FLAGS_TYPE_MRMUSTARD|SPRITE_FLAGS_DIRECTION_RIGHT:
-			case SPRITE_FLAGS_TYPE_MRMUSTARD|SPRITE_FLAGS_DIRECTION_LADDER:
-				p=&SpriteAnimationMrMustardSide[((GameSpriteSlots[slot].flags & SPRITE_FLAGS_ANIMATION_MASK)>>1) % SPRITE_ANIMATION_MRMUSTARD_SIDE_MAX][0];
-				break;
-			case SPRITE_FLAGS_TYPE_MRMUSTARD|SPRITE_FLAGS_DIRECTION_SQUIRT:
-				p=&SpriteAnimationMrMustardSquirt[((GameSpriteSlots[slot].flags & SPRITE_FLAGS_ANIMATION_MASK)>>1) % SPRITE_ANIMATION_MRMUSTARD_SQUIRT_MAX][0];
-				break;
-			case SPRITE_FLAGS_TYPE_PEPPER|SPRITE_FLAGS_DIRECTION_LEFT:
-			case SPRITE_FLAGS_TYPE_PEPPER|SPRITE_FLAGS_DIRECTION_RIGHT:
-				p=&SpritePepper[0][0];
-				break;
-			default:
-				return;
+	/* Free slots need none. */
+	if (GameSpriteSlotFlags[slot] == SPRITE_FLAGS_FREE_SLOT)
+		return 0;
+
+	/* Unmapped slots neither. Any piece on screen counts, the first one may be off screen at the border. */
+	n=GameSpriteSlotPieces[slot];
+	b=GameSpriteSlotBase[slot];
+	for (i=0;(i<n) && (sprites[b].x == OFF_SCREEN);i++,b++);
+	if (i == n)
+		return 0;
+
+	/* One more column or row of RAM tiles if not aligned to the background tiles. */
+	return (SPRITE_PIECES_WIDTH(n)+((sprites[b].x & 7)?1:0))*(SPRITE_PIECES_HEIGHT(n)+((sprites[b].y & 7)?1:0));
+}
+
+
+/* Commit all changed megasprites to the kernel sprites, once per frame. */
+void commitSprites(void) {
+	uint8_t slot, k, i, c, budget;
+
+	/* Update each changed slot exactly once. */
+	for (slot=0;GameSpriteSlotsDirty;slot++) {
+		if (GameSpriteSlotsDirty & (1<<slot)) {
+			updateSprite(slot);
+			GameSpriteSlotsDirty&=~(1<<slot);
 		}
 	}
 
-	/* Get address of first tile number for given animation step. */
-	i=slot*4;
-
-	/* Get view direction. */
-	view_right=((GameSpriteSlots[slot].flags & SPRITE_FLAGS_DIRECTION_MASK) == SPRITE_FLAGS_DIRECTION_RIGHT);
-	if ((GameSpriteSlots[slot].flags & SPRITE_FLAGS_TYPE_MASK) == SPRITE_FLAGS_TYPE_ANTICOOK)
-		view_right^=1;
-
-	/* No vertical flip. */
-	flip_y=0;
-
-	/* Setup kernel sprites according to flags. */
-	switch (GameSpriteSlots[slot].flags & (SPRITE_FLAGS_TYPE_MASK|SPRITE_FLAGS_DIRECTION_MASK)) {
-		case SPRITE_FLAGS_TYPE_COOK|SPRITE_FLAGS_DIRECTION_CAUGHT:
-			/* Vertical flip. */
-			flip_y=1;
-
-			/* Fall through. */
-		case SPRITE_FLAGS_TYPE_COOK|SPRITE_FLAGS_DIRECTION_LADDER:
-		case SPRITE_FLAGS_TYPE_ANTICOOK|SPRITE_FLAGS_DIRECTION_LADDER:
-		case SPRITE_FLAGS_TYPE_COOK|SPRITE_FLAGS_DIRECTION_SLIDE:
-		case SPRITE_FLAGS_TYPE_ANTICOOK|SPRITE_FLAGS_DIRECTION_SLIDE:
-		case SPRITE_FLAGS_TYPE_EGGHEAD|SPRITE_FLAGS_DIRECTION_LADDER:
-			/* Ignore view for these pieces. */
-			view_right=0;
-
-			/* Fall through. */
-		case SPRITE_FLAGS_TYPE_COOK|SPRITE_FLAGS_DIRECTION_LEFT:
-		case SPRITE_FLAGS_TYPE_COOK|SPRITE_FLAGS_DIRECTION_RIGHT:
-		case SPRITE_FLAGS_TYPE_ANTICOOK|SPRITE_FLAGS_DIRECTION_LEFT:
-		case SPRITE_FLAGS_TYPE_ANTICOOK|SPRITE_FLAGS_DIRECTION_RIGHT:
-		case SPRITE_FLAGS_TYPE_EGGHEAD|SPRITE_FLAGS_DIRECTION_LEFT:
-		case SPRITE_FLAGS_TYPE_EGGHEAD|SPRITE_FLAGS_DIRECTION_RIGHT:
-		case SPRITE_FLAGS_TYPE_SAUSAGEMAN|SPRITE_FLAGS_DIRECTION_LEFT:
-		case SPRITE_FLAGS_TYPE_SAUSAGEMAN|SPRITE_FLAGS_DIRECTION_RIGHT:
-			/* Place tiles, honor mirroring and flipping. */
-			for (j=0;j<4;j++) {
-				tile=pgm_read_byte(p);
-				sprites[i].tileIndex=tile & (~SPRITE_MIRROR);
-				sprites[i].flags=(((tile & SPRITE_MIRROR)^view_right)?SPRITE_FLIP_X:0)|(flip_y*SPRITE_FLIP_Y);
-				sprites[i].x=GameSpriteSlots[slot].x-((j&1)^view_right?0:8)-SPRITE_BORDER_WIDTH;
-				sprites[i].y=GameSpriteSlots[slot].y-8-((~j^(flip_y*2))&2)*4;
-				p++;
-				i++;
-			}
-			break;
-		case SPRITE_FLAGS_TYPE_SAUSAGEMAN|SPRITE_FLAGS_DIRECTION_LADDER:
-		case SPRITE_FLAGS_TYPE_MRMUSTARD|SPRITE_FLAGS_DIRECTION_RIGHT:
-		case SPRITE_FLAGS_TYPE_MRMUSTARD|SPRITE_FLAGS_DIRECTION_LEFT:
-		case SPRITE_FLAGS_TYPE_MRMUSTARD|SPRITE_FLAGS_DIRECTION_LADDER:
-		case SPRITE_FLAGS_TYPE_MRMUSTARD|SPRITE_FLAGS_DIRECTION_SQUIRT:
-			/* Place tiles, honor mirroring. */
-			for (j=0;j<2;j++) {
-				tile=pgm_read_byte(p);
-				sprites[i].tileIndex=tile & (~SPRITE_MIRROR);
-				sprites[i].flags=((tile & SPRITE_MIRROR)^view_right)?SPRITE_FLIP_X:0;
-				sprites[i].x=GameSpriteSlots[slot].x-4-SPRITE_BORDER_WIDTH;
-				sprites[i].y=GameSpriteSlots[slot].y-16+(j&1)*8;
-				p++;
-				i++;
+	/* Done if the occupied slots cannot run out of RAM tiles at all, e.g. up to two block opponents beside cook and pepper. */
+	if (GameSpriteRamTilesWorst <= RAM_TILES_COUNT) return;
+
+	/*
+	 *  Multiplex. Priority slots (cook and pepper) are drawn always,
+	 *  the others round-robin as long as RAM tiles are left.
+	 */
+	budget=RAM_TILES_COUNT;
+	for (slot=0;slot<SPRITE_SLOTS_MAX;slot++) {
+		if (GameSpriteSlotsPriority & (1<<slot)) {
+			c=getSpriteRamTiles(slot);
+			budget=(c<budget)?(budget-c):0;
+		}
+	}
+
+	/* The others, starting at the rotating offset. */
+	slot=GameSpriteMultiplexOffset;
+	for (k=0;k<SPRITE_SLOTS_MAX;k++) {
+		/* Draw slot if it fits. */
+		if (!(GameSpriteSlotsPriority & (1<<slot))) {
+			c=getSpriteRamTiles(slot);
+			if (c<=budget) {
+				budget-=c;
+			} else {
+				/* Hide it for this frame, redraw on next commit. */
+				for (i=0;i<GameSpriteSlotPieces[slot];i++)
+					sprites[GameSpriteSlotBase[slot]+i].x=OFF_SCREEN;
+				GameSpriteSlotsDirty|=(1<<slot);
 			}
+		}
 
-			/* Remove unneeded sprite tiles from screen. */
-			sprites[i].x=OFF_SCREEN;
-			i++;
-			sprites[i].x=OFF_SCREEN;
-			break;
-		case SPRITE_FLAGS_TYPE_PEPPER|SPRITE_FLAGS_DIRECTION_LEFT:
-		case SPRITE_FLAGS_TYPE_PEPPER|SPRITE_FLAGS_DIRECTION_RIGHT:
-			/* Place tiles, honor mirroring. */
-			tile=pgm_read_byte(p);
-			sprites[i].tileIndex=tile & (~SPRITE_MIRROR);
-			sprites[i].flags=((tile & SPRITE_MIRROR)^view_right)?SPRITE_FLIP_X:0;
-			sprites[i].x=GameSpriteSlots[slot].x-4-SPRITE_BORDER_WIDTH;
-			sprites[i].y=GameSpriteSlots[slot].y-16;
-			i++;
-
-			/* Remove unneeded sprite tiles from screen. */
-			sprites[i].x=OFF_SCREEN;
-			i++;
-			sprites[i].x=OFF_SCREEN;
-			i++;
-			sprites[i].x=OFF_SCREEN;
-			break;
+		/* Next slot, wrapping around. */
+		if (++slot == SPRITE_SLOTS_MAX)
+			slot=0;
 	}
+
+	/* Start with the next slot on next frame. */
+	if (++GameSpriteMultiplexOffset == SPRITE_SLOTS_MAX)
+		GameSpriteMultiplexOffset=0;
 }
 
 
 /* Place a sprite somewhere. */
 void placeSprite(uint8_t slot, uint8_t x, uint8_t y, uint16_t flags) {
 	/* Remember position and flags. */
-	GameSpriteSlots[slot].x=x;
-	GameSpriteSlots[slot].y=y;
-	GameSpriteSlots[slot].flags=flags;
+	GameSpriteSlotX[slot]=x;
+	GameSpriteSlotY[slot]=y;
+	GameSpriteSlotFlags[slot]=flags;
 
-	/* Update sprite. */
-	updateSprite(slot);
+	/* Update sprite on next commit. */
+	GameSpriteSlotsDirty|=(1<<slot);
 }
 
 
 /* Move a sprite. */
 uint8_t moveSpriteIfNotBorder(uint8_t slot, int8_t x, int8_t y) {
 	/* Fail if horizontal position is not within boundaries. */
-	if ((GameSpriteSlots[slot].x+x<SPRITE_BORDER_WIDTH) || (GameSpriteSlots[slot].x+x>(SCREEN_WIDTH<<3)+SPRITE_BORDER_WIDTH))
+	if ((GameSpriteSlotX[slot]+x<SPRITE_BORDER_WIDTH) || (GameSpriteSlotX[slot]+x>(SCREEN_WIDTH<<3)+SPRITE_BORDER_WIDTH))
 		return 0;
 
 	/* Actuall move sprite. */
@@ -372,58 +531,58 @@ uint8_t moveSpriteIfNotBorder(uint8_t slot, int8_t x, int8_t y) {
 
 void moveSprite(uint8_t slot, int8_t x, int8_t y) {
 	/* Remember new position. */
-	GameSpriteSlots[slot].x+=x;
-	GameSpriteSlots[slot].y+=y;
+	GameSpriteSlotX[slot]+=x;
+	GameSpriteSlotY[slot]+=y;
 
 	/* Next animation step. */
-	GameSpriteSlots[slot].flags=(GameSpriteSlots[slot].flags & ~SPRITE_FLAGS_ANIMATION_MASK) | ((GameSpriteSlots[slot].flags+1) & SPRITE_FLAGS_ANIMATION_MASK);
+	GameSpriteSlotFlags[slot]=(GameSpriteSlotFlags[slot] & ~SPRITE_FLAGS_ANIMATION_MASK) | ((GameSpriteSlotFlags[slot]+1) & SPRITE_FLAGS_ANIMATION_MASK);
 
-	/* Update sprite. */
-	updateSprite(slot);
+	/* Update sprite on next commit. */
+	GameSpriteSlotsDirty|=(1<<slot);
 }
 
 
 /* Align a sprite to nearby platform level. */
 void alignSpriteToPlatform(uint8_t slot) {
 	/* Align. */
-	GameSpriteSlots[slot].y&=0xf8;
+	GameSpriteSlotY[slot]&=0xf8;
 
-	/* Update sprite. */
-	updateSprite(slot);
+	/* Update sprite on next commit. */
+	GameSpriteSlotsDirty|=(1<<slot);
 }
 
 
 /* Change sprite direction. */
 void changeSpriteDirection(uint8_t slot, uint8_t direction) {
 	/* Remember updated direction, reset animation. */
-	GameSpriteSlots[slot].flags=(GameSpriteSlots[slot].flags & ~(SPRITE_FLAGS_DIRECTION_MASK|SPRITE_FLAGS_ANIMATION_MASK)) | (direction & SPRITE_FLAGS_DIRECTION_MASK);
+	GameSpriteSlotFlags[slot]=(GameSpriteSlotFlags[slot] & ~(SPRITE_FLAGS_DIRECTION_MASK|SPRITE_FLAGS_ANIMATION_MASK)) | (direction & SPRITE_FLAGS_DIRECTION_MASK);
 
-	/* Update sprite. */
-	updateSprite(slot);
+	/* Update sprite on next commit. */
+	GameSpriteSlotsDirty|=(1<<slot);
 }
 
 
 /* Get coordinates of sprite. */
 uint8_t getSpriteX(uint8_t slot) {
-	return GameSpriteSlots[slot].x;
+	return GameSpriteSlotX[slot];
 }
 
 uint8_t getSpriteTileX(uint8_t slot, int8_t c) {
-	return ((GameSpriteSlots[slot].x-SPRITE_BORDER_WIDTH+c)>>3);
+	return ((GameSpriteSlotX[slot]-SPRITE_BORDER_WIDTH+c)>>3);
 }
 
 uint8_t getSpriteY(uint8_t slot) {
-	return GameSpriteSlots[slot].y;
+	return GameSpriteSlotY[slot];
 }
 
 uint8_t getSpriteTileY(uint8_t slot, int8_t c) {
-	return ((GameSpriteSlots[slot].y+c)>>3);
+	return ((GameSpriteSlotY[slot]+c)>>3);
 }
 
 
 /* Get tile index for tile under sprite foot. */
 uint8_t getSpriteFloorTile(uint8_t slot) {
-	switch (GameSpriteSlots[slot].flags & SPRITE_FLAGS_DIRECTION_MASK) {
+	switch (GameSpriteSlotFlags[slot] & SPRITE_FLAGS_DIRECTION_MASK) {
 		case SPRITE_FLAGS_DIRECTION_LEFT:
 			return getTile(getSpriteTileX(slot,-1),getSpriteTileY(slot,0));
 		default:
@@ -433,7 +592,7 @@ uint8_t getSpriteFloorTile(uint8_t slot) {
 
 /* Get tile index for tile in sprite direction. */
 uint8_t getSpriteFloorDirectionTile(uint8_t slot) {
-	switch (GameSpriteSlots[slot].flags & SPRITE_FLAGS_DIRECTION_MASK) {
+	switch (GameSpriteSlotFlags[slot] & SPRITE_FLAGS_DIRECTION_MASK) {
 		case SPRITE_FLAGS_DIRECTION_LEFT:
 			return getTile(getSpriteTileX(slot,-9),getSpriteTileY(slot,0));
 		case SPRITE_FLAGS_DIRECTION_RIGHT:
@@ -508,11 +667,11 @@ uint8_t checkSpriteAtLadderEntryDown(uint8_t slot) {
 		case TILES0_LADDER_TOP_LEFT:
 		case TILES0_LADDER_TOP_FLOOREND_LEFT:
 			/* On ladder entry down if we are currently moving left. */
-			return ((GameSpriteSlots[slot].flags & SPRITE_FLAGS_DIRECTION_MASK) == SPRITE_FLAGS_DIRECTION_LEFT);
+			return ((GameSpriteSlotFlags[slot] & SPRITE_FLAGS_DIRECTION_MASK) == SPRITE_FLAGS_DIRECTION_LEFT);
 		case TILES0_LADDER_TOP_RIGHT:
 		case TILES0_LADDER_TOP_FLOOREND_RIGHT:
 			/* On ladder entry down if we are currently moving right. */
-			return ((GameSpriteSlots[slot].flags & SPRITE_FLAGS_DIRECTION_MASK) == SPRITE_FLAGS_DIRECTION_RIGHT);
+			return ((GameSpriteSlotFlags[slot] & SPRITE_FLAGS_DIRECTION_MASK) == SPRITE_FLAGS_DIRECTION_RIGHT);
 		default:
 			/* Not at a ladder down entry. */
 			return 0;
@@ -616,57 +775,98 @@ uint8_t checkSpriteAtRightFloorEnd(uint8_t slot) {
 }
 
 
-/* Squirt on a ladder at sprite. */
-uint8_t squirtOnLadderAtSprite(uint8_t slot) {
-	uint8_t x, y;
+/* Get ladder at sprite. */
+uint8_t getSpriteLadder(uint8_t slot) {
+	return getLadder(getSpriteTileX(slot,-8),getSpriteTileY(slot,-8));
+}
 
-	/* Get position. */
-	x=getSpriteTileX(slot,-8);
-	y=getSpriteTileY(slot,-8);
 
-	/* Skip squirted ladder pieces. */
-	while (getTile(x,y) == TILES0_LADDER_SQUIRTED_LEFT)
-		y--;
+/* Check if at the up entry of a ladder blocked by squirted pieces, from the ladder table. */
+uint8_t checkSpriteAtBlockedLadder(uint8_t slot) {
+	uint8_t l;
+
+	/* Fail if not at exact tile coordinate. */
+	if (getSpriteX(slot) & 0x07) return 0;
 
-	/* Check if still a piece to squirt. */
-	switch (getTile(x,y)) {
-		case TILES0_LADDER_LEFT:
-		case TILES0_LADDER_CLEANED_LEFT:
-		case TILES0_LADDER_WAILED_LEFT:
-			/* Squirt it. */
-			drawSquirtedLadderPiece(x,y);
+	/* Not blocked if there is no ladder. */
+	l=getSpriteLadder(slot);
+	if (l == SCREEN_LADDER_INVALID) return 0;
 
-			/* Not fully squirted. */
-			return 0;
+	/* Blocked if not all squirted pieces are cleaned. */
+	return (GameScreenLadder[l].squirted > GameScreenLadder[l].cleaned);
+}
+
+
+/* Squirt on a ladder at sprite. */
+uint8_t squirtOnLadderAtSprite(uint8_t slot) {
+	uint8_t l;
+	ladder_t *p;
+
+	/* Fully squirted if there is no ladder. */
+	l=getSpriteLadder(slot);
+	if (l == SCREEN_LADDER_INVALID) return 1;
+	p=&GameScreenLadder[l];
+
+	/* Squirt over cleaned and wailed pieces again first, then on the next piece above. */
+	if (p->cleaned) {
+		p->cleaned--;
+		drawSquirtedLadderPiece(p->x,p->bottom-1-p->cleaned);
+	} else if (p->wailed) {
+		p->wailed--;
+		drawSquirtedLadderPiece(p->x,p->bottom-1-p->wailed);
+	} else if (p->squirted < p->bottom-p->top-1) {
+		drawSquirtedLadderPiece(p->x,p->bottom-1-p->squirted);
+		p->squirted++;
+	} else {
+		/* Fully squirted. */
+		return 1;
 	}
 
-	/* Fully squirted. */
-	return 1;
+	/* Not fully squirted. */
+	return 0;
 }
 
 
 /* Clean ladder piece at sprite. */
 void cleanLadderAtSprite(uint8_t slot) {
-	drawCleanedLadderPiece(getSpriteTileX(slot,-8),getSpriteTileY(slot,-8));
+	uint8_t l, y;
+	ladder_t *p;
+
+	/* Clean piece. */
+	y=getSpriteTileY(slot,-8);
+	drawCleanedLadderPiece(getSpriteTileX(slot,-8),y);
+
+	/* Count it if it is the next piece from the bottom. */
+	l=getSpriteLadder(slot);
+	if (l == SCREEN_LADDER_INVALID) return;
+	p=&GameScreenLadder[l];
+	if (p->bottom-1-y == p->cleaned) {
+		p->cleaned++;
+
+		/* Forget about the squirt when the whole of it is cleaned. */
+		if (p->cleaned == p->squirted) {
+			p->cleaned=0;
+			p->squirted=0;
+		}
+	}
 }
 
 
 /* Wail on a ladder at sprite. */
 uint8_t wailOnLadderAtSprite(uint8_t slot) {
-	uint8_t x, y;
+	uint8_t l;
+	ladder_t *p;
 
-	/* Get position. */
-	x=getSpriteTileX(slot,-8);
-	y=getSpriteTileY(slot,-8);
-
-	/* Skip wailed ladder pieces. */
-	while (getTile(x,y) == TILES0_LADDER_WAILED_LEFT)
-		y--;
+	/* Done if there is no ladder. */
+	l=getSpriteLadder(slot);
+	if (l == SCREEN_LADDER_INVALID) return 1;
+	p=&GameScreenLadder[l];
 
-	/* Check if still a piece to wail over. */
-	if (getTile(x,y) == TILES0_LADDER_SQUIRTED_LEFT) {
+	/* Check if still a squirted piece to wail over. A cleaned bottom piece stops the wailing. */
+	if ((!p->cleaned) && (p->wailed < p->squirted)) {
 		/* Wail on that piece. */
-		drawWailedLadderPiece(x,y);
+		drawWailedLadderPiece(p->x,p->bottom-1-p->wailed);
+		p->wailed++;
 
 		/* Not fully wailed. */
 		return 0;
@@ -682,24 +882,40 @@ uint8_t wailOnLadderAtSprite(uint8_t slot) {
 
 /* Unwail a ladder. */
 void unwailLadderAtSprite(uint8_t slot) {
-	uint8_t x, y;
+	uint8_t l;
+	ladder_t *p;
 
-	/* Get position. */
-	x=getSpriteTileX(slot,-8);
-	y=getSpriteTileY(slot,-8);
+	/* Skip if there is no ladder. */
+	l=getSpriteLadder(slot);
+	if (l == SCREEN_LADDER_INVALID) return;
+	p=&GameScreenLadder[l];
 
 	/* Replace the wail by squirt. */
-	while (getTile(x,y) == TILES0_LADDER_WAILED_LEFT)
-	{
-		drawSquirtedLadderPiece(x,y);
-		y--;
+	while (p->wailed) {
+		p->wailed--;
+		drawSquirtedLadderPiece(p->x,p->bottom-1-p->wailed);
 	}
 }
 
 
 /* Set sprite transparency. */
 void setSpriteTransparency(uint8_t slot, uint16_t transparent) {
-	GameSpriteSlots[slot].flags&=~SPRITE_FLAGS_TRANSPARENT;
-	GameSpriteSlots[slot].flags|=transparent;
+	GameSpriteSlotFlags[slot]&=~SPRITE_FLAGS_TRANSPARENT;
+	GameSpriteSlotFlags[slot]|=transparent;
+
+	/* Update sprite on next commit. */
+	GameSpriteSlotsDirty|=(1<<slot);
+}
+
+
+
+/* Get sprite type. */
+uint16_t getSpriteType(uint8_t slot) {
+	return GameSpriteSlotFlags[slot] & SPRITE_FLAGS_TYPE_MASK;
 }
 
+
+/* Get first kernel sprite of a sprite slot. */
+uint8_t getSpriteKernelIndex(uint8_t slot) {
+	return GameSpriteSlotBase[slot];
+}
@@ -39,9 +39,11 @@ extern const char SpriteTiles[] PROGMEM;
 #define mtile(row,column,mirror) (((SPRITEMAP_WIDTH*row+column)|(mirror?SPRITE_MIRROR:0)))
 
 
-/* Megasprite slots. */
-#define SPRITE_SLOTS_MAX              6
+/* Megasprite slots. Cook, pepper and OPPONENT_MAX opponents. */
+#define SPRITE_SLOTS_MAX              10
 #define SPRITE_SLOTS_FULL             SPRITE_SLOTS_MAX
+#define SPRITE_SLOT_MULTIPLEXED       0
+#define SPRITE_SLOT_PRIORITY          1
 #define SPRITE_FLAGS_FREE_SLOT        0x00
 #define SPRITE_FLAGS_OCCUPIED_SLOT    0xff
 #define SPRITE_FLAGS_ANIMATION_MASK   0x0f
@@ -65,12 +67,24 @@ extern const char SpriteTiles[] PROGMEM;
 #define SPRITE_FLAGS_TYPE_ANTICOOK    ((6<<SPRITE_FLAGS_TYPE_SHIFT))
 #define SPRITE_FLAGS_TRANSPARENT      ((1<<11))
 
+/* Kernel sprites per megasprite, by frame layout. */
+#define SPRITE_PIECES_BLOCK   4
+#define SPRITE_PIECES_TALLDUO 2
+#define SPRITE_PIECES_SINGLE  1
+
+/* Megasprite size in tiles, by kernel sprites. */
+#define SPRITE_PIECES_WIDTH(pieces)  (((pieces) == SPRITE_PIECES_BLOCK)?2:1)
+#define SPRITE_PIECES_HEIGHT(pieces) (((pieces) == SPRITE_PIECES_SINGLE)?1:2)
+
+/* RAM tiles per megasprite in the worst case, when not aligned to the background tiles. */
+#define SPRITE_RAM_TILES_WORST(pieces) (((SPRITE_PIECES_WIDTH(pieces)+1)*(SPRITE_PIECES_HEIGHT(pieces)+1)))
+
 
 void resetSpriteSlots(void);
-uint8_t occupySpriteSlot(void);
+uint8_t occupySpriteSlot(uint8_t pieces, uint8_t priority);
 void unmapSprite(uint8_t slot);
 void freeSpriteSlot(uint8_t slot);
-void updateSprite(uint8_t slot);
+void commitSprites(void);
 void placeSprite(uint8_t slot, uint8_t x, uint8_t y, uint16_t flags);
 uint8_t moveSpriteIfNotBorder(uint8_t slot, int8_t x, int8_t y);
 void moveSprite(uint8_t slot, int8_t x, int8_t y);
@@ -93,10 +107,14 @@ uint8_t checkSpriteAtLadderTop(uint8_t slot);
 uint8_t checkSpriteAtLadderBottom(uint8_t slot);
 uint8_t checkSpriteAtLeftFloorEnd(uint8_t slot);
 uint8_t checkSpriteAtRightFloorEnd(uint8_t slot);
+uint8_t getSpriteLadder(uint8_t slot);
+uint8_t checkSpriteAtBlockedLadder(uint8_t slot);
 uint8_t squirtOnLadderAtSprite(uint8_t slot);
 uint8_t wailOnLadderAtSprite(uint8_t slot);
 void unwailLadderAtSprite(uint8_t slot);
 void cleanLadderAtSprite(uint8_t slot);
 void setSpriteTransparency(uint8_t slot, uint16_t transparent);
+uint16_t getSpriteType(uint8_t slot);
+uint8_t getSpriteKernelIndex(uint8_t slot);
 
 #endif /* SPRITES_H */
@@ -0,0 +1,207 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  statistics.c - per level statistics in EEPROM.
+ *
+ *  Each level has a bit packed entry with the number of plays and clears,
+ *  the best time for a clear and the number of deaths by cause. Entries
+ *  are kept in EEPROM blocks of their own. The entry is read when a level
+ *  is started and written back when it is left, one byte per frame, so
+ *  the game never waits for the EEPROM.
+ */
+
+
+#include <avr/io.h> /* for uint8_t */
+#include <string.h> /* for memset() */
+#include <uzebox.h> /* for EepromBlockExists() and friends */
+
+
+/* Local includes. */
+#include "statistics.h"
+#include "screens.h"
+#include "sprites.h"
+#include "controllers.h"
+
+
+/* Frames per second, for best time. */
+#define STATISTICS_FRAMES_PER_SECOND 60
+
+
+/* Entry of current level, its EEPROM block id and position in that block. */
+uint8_t LevelStatisticsEntry[STATISTICS_ENTRY_SIZE];
+uint16_t LevelStatisticsEid;
+uint8_t LevelStatisticsOffset;
+
+/* Frames played and cause of next death in current level. */
+uint16_t LevelStatisticsFrames;
+uint8_t LevelStatisticsCause;
+
+/* Pending EEPROM write. Written from the end, so a new block gets its id last. */
+uint8_t LevelStatisticsWriteBuffer[EEPROM_BLOCK_SIZE];
+uint16_t LevelStatisticsWriteAddress;
+uint8_t LevelStatisticsWritePending;
+
+
+/* Get bit field from entry. */
+uint16_t getStatisticsField(uint8_t pos, uint8_t bits) {
+	uint16_t value;
+	uint8_t i;
+
+	/* Collect bits, lowest first. */
+	value=0;
+	for (i=0;i<bits;i++)
+		if (LevelStatisticsEntry[(pos+i)>>3] & (1<<((pos+i) & 7)))
+			value|=(1<<i);
+
+	return value;
+}
+
+
+/* Set bit field in entry. */
+void setStatisticsField(uint8_t pos, uint8_t bits, uint16_t value) {
+	uint8_t i;
+
+	/* Store bits, lowest first. */
+	for (i=0;i<bits;i++) {
+		if (value & (1<<i))
+			LevelStatisticsEntry[(pos+i)>>3]|=(1<<((pos+i) & 7));
+		else
+			LevelStatisticsEntry[(pos+i)>>3]&=~(1<<((pos+i) & 7));
+	}
+}
+
+
+/* Increment bit field in entry, saturating. */
+void incrementStatisticsField(uint8_t pos, uint8_t bits) {
+	uint16_t value;
+
+	value=getStatisticsField(pos,bits);
+	if (value < ((1<<bits)-1))
+		setStatisticsField(pos,bits,value+1);
+}
+
+
+/* Write all pending bytes at once. */
+void flushLevelStatistics(void) {
+	while (LevelStatisticsWritePending)
+		updateLevelStatistics();
+}
+
+
+/* Read entry of current level. Counts a play. */
+void beginLevelStatistics(void) {
+	uint16_t address;
+	uint8_t i, free, index;
+
+	/* Finish previous write, if any. */
+	flushLevelStatistics();
+
+	/* Find block and position of entry. */
+	index=((Level < STATISTICS_LEVEL_MAX)?Level:STATISTICS_LEVEL_MAX)-1;
+	LevelStatisticsEid=STATISTICS_EID+index/STATISTICS_ENTRIES_PER_BLOCK;
+	LevelStatisticsOffset=2+(index%STATISTICS_ENTRIES_PER_BLOCK)*STATISTICS_ENTRY_SIZE;
+
+	/* Read entry. Start with an empty one if the block doesn't exist yet. */
+	if (EepromBlockExists(LevelStatisticsEid,&address,&free) == EEPROM_OK) {
+		for (i=0;i<STATISTICS_ENTRY_SIZE;i++)
+			LevelStatisticsEntry[i]=ReadEeprom(address+LevelStatisticsOffset+i);
+	} else {
+		memset(LevelStatisticsEntry,0,STATISTICS_ENTRY_SIZE);
+	}
+
+	/* Count play, reset time. */
+	incrementStatisticsField(STATISTICS_PLAYS_POS,STATISTICS_PLAYS_BITS);
+	LevelStatisticsFrames=0;
+	LevelStatisticsCause=STATISTICS_CAUSE_OTHER;
+}
+
+
+/* Count a frame of play. */
+void countLevelStatisticsFrame(void) {
+	if (LevelStatisticsFrames < 0xffff)
+		LevelStatisticsFrames++;
+}
+
+
+/* Remember cause of death by the sprite type of the killer. */
+void setLevelStatisticsCause(uint16_t type) {
+	switch (type) {
+		case SPRITE_FLAGS_TYPE_SAUSAGEMAN: LevelStatisticsCause=STATISTICS_CAUSE_SAUSAGEMAN; break;
+		case SPRITE_FLAGS_TYPE_EGGHEAD:    LevelStatisticsCause=STATISTICS_CAUSE_EGGHEAD; break;
+		case SPRITE_FLAGS_TYPE_MRMUSTARD:  LevelStatisticsCause=STATISTICS_CAUSE_MRMUSTARD; break;
+		case SPRITE_FLAGS_TYPE_ANTICOOK:   LevelStatisticsCause=STATISTICS_CAUSE_ANTICOOK; break;
+		default:                           LevelStatisticsCause=STATISTICS_CAUSE_OTHER; break;
+	}
+}
+
+
+/* Count a death by the remembered cause. */
+void countLevelStatisticsDeath(void) {
+	incrementStatisticsField(STATISTICS_DEATHS_POS+LevelStatisticsCause*STATISTICS_DEATHS_BITS,STATISTICS_DEATHS_BITS);
+	LevelStatisticsCause=STATISTICS_CAUSE_OTHER;
+}
+
+
+/* Level left. Count clear and best time, start writing the entry back. */
+void endLevelStatistics(uint8_t cleared) {
+	uint16_t address, seconds, best;
+	uint8_t free;
+
+	/* Demo plays don't count. */
+	if (ControllerDemoState != CONTROLLER_DEMO_STATE_OFF)
+		return;
+
+	/* Count clear and best time. */
+	if (cleared) {
+		incrementStatisticsField(STATISTICS_CLEARS_POS,STATISTICS_CLEARS_BITS);
+		seconds=LevelStatisticsFrames/STATISTICS_FRAMES_PER_SECOND;
+		if (seconds >= (1<<STATISTICS_BEST_TIME_BITS))
+			seconds=(1<<STATISTICS_BEST_TIME_BITS)-1;
+		best=getStatisticsField(STATISTICS_BEST_TIME_POS,STATISTICS_BEST_TIME_BITS);
+		if (!best || seconds < best)
+			setStatisticsField(STATISTICS_BEST_TIME_POS,STATISTICS_BEST_TIME_BITS,seconds?seconds:1);
+	}
+
+	/* Write entry into its block if it exists. */
+	if (EepromBlockExists(LevelStatisticsEid,&address,&free) == EEPROM_OK) {
+		memcpy(LevelStatisticsWriteBuffer,LevelStatisticsEntry,STATISTICS_ENTRY_SIZE);
+		LevelStatisticsWriteAddress=address+LevelStatisticsOffset;
+		LevelStatisticsWritePending=STATISTICS_ENTRY_SIZE;
+		return;
+	}
+
+	/* Otherwise create a new block in the first free one, if any. */
+	if (free == 0xff)
+		return;
+	memset(LevelStatisticsWriteBuffer,0,EEPROM_BLOCK_SIZE);
+	LevelStatisticsWriteBuffer[0]=LevelStatisticsEid & 0xff;
+	LevelStatisticsWriteBuffer[1]=LevelStatisticsEid>>8;
+	memcpy(LevelStatisticsWriteBuffer+LevelStatisticsOffset,LevelStatisticsEntry,STATISTICS_ENTRY_SIZE);
+	LevelStatisticsWriteAddress=free*EEPROM_BLOCK_SIZE;
+	LevelStatisticsWritePending=EEPROM_BLOCK_SIZE;
+}
+
+
+/* Write one pending byte. Called once per frame. */
+void updateLevelStatistics(void) {
+	uint16_t address;
+	uint8_t value;
+
+	/* Nothing to do? */
+	if (!LevelStatisticsWritePending)
+		return;
+
+	/* Write next byte from the end, skip unchanged ones. */
+	LevelStatisticsWritePending--;
+	address=LevelStatisticsWriteAddress+LevelStatisticsWritePending;
+	value=LevelStatisticsWriteBuffer[LevelStatisticsWritePending];
+	if (ReadEeprom(address) != value)
+		WriteEeprom(address,value);
+}
@@ -0,0 +1,74 @@
+/*
+ *  Würgertime - An hommage to Burger Time
+ *
+ *  Copyright (C) 2012 by Jan Kandziora <jjj@gmx.de>
+ *  licensed under the GNU GPL v3 or later
+ *
+ *  see https://github.com/ianka/wuergertime
+ *
+ * ---------------------------------------------------
+ *
+ *  statistics.h - per level statistics in EEPROM.
+ */
+
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+
+#include <avr/io.h> /* for uint8_t */
+
+
+#ifdef LEVEL_STATISTICS
+
+/*
+ *  Levels with own statistics. Higher levels share the last entry. The
+ *  EEPROM is shared by all games on the console, so the statistics take
+ *  just 3 of its 64 blocks, with ids 0x5760 to 0x5762. See tools/levelstats.tcl.
+ */
+#define STATISTICS_LEVEL_MAX 15
+#define STATISTICS_ENTRY_SIZE 6
+#define STATISTICS_ENTRIES_PER_BLOCK 5
+#define STATISTICS_BLOCK_MAX (((STATISTICS_LEVEL_MAX+STATISTICS_ENTRIES_PER_BLOCK-1)/STATISTICS_ENTRIES_PER_BLOCK))
+#define STATISTICS_EID 0x5760
+
+/* Bit fields in an entry: plays, clears, best time in seconds, deaths by cause. All saturate. */
+#define STATISTICS_PLAYS_POS        0
+#define STATISTICS_PLAYS_BITS      10
+#define STATISTICS_CLEARS_POS      10
+#define STATISTICS_CLEARS_BITS     10
+#define STATISTICS_BEST_TIME_POS   20
+#define STATISTICS_BEST_TIME_BITS   8
+#define STATISTICS_DEATHS_POS      28
+#define STATISTICS_DEATHS_BITS      4
+
+/* Causes of death. */
+#define STATISTICS_CAUSE_SAUSAGEMAN 0
+#define STATISTICS_CAUSE_EGGHEAD    1
+#define STATISTICS_CAUSE_MRMUSTARD  2
+#define STATISTICS_CAUSE_ANTICOOK   3
+#define STATISTICS_CAUSE_OTHER      4
+#define STATISTICS_CAUSE_MAX        5
+
+
+void beginLevelStatistics(void);
+void countLevelStatisticsFrame(void);
+void setLevelStatisticsCause(uint16_t type);
+void countLevelStatisticsDeath(void);
+void endLevelStatistics(uint8_t cleared);
+void updateLevelStatistics(void);
+
+#else
+
+/* No level statistics. */
+#define beginLevelStatistics()
+#define countLevelStatisticsFrame()
+#define setLevelStatisticsCause(type)
+#define countLevelStatisticsDeath()
+#define endLevelStatistics(cleared)
+#define updateLevelStatistics()
+
+#endif /* LEVEL_STATISTICS */
+
+
+#endif /* STATISTICS_H */
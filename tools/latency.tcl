@@ -0,0 +1,124 @@
+#!/usr/bin/tclsh
+#
+#  latency.tcl - report input latency measured by a LATENCYPROBE=1 build.
+#
+#  Reads the emulator output from stdin, e.g.
+#    uzem Wuergertime.hex | ../tools/latency.tcl -screens ../screens.h
+#  and prints the latency distribution per screen and game state when the
+#  input ends. Use -every n to get an intermediate report every n probes.
+#
+#  Game state is "hurry" when the cook moves every frame, "normal" when
+#  he moves every other frame, each split by the parity of the animation
+#  phase the button was sampled in. Latency is counted in frames from
+#  sampling the button to the vsync showing the cook's response. Probes
+#  without a response are counted as timeouts, e.g. up or down away from
+#  a ladder.
+#
+# (C)2012 Janka <jjj@gmx.de>, use and distribute under the terms of GNU GPLv3 or any later version.
+#
+
+package require cmdline
+
+
+## Get options.
+if {[ catch {set parameters [cmdline::getoptions argv {
+	{screens.arg "screens.h" "screens.h with the game screen definitions"}
+	{buttons "split report by injected button"}
+	{every.arg "0" "print a report every that many probes"}
+}	{[options] -- options are:}]} result]} {
+	puts stderr $result
+	exit 1
+}
+
+
+## Read game screen names from screens.h.
+set screennames {}
+set constants {}
+set f [open [dict get $parameters screens]]
+foreach line [split [read $f] \n] {
+	if {[regexp {^#define\s+GAME_SCREEN_(\w+)\s+\(\((\w+)\|(\w+)\|?(\w*)\)\)} $line match name a b c]} {
+		set value 0
+		foreach part [list $a $b $c] {
+			if {$part eq {}} continue
+			if {[dict exists $constants $part]} {
+				set value [expr $value | [dict get $constants $part]]
+			} else {
+				set value [expr $value | $part]
+			}
+		}
+		dict set screennames $value [string tolower $name]
+	} elseif {[regexp {^#define\s+(GAME_SCREEN_\w+)\s+(0x[0-9a-fA-F]+|\d+)\s*$} $line match name value]} {
+		dict set constants $name $value
+	}
+}
+close $f
+
+## Button names, in the order of LatencyProbeButtons[] in latency.c.
+set buttonnames {left right up down}
+
+
+## Print report.
+proc report {} {
+	global samples parameters
+
+	puts [format "%-18s %-18s %6s %8s %4s %6s %6s %4s  %s" screen state probes timeouts min median mean max histogram]
+	foreach key [lsort [dict keys $samples]] {
+		lassign $key screen state
+		set values [lsort -integer [dict get $samples $key]]
+		set responses [lsearch -all -inline -not -exact $values 0]
+		set timeouts [expr [llength $values]-[llength $responses]]
+
+		## No responses at all?
+		if {![llength $responses]} {
+			puts [format "%-18s %-18s %6d %8d" $screen $state [llength $values] $timeouts]
+			continue
+		}
+
+		## Statistics of responses.
+		set min [lindex $responses 0]
+		set max [lindex $responses end]
+		set median [lindex $responses [expr [llength $responses]/2]]
+		set mean [expr double([tcl::mathop::+ {*}$responses])/[llength $responses]]
+
+		## Histogram: frames:count.
+		set histogram {}
+		for {set i $min} {$i<=$max} {incr i} {
+			set n [llength [lsearch -all -exact $responses $i]]
+			if {$n} {
+				lappend histogram "$i:$n"
+			}
+		}
+
+		puts [format "%-18s %-18s %6d %8d %4d %6d %6.2f %4d  %s" $screen $state [llength $values] $timeouts $min $median $mean $max [join $histogram " "]]
+	}
+	puts ""
+}
+
+
+## Collect samples.
+set samples {}
+set probes 0
+while {[gets stdin line] >= 0} {
+	if {![regexp {LATENCY\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)} $line match screen hurry parity button frames]} {
+		continue
+	}
+
+	## Build key.
+	if {[dict exists $screennames $screen]} {
+		set screen [dict get $screennames $screen]
+	}
+	set state [expr {$hurry?"hurry":"normal"}]/[expr {$parity?"odd":"even"}]
+	if {[dict get $parameters buttons]} {
+		append state /[lindex $buttonnames $button]
+	}
+	dict lappend samples [list $screen $state] $frames
+
+	## Intermediate report.
+	incr probes
+	if {[dict get $parameters every] && !($probes % [dict get $parameters every])} {
+		report
+	}
+}
+
+## Final report.
+report
@@ -0,0 +1,998 @@
+#!/usr/bin/tclsh
+#
+#  levelcompiler.tcl - compile a level source into data/levels.inc.
+#
+#  The level source describes every level on its own, as a list of items.
+#  Level numbers count up from 1. Lines starting with # are comments.
+#
+#    design "ANIME MARATHON"
+#    author "JAN KANDZIORA"
+#
+#    level {
+#      options STOMP_ONCE OPPONENT_DUO WRAP_EASTWEST
+#      attackwaves EGGHEAD SAUSAGEMAN EGGHEAD MRMUSTARD EGGHEAD EGGHEAD SAUSAGEMAN EGGHEAD
+#      sign 10 0
+#      score 1 0
+#      ...
+#      plate 3 24
+#      burger BUNBOTTOM 3 19
+#      floor 0 5 30
+#      ladder SIMPLE 14 5 3
+#      playerstartpoint 15 24
+#      opponentstartpoint 1 5
+#    }
+#
+#  Items are named like the LEVEL_COMPONENT_ macros in screens.h, with the
+#  same arguments. Each level is checked against the limits of the game:
+#  burgers, places and components per burger, opponent start points and
+#  ladders, floor and ladder lengths, coordinates on screen. Levels without
+#  the items every level needs once, duplicate items and burger places not
+#  going upwards only give a warning, as the game copes with them.
+#
+#  The items of all levels are then factored into component blocks, so
+#  every item shared by a set of levels is stored only once. The order the
+#  game goes through the items matters for some of them, and is kept:
+#    - burgers get their slot by first appearance, places count bottom up
+#    - options come after the burgers, which are placed with reset options
+#    - opponent start points are numbered in order
+#  Everything else may be put in any order.
+#
+#  The output is a levels.inc as written by the level editor, plus an index
+#  of level drawings and component blocks used by a game built with
+#  LEVELINDEX=1. Use -import to read a levels.inc instead of a source, e.g.
+#  to optimise a file saved by the level editor, and -dump to write the
+#  level source instead of levels.inc:
+#
+#    levelcompiler.tcl -import -dump data/levels.inc >data/levels.src
+#    levelcompiler.tcl -v data/levels.src >data/levels.inc
+#
+#  The levels of the game are kept in data/levels.src. "make levels" in
+#  default/ compiles them into data/levels.inc, which is committed, so a
+#  plain build doesn't run this tool. The index is only compiled into a
+#  game built with LEVELINDEX=1.
+#
+# (C)2012 Janka <jjj@gmx.de>, use and distribute under the terms of GNU GPLv3 or any later version.
+#
+
+package require cmdline
+
+
+## Get options.
+if {[ catch {set parameters [cmdline::getoptions argv {
+	{headers.arg "." "directory of screens.h, screens.c, opponents.h and draw.h for the limits"}
+	{import "read a levels.inc instead of a level source"}
+	{dump "write a level source instead of levels.inc"}
+	{v "print flash usage on stderr"}
+}	{[options] file -- options are:}]} result]} {
+	puts stderr $result
+	exit 1
+}
+if {[llength $argv] != 1} {
+	puts stderr "Usage: levelcompiler.tcl \[-headers directory\] \[-import\] \[-dump\] \[-v\] file"
+	exit 1
+}
+
+
+## Read limits and level item constants from the game sources.
+foreach header {screens.h screens.c opponents.h draw.h} {
+	set f [open [file join [dict get $parameters headers] $header]]
+	foreach line [split [read $f] \n] {
+		if {[regexp {^#define\s+(\w+)\s+([^/]+)} $line match name value]} {
+			dict set defines $name [string trim $value]
+		}
+	}
+	close $f
+}
+
+## Evaluate a constant from the game sources.
+proc evaluate {name} {
+	set expression [dict get $::defines $name]
+	while {[regexp {[A-Z][A-Z_0-9]+} $expression other] && [dict exists $::defines $other]} {
+		set expression [regsub -all "\\m$other\\M" $expression ([dict get $::defines $other])]
+	}
+	expr $expression
+}
+
+## Limits.
+foreach {limit name} {
+	width        SCREEN_WIDTH
+	height       SCREEN_HEIGHT
+	burgers      SCREEN_BURGER_MAX
+	components   SCREEN_BURGER_COMPONENT_MAX
+	places       SCREEN_BURGER_PLACE_MAX
+	ladders      SCREEN_LADDER_MAX
+	opponents    OPPONENT_START_POSITION_MAX
+	floorlength  LEVEL_ITEM_FLOOR_LENGTH
+	ladderlength LEVEL_ITEM_LADDER_LENGTH
+} {
+	dict set limits $limit [evaluate $name]
+}
+
+## Level numbers and block numbers are bytes.
+set maxlevels 255
+set maxblocks 255
+
+## Names allowed as item arguments.
+set options {}
+dict for {name value} $defines {
+	if {[regexp {^LEVEL_ITEM_OPTION_(\w+)$} $name match option] && ![regexp {_(SHIFT|MASK)$} $option]} {
+		lappend options $option
+	}
+}
+set attackwaves {EGGHEAD SAUSAGEMAN MRMUSTARD ANTICOOK}
+set burgers {PLACEHOLDER BUNTOP TOMATO PATTY CHEESESALAD BUNBOTTOM}
+set laddertypes {SIMPLE UPONLY}
+
+## Arguments of items.
+set itemarguments {
+	options            {}
+	attackwaves        {}
+	sign               {x y}
+	score              {x y}
+	level              {x y}
+	bonus              {x y}
+	lives              {x y}
+	peppers            {x y}
+	playerstartpoint   {x y}
+	opponentstartpoint {x y}
+	plate              {x y}
+	burger             {type x y}
+	floor              {x y length}
+	ladder             {type x y length}
+}
+
+## Items each level needs exactly once, or at most once.
+set requireditems {attackwaves sign score level bonus lives peppers playerstartpoint}
+set optionalitems {options}
+
+
+## Report an error and remember to fail.
+set errors 0
+proc complain {message} {
+	puts stderr $message
+	incr ::errors
+}
+
+## Report something the game copes with, but probably isn't meant that way.
+proc warn {message} {
+	puts stderr "Warning: $message"
+}
+
+
+## Check and normalise an item. Returns an empty list on errors.
+proc parseItem {where words} {
+	set words [lassign $words item]
+	if {![dict exists $::itemarguments $item]} {
+		complain "$where: unknown item \"$item\"."
+		return {}
+	}
+
+	## Options and attack waves take names.
+	switch -- $item {
+		options {
+			set words [string toupper $words]
+			foreach option $words {
+				if {$option ni $::options} {
+					complain "$where: unknown option \"$option\"."
+					return {}
+				}
+			}
+			return [list options {*}$words]
+		}
+		attackwaves {
+			set words [string toupper $words]
+			if {[llength $words] != 8} {
+				complain "$where: need 8 attack waves."
+				return {}
+			}
+			foreach wave $words {
+				if {$wave ni $::attackwaves} {
+					complain "$where: unknown attack wave \"$wave\"."
+					return {}
+				}
+			}
+			return [list attackwaves {*}$words]
+		}
+	}
+
+	## Other items take a type and numbers.
+	set names [dict get $::itemarguments $item]
+	if {[llength $words] != [llength $names]} {
+		complain "$where: $item needs arguments: $names."
+		return {}
+	}
+	set result [list $item]
+	foreach name $names word $words {
+		if {$name eq "type"} {
+			set word [string toupper $word]
+			if {$word ni [expr {$item eq "burger"?$::burgers:$::laddertypes}]} {
+				complain "$where: unknown $item type \"$word\"."
+				return {}
+			}
+		} elseif {[scan $word %d%s value rest] != 1 || $value < 0 || $value > 255} {
+			complain "$where: bad $name \"$word\"."
+			return {}
+		} else {
+			set word $value
+		}
+		lappend result $word
+	}
+	return $result
+}
+
+
+## Read a level source. Returns a list of levels, each a list of items.
+proc readSource {filename} {
+	set f [open $filename]
+	set source [regsub -all -line {^[[:blank:]]*#.*$} [read $f] {}]
+	close $f
+
+	if {[catch {llength $source}] || [llength $source] % 2} {
+		complain "$filename: not a list of keywords and values."
+		exit 1
+	}
+
+	set levels {}
+	foreach {keyword value} $source {
+		switch -- $keyword {
+			design {set ::leveldesign $value}
+			author {set ::levelauthor $value}
+			level {
+				set where "$filename: level [expr {[llength $levels]+1}]"
+				set level {}
+				foreach line [split $value \n] {
+					if {[catch {llength $line}]} {
+						complain "$where: bad line \"[string trim $line]\"."
+						continue
+					}
+					if {[llength $line]} {
+						if {[llength [set item [parseItem $where $line]]]} {
+							lappend level $item
+						}
+					}
+				}
+				lappend levels $level
+			}
+			default {
+				complain "$filename: unknown keyword \"$keyword\"."
+			}
+		}
+	}
+	return $levels
+}
+
+
+## Read a levels.inc. Returns a list of levels, each a list of items.
+proc readInclude {filename} {
+	set f [open $filename]
+	set source [read $f]
+	close $f
+
+	regexp {#define LEVEL_DESIGN "([^"\n]*)"} $source match ::leveldesign
+	regexp {#define LEVEL_AUTHOR "([^"\n]*)"} $source match ::levelauthor
+	set source [regsub -all {/\*.*?\*/} $source {}]
+
+	## Get component blocks.
+	if {![regexp {LevelComponents\[\][^\{]*\{([^\}]*)\};} $source match components]} {
+		complain "$filename: no level components found."
+		exit 1
+	}
+	set blocks {}
+	set block {}
+	foreach {match name arguments} [regexp -all -inline {LEVEL_COMPONENT_(\w+)(?:\(([^)]*)\))?} $components] {
+		set where "$filename: component block [expr {[llength $blocks]+1}]"
+		switch -- $name {
+			END {
+				lappend blocks $block
+				set block {}
+				continue
+			}
+			OPTIONS {
+				set words [list options {*}[regsub -all {LEVEL_ITEM_OPTION_} [regsub -all {[|[:space:]]+} $arguments { }] {}]]
+			}
+			ATTACKWAVES {
+				set words [list attackwaves {*}[regsub -all {LEVEL_ITEM_ATTACK_WAVE_} [regsub -all {[,[:space:]]+} $arguments { }] {}]]
+			}
+			default {
+				set words [list [string tolower $name] {*}[lmap argument [split $arguments ,] {string trim $argument}]]
+			}
+		}
+		if {[llength [set item [parseItem $where $words]]]} {
+			lappend block $item
+		}
+	}
+
+	## Get level drawings and put the items of their blocks together.
+	if {![regexp {LevelDrawings\[\][^\{]*\{([^\}]*)\};} $source match drawings]} {
+		complain "$filename: no level drawings found."
+		exit 1
+	}
+	set levels {}
+	set level {}
+	foreach b [regexp -all -inline {\d+} $drawings] {
+		if {$b == 0} {
+			if {[llength $level]} {
+				lappend levels $level
+			}
+			set level {}
+			continue
+		}
+		if {$b > [llength $blocks]} {
+			complain "$filename: level [expr {[llength $levels]+1}] uses missing component block $b."
+			continue
+		}
+		lappend level {*}[lindex $blocks [expr {$b-1}]]
+	}
+	return $levels
+}
+
+
+## Check a level against the limits of the game and get the order its items
+## need. Returns a dict of item ids with their items and predecessors in this
+## level. Burger items and opponent start points are told apart by slot and
+## place or number, as they aren't the same thing elsewhere.
+proc analyseLevel {number items} {
+	set where "level $number"
+	set ids {}
+	set counts {}
+	set burgerslots {}
+	set burgerids {}
+	set burgerlast {}
+	set burgerfirst {}
+	set burgercomponents {}
+	set opponentlast {}
+	set ladders 0
+
+	foreach item $items {
+		set kind [lindex $item 0]
+		dict incr counts $kind
+		set id [list $item]
+		set predecessors {}
+
+		## Positions must be on screen.
+		switch -- $kind {
+			options - attackwaves {set x 0; set y 0}
+			burger - ladder {lassign $item kind type x y length}
+			default {lassign $item kind x y length}
+		}
+		if {$x >= [dict get $::limits width] || $y >= [dict get $::limits height]} {
+			complain "$where: $item is off screen."
+		}
+
+		switch -- $kind {
+			floor {
+				if {$length < 1 || $length > [dict get $::limits floorlength]} {
+					complain "$where: $item is longer than [dict get $::limits floorlength] or empty."
+				} elseif {$x+$length > [dict get $::limits width]} {
+					complain "$where: $item leaves the screen."
+				}
+			}
+			ladder {
+				if {$length < 1 || $length > [dict get $::limits ladderlength]} {
+					complain "$where: $item is longer than [dict get $::limits ladderlength] or empty."
+				} elseif {$y+$length >= [dict get $::limits height]} {
+					complain "$where: $item leaves the screen."
+				}
+				if {[incr ladders] > [dict get $::limits ladders]} {
+					complain "$where: more than [dict get $::limits ladders] ladders."
+				}
+			}
+			plate - burger {
+				## Get burger slot by x coordinate.
+				if {![dict exists $burgerslots $x]} {
+					set slot [dict size $burgerslots]
+					if {$slot >= [dict get $::limits burgers]} {
+						complain "$where: more than [dict get $::limits burgers] burgers."
+					}
+					if {$kind ne "plate"} {
+						complain "$where: burger at x=$x doesn't start with a plate."
+					}
+					dict set burgerslots $x $slot
+					dict set burgerids $x {}
+					if {$burgerfirst ne {}} {
+						lappend predecessors $burgerfirst
+					}
+					set burgerfirst [list $item slot $slot place 0]
+				} else {
+					set slot [dict get $burgerslots $x]
+					if {$kind eq "plate"} {
+						complain "$where: second plate for burger at x=$x."
+					}
+					if {$y >= [lindex [dict get $burgerlast $x] 0 end]} {
+						warn "$where: $item isn't above the previous place of its burger."
+					}
+					lappend predecessors [dict get $burgerlast $x]
+				}
+
+				## Count places bottom up, and components.
+				set place [llength [dict get $burgerids $x]]
+				if {$place == [dict get $::limits places]} {
+					complain "$where: more than [dict get $::limits places] places in burger at x=$x."
+				}
+				if {$kind eq "burger" && $type ne "PLACEHOLDER"
+					&& [dict get [dict incr burgercomponents $x] $x] > [dict get $::limits components]} {
+					complain "$where: more than [dict get $::limits components] components in burger at x=$x."
+				}
+				set id [list $item slot $slot place $place]
+				dict lappend burgerids $x $id
+				dict set burgerlast $x $id
+			}
+			opponentstartpoint {
+				set number [expr {[dict get $counts $kind]-1}]
+				if {$number == [dict get $::limits opponents]} {
+					complain "$where: more than [dict get $::limits opponents] opponent start points."
+				}
+				set id [list $item number $number]
+				if {$opponentlast ne {}} {
+					lappend predecessors $opponentlast
+				}
+				set opponentlast $id
+			}
+		}
+
+		## Keep copies of an item apart.
+		if {[dict exists $ids $id]} {
+			warn "$where: $item twice."
+			set copy 2
+			while {[dict exists $ids [list $item copy $copy]]} {
+				incr copy
+			}
+			set id [list $item copy $copy]
+		}
+		dict set ids $id [dict create item $item predecessors $predecessors]
+	}
+
+	## Options come after all burgers.
+	dict for {id value} $ids {
+		if {[lindex $id 0 0] eq "options"} {
+			dict set ids $id predecessors [concat {*}[dict values $burgerids]]
+		}
+	}
+
+	## Check items needed once.
+	foreach kind [concat $::requireditems $::optionalitems] {
+		if {![dict exists $counts $kind]} {
+			if {$kind in $::requireditems} {
+				warn "$where: no $kind, the game keeps the one of the level before."
+			}
+		} elseif {[dict get $counts $kind] > 1} {
+			warn "$where: more than one $kind, the game takes the last one."
+		}
+	}
+	return $ids
+}
+
+
+## Get the levels.
+set filename [lindex $argv 0]
+if {[dict get $parameters import]} {
+	set levels [readInclude $filename]
+} else {
+	set levels [readSource $filename]
+}
+foreach name {leveldesign levelauthor} {
+	if {![info exists $name]} {
+		complain "$filename: no [string range $name 5 end] given."
+		set $name {}
+	}
+}
+if {![llength $levels]} {
+	complain "$filename: no levels."
+}
+if {[llength $levels] > $maxlevels} {
+	complain "$filename: [llength $levels] levels, maximum is $maxlevels."
+}
+if {$errors} {
+	exit 1
+}
+
+
+## Write the level source if asked for.
+if {[dict get $parameters dump]} {
+	puts "# Level source for tools/levelcompiler.tcl"
+	puts [list design $leveldesign]
+	puts [list author $levelauthor]
+	set number 1
+	foreach level $levels {
+		puts "\n# Level $number\nlevel \{"
+		foreach item $level {
+			puts "\t$item"
+		}
+		puts "\}"
+		incr number
+	}
+	exit 0
+}
+
+
+## Check all levels, and collect the levels using each item and the items
+## that must come before it.
+set items {}
+set number 1
+foreach level $levels {
+	dict for {id value} [analyseLevel $number $level] {
+		dict with value {
+			dict set items $id item $item
+			dict set items $id levels [concat [expr {[dict exists $items $id levels]?[dict get $items $id levels]:{}}] $number]
+			foreach predecessor $predecessors {
+				dict set items $id predecessors $predecessor 1
+				dict set items $predecessor successors $id 1
+				dict lappend edges $number $predecessor $id
+			}
+		}
+	}
+	incr number
+}
+if {$errors} {
+	exit 1
+}
+
+
+## Sort order within a block. Burger items by slot and place, then options
+## and attack waves, other items by increasing x and decreasing y like the
+## level editor does, and opponent start points by number.
+proc itemOrder {id} {
+	set item [lindex $id 0]
+	switch -- [lindex $item 0] {
+		plate - burger     {return [list 0 [lindex $id 2] [lindex $id 4]]}
+		options            {return [list 1 0 0]}
+		attackwaves        {return [list 2 0 0]}
+		opponentstartpoint {return [list 4 [lindex $id 2] 0]}
+		ladder             {lassign $item kind type x y}
+		default            {lassign $item kind x y}
+	}
+	list 3 $x [expr {255-$y}]
+}
+
+proc compareItems {a b} {
+	foreach i [itemOrder $a] j [itemOrder $b] {
+		if {$i != $j} {
+			return [expr {$i-$j}]
+		}
+	}
+	string compare $a $b
+}
+
+
+## Put the items in a row, each after the ones it needs, and keep items of
+## the same set of levels together as long as possible. Each run of items
+## of the same set of levels becomes a component block. As a level takes
+## all items of these sets, its items come out in an order it allows.
+set waiting {}
+set available {}
+dict for {id value} $items {
+	if {[dict exists $value predecessors]} {
+		dict set waiting $id [dict size [dict get $value predecessors]]
+	} else {
+		lappend available $id
+	}
+}
+set blocks {}
+set block {}
+set blocklevels {}
+while {[llength $available]} {
+	## Take another item of the current block if there is one.
+	set candidates {}
+	foreach id $available {
+		if {[dict get $items $id levels] eq $blocklevels} {
+			lappend candidates $id
+		}
+	}
+
+	## Otherwise start a new block with the set of levels having the most
+	## items available, preferring sets of more levels.
+	if {![llength $candidates]} {
+		if {[llength $block]} {
+			lappend blocks [list $blocklevels $block]
+		}
+		set block {}
+		set sets {}
+		foreach id $available {
+			dict lappend sets [dict get $items $id levels] $id
+		}
+		set best {}
+		dict for {set ids} $sets {
+			if {$best eq {}
+				|| [llength $ids] > [llength [dict get $sets $best]]
+				|| ([llength $ids] == [llength [dict get $sets $best]] && [llength $set] > [llength $best])} {
+				set best $set
+			}
+		}
+		set blocklevels $best
+		set candidates [dict get $sets $best]
+	}
+
+	## Put the first one in order into the block.
+	set id [lindex [lsort -command compareItems $candidates] 0]
+	lappend block $id
+	set available [lsearch -all -inline -not -exact $available $id]
+	if {[dict exists $items $id successors]} {
+		foreach successor [dict keys [dict get $items $id successors]] {
+			if {[dict get [dict incr waiting $successor -1] $successor] == 0} {
+				dict unset waiting $successor
+				lappend available $successor
+			}
+		}
+	}
+}
+lappend blocks [list $blocklevels $block]
+if {[dict size $waiting]} {
+	complain "Items without an order: [dict keys $waiting]"
+	exit 1
+}
+
+
+## Get the order of the blocks used by a level, so it gets its items in an
+## order it allows, with the items in each block sorted. Returns an empty
+## list if the blocks need each other in a circle.
+proc orderBlocks {level blocks} {
+	## Get the blocks of the level, and the block of each item.
+	set b 0
+	set order {}
+	set where {}
+	foreach block $blocks {
+		lassign $block blocklevels ids
+		if {$level in $blocklevels} {
+			lappend order $b
+			foreach id $ids {
+				dict set where $id $b
+			}
+		}
+		incr b
+	}
+
+	## Get the blocks needed before each block.
+	set needs {}
+	if {[dict exists $::edges $level]} {
+		foreach {predecessor successor} [dict get $::edges $level] {
+			set p [dict get $where $predecessor]
+			set s [dict get $where $successor]
+			if {$p != $s} {
+				dict set needs $s $p 1
+			}
+		}
+	}
+
+	## Take the first block not needing any of the blocks left, over and over.
+	set result {}
+	while {[llength $order]} {
+		set found {}
+		foreach b $order {
+			set open 0
+			if {[dict exists $needs $b]} {
+				foreach p [dict keys [dict get $needs $b]] {
+					if {$p in $order} {
+						set open 1
+						break
+					}
+				}
+			}
+			if {!$open} {
+				set found $b
+				break
+			}
+		}
+		if {$found eq {}} {
+			return {}
+		}
+		lappend result $found
+		set order [lsearch -all -inline -not -exact $order $found]
+	}
+	return $result
+}
+
+## Sort order of blocks by their levels at the given index, most levels first.
+proc compareLevelCounts {index a b} {
+	expr {[llength [lindex $b $index]]-[llength [lindex $a $index]]}
+}
+
+## Get a set of levels as a bit mask.
+proc levelMask {levels} {
+	set mask 0
+	foreach level $levels {
+		set mask [expr {$mask | (1 << $level)}]
+	}
+	return $mask
+}
+
+## Check the levels of block a still get their items in an order they allow
+## if the items of block b are copied into block a.
+proc isCopyKept {blocks b a} {
+	lassign [lindex $blocks $b] blevels bids
+	lassign [lindex $blocks $a] alevels aids
+	set constrained 0
+	foreach id $bids {
+		if {[dict exists $::items $id predecessors] || [dict exists $::items $id successors]} {
+			set constrained 1
+			break
+		}
+	}
+	if {!$constrained} {
+		return 1
+	}
+	lset blocks $b 0 [lmap level $blevels {expr {($level in $alevels)?[continue]:$level}}]
+	lset blocks $a 1 [concat $aids $bids]
+	foreach level $alevels {
+		if {![llength [orderBlocks $level $blocks]]} {
+			return 0
+		}
+	}
+	return 1
+}
+
+## Find the fewest targets whose levels make up exactly the given levels.
+## Targets are pairs of block number and levels. Returns the block numbers.
+proc coverLevels {levels targets} {
+	set ::cover {}
+	set ::coverFound 0
+	searchCover $levels $targets {}
+	return $::cover
+}
+
+proc searchCover {levels targets chosen} {
+	if {$::coverFound && [llength $chosen] >= [llength $::cover]} {
+		return
+	}
+	if {![llength $levels]} {
+		set ::cover $chosen
+		set ::coverFound 1
+		return
+	}
+
+	## Get the targets still fitting in, and go on with the level fewest
+	## of them have.
+	set fitting {}
+	foreach target $targets {
+		lassign $target a alevels
+		set fits 1
+		foreach level $alevels {
+			if {$level ni $levels} {
+				set fits 0
+				break
+			}
+		}
+		if {$fits} {
+			lappend fitting $target
+		}
+	}
+	set best {}
+	foreach level $levels {
+		set n 0
+		foreach target $fitting {
+			if {$level in [lindex $target 1]} {
+				incr n
+			}
+		}
+		if {$best eq {} || $n < $bestn} {
+			set best $level
+			set bestn $n
+		}
+	}
+	foreach target $fitting {
+		lassign $target a alevels
+		if {$best in $alevels} {
+			searchCover [lmap level $levels {expr {($level in $alevels)?[continue]:$level}}] $fitting [concat $chosen $a]
+		}
+	}
+}
+
+
+## Each block costs 3 bytes for its end and each of its items, and a byte in
+## LevelDrawings for each level using it. A small block used by many levels
+## is cheaper if its items are copied into other blocks of these levels. Only
+## blocks used by levels all using the small one can take the copies. If the
+## copies go to all its levels, the small block isn't needed anymore. Find
+## the copies saving most flash, over and over, until nothing is saved.
+## Whether copying keeps the order of items is checked for the best copies
+## only, and remembered until the levels concerned change.
+set kept {}
+while 1 {
+	set masks [lmap block $blocks {levelMask [lindex $block 0]}]
+	set bestgain 0
+	for {set b 0} {$b < [llength $blocks]} {incr b} {
+		lassign [lindex $blocks $b] blevels bids
+		if {![llength $blevels]} continue
+		set cost [expr {3*[llength $bids]}]
+		set bmask [lindex $masks $b]
+
+		## Get the blocks which could take the copies, most levels first.
+		set targets {}
+		for {set a 0} {$a < [llength $blocks]} {incr a} {
+			set amask [lindex $masks $a]
+			if {$a == $b || !$amask || ($amask & $bmask) != $amask} continue
+			if {[dict exists $kept $b,$a] && ![dict get $kept $b,$a]} continue
+			lappend targets [list $a [lindex $blocks $a 0]]
+		}
+		set targets [lsort -command {compareLevelCounts 1} $targets]
+
+		## Copies to all levels, saving the end and the references.
+		if {[llength [set copies [coverLevels $blevels $targets]]]} {
+			set gain [expr {[llength $blevels]-$cost*[llength $copies]+$cost+3}]
+			if {$gain > $bestgain} {
+				set bestgain $gain
+				set best [list $b $copies]
+			}
+		}
+
+		## Copies to some levels, each saving more references than it costs.
+		set copies {}
+		set gain 0
+		set covered 0
+		foreach target $targets {
+			lassign $target a alevels
+			set amask [lindex $masks $a]
+			if {[llength $alevels] > $cost && !($amask & $covered)} {
+				lappend copies $a
+				incr gain [expr {[llength $alevels]-$cost}]
+				set covered [expr {$covered | $amask}]
+			}
+		}
+		if {$gain > $bestgain} {
+			set bestgain $gain
+			set best [list $b $copies]
+		}
+	}
+	if {$bestgain <= 0} break
+
+	## Check the copies keep the order of items, and look for other copies
+	## if they don't.
+	lassign $best b copies
+	set spoiled 0
+	foreach a $copies {
+		if {![dict exists $kept $b,$a]} {
+			dict set kept $b,$a [isCopyKept $blocks $b $a]
+		}
+		if {![dict get $kept $b,$a]} {
+			set spoiled 1
+		}
+	}
+	if {$spoiled} continue
+
+	## Copy the items.
+	set changed 0
+	foreach a $copies {
+		lassign [lindex $blocks $a] alevels aids
+		lset blocks $a 1 [concat $aids [lindex $blocks $b 1]]
+		lset blocks $b 0 [lmap level [lindex $blocks $b 0] {expr {($level in $alevels)?[continue]:$level}}]
+		set changed [expr {$changed | [lindex $masks $a]}]
+	}
+
+	## Forget about copies concerning the changed blocks and levels.
+	set kept [dict filter $kept script {pair value} {
+		lassign [split $pair ,] x y
+		expr {$x ni $copies && $y != $b && !([levelMask [lindex $blocks $y 0]] & $changed)}
+	}]
+}
+
+## Drop blocks not used anymore, put the blocks used by most levels first,
+## sort the items in the blocks, and get the order of blocks for each level.
+set blocks [lmap block [lsort -command {compareLevelCounts 0} [lsearch -all -inline -not -index 0 -exact $blocks {}]] {
+	list [lindex $block 0] [lsort -command compareItems [lindex $block 1]]
+}]
+if {[llength $blocks] > $maxblocks} {
+	complain "[llength $blocks] component blocks, maximum is $maxblocks."
+	exit 1
+}
+for {set level 1} {$level <= [llength $levels]} {incr level} {
+	if {![llength [set order [orderBlocks $level $blocks]]]} {
+		complain "Level $level: no order of component blocks found."
+		exit 1
+	}
+	dict set drawings $level [lmap b $order {expr {$b+1}}]
+}
+
+
+## Set up LevelComponents part and its index.
+set levelscomponents {}
+set componentsindex {}
+set offset 0
+set number 1
+foreach b $blocks {
+	lassign $b blocklevels block
+	lappend componentsindex $offset
+	incr offset [expr {[llength $block]+1}]
+
+	append levelscomponents "\t/* Component block $number */\n"
+	set lastx {}
+	foreach id $block {
+		set arguments [lassign [lindex $id 0] kind]
+		set name [string toupper $kind]
+		switch -- $kind {
+			options {
+				append levelscomponents "\tLEVEL_COMPONENT_OPTIONS(\n" [join [lmap option $arguments {string cat "\t\tLEVEL_ITEM_OPTION_" $option}] "|\n"] "\n\t),\n"
+				continue
+			}
+			attackwaves {
+				append levelscomponents "\tLEVEL_COMPONENT_ATTACKWAVES(\n" [join [lmap wave $arguments {string cat "\t\tLEVEL_ITEM_ATTACK_WAVE_" $wave}] ",\n"] "\n\t),\n"
+				continue
+			}
+			burger - ladder {
+				set arguments [lassign $arguments type]
+				append name ( $type ,
+			}
+			default {
+				append name (
+			}
+		}
+
+		## Empty line between x coordinates, like the level editor.
+		if {[lindex $arguments 0] ne $lastx} {
+			append levelscomponents "\n"
+			set lastx [lindex $arguments 0]
+		}
+		append levelscomponents [format "\tLEVEL_COMPONENT_%-20s%s),\n" $name [join [lmap argument $arguments {format %2d $argument}] ,]]
+	}
+	append levelscomponents "\tLEVEL_COMPONENT_END,\n\n"
+	incr number
+}
+
+## Set up LevelDrawings part and its index.
+set levelsdrawings {}
+set drawingsindex {}
+set offset 0
+for {set level 1} {$level <= [llength $levels]} {incr level} {
+	lappend drawingsindex $offset
+	incr offset [expr {[llength [dict get $drawings $level]]+1}]
+	append levelsdrawings "\t/* Level $level */\n\t" [join [dict get $drawings $level] ", "] ", 0,\n\n"
+}
+
+## Format an index with 8 numbers a line.
+proc formatIndex {numbers} {
+	set lines {}
+	for {set i 0} {$i < [llength $numbers]} {incr i 8} {
+		lappend lines "\t[join [lrange $numbers $i [expr {$i+7}]] {, }]"
+	}
+	join $lines ",\n"
+}
+
+
+## Write the file.
+puts -nonewline [string cat {#ifndef LEVELS_INC
+#define LEVELS_INC
+
+#include <avr/io.h> /* for uint8_t */
+#include <avr/pgmspace.h> /* for PROGMEM */
+
+/* Local includes */
+#include "../screens.h" /* for level_item_t */
+
+/* Level design description. */
+#define LEVEL_DESIGN "} [string toupper $leveldesign] {"
+#define LEVEL_AUTHOR "} [string toupper $levelauthor] {"
+
+/* Level descriptions. */
+const uint8_t LevelDrawings[] PROGMEM=} "\{\n" $levelsdrawings {	/* End of level drawings */
+	0
+} "\};" {
+
+const level_item_t LevelComponents[] PROGMEM=} "\{\n" $levelscomponents "\};" {
+
+#ifdef LEVEL_INDEX
+/* Number of levels. */
+const uint8_t LevelDrawingsCount PROGMEM=} [llength $levels] {;
+
+/* Start of each level in LevelDrawings. */
+const uint16_t LevelDrawingsIndex[] PROGMEM=} "\{\n" [formatIndex $drawingsindex] "\n\};" {
+
+/* Start of each component block in LevelComponents. */
+const uint16_t LevelComponentsIndex[] PROGMEM=} "\{\n" [formatIndex $componentsindex] "\n\};" {
+#endif /* LEVEL_INDEX */
+
+#endif /* LEVELS_INC */
+}]
+
+
+## Flash usage, level items are 3 bytes.
+if {[dict get $parameters v]} {
+	set drawingbytes 1
+	dict for {level drawing} $drawings {
+		incr drawingbytes [expr {[llength $drawing]+1}]
+	}
+	set componentbytes 0
+	foreach b $blocks {
+		incr componentbytes [expr {3*([llength [lindex $b 1]]+1)}]
+	}
+	puts stderr [format "%d levels, %d different items in %d component blocks." [llength $levels] [dict size $items] [llength $blocks]]
+	puts stderr [format "LevelDrawings %d bytes, LevelComponents %d bytes, total %d bytes, index %d bytes." \
+		$drawingbytes $componentbytes [expr {$drawingbytes+$componentbytes}] [expr {1+2*([llength $levels]+[llength $blocks])}]]
+}
@@ -438,6 +438,7 @@ proc setOptions {options} {
 	set ::attackWaveSpeed$::group {}
 	set ::bonusSpeed$::group {}
 	set ::wrap$::group {}
+	set ::horde$::group {}
 	foreach option $options {
 		switch -regexp -matchvar match -- $option {
 			{^stomp_(.*)$}               {set ::stompCount$::group         [lindex $match 1]}
@@ -446,6 +447,7 @@ proc setOptions {options} {
 			{^attack_wave_(.*)$}         {set ::attackWaveSpeed$::group    [lindex $match 1]}
 			{^bonus_(.*)$}               {set ::bonusSpeed$::group         [lindex $match 1]}
 			{^wrap_(.*)$}                {set ::wrap$::group               [lindex $match 1]}
+			{^horde_(.*)$}               {set ::horde$::group              [lindex $match 1]}
 		}
 	}
 }
@@ -601,7 +603,8 @@ foreach leveloption {
 	opponent_randomness_minimal opponent_randomness_normal opponent_randomness_medium opponent_randomness_high
 	attack_wave_fast attack_wave_medium attack_wave_slow attack_wave_slowest
 	bonus_fast bonus_medium bonus_slow bonus_slowest
-	wrap_none wrap_eastwest} {
+	wrap_none wrap_eastwest
+	horde_none horde_extra} {
 		lappend leveloptionpatterns \
 			[string cat {^[[:blank:]]*LEVEL_ITEM_OPTION_} [string toupper $leveloption] {\|?[[:blank:]]*$}] \
 			[list lappend leveloptions $leveloption]
@@ -782,7 +785,8 @@ proc saveLevels {filename} {
 			|| ([set ::opponentRandomness$g] ne {})
 			|| ([set ::attackWaveSpeed$g] ne {})
 			|| ([set ::bonusSpeed$g] ne {})
-			|| ([set ::wrap$g] ne {})} {
+			|| ([set ::wrap$g] ne {})
+			|| ([set ::horde$g] ne {})} {
 			set m $g
 		}
 		for {set w 0} {$w<8} {incr w} {
@@ -818,6 +822,9 @@ proc saveLevels {filename} {
 		if {[set ::wrap$g] ne {}} {
 			lappend options [string cat "\t\tLEVEL_ITEM_OPTION_WRAP_" [string toupper [set ::wrap$g]]]
 		}
+		if {[set ::horde$g] ne {}} {
+			lappend options [string cat "\t\tLEVEL_ITEM_OPTION_HORDE_" [string toupper [set ::horde$g]]]
+		}
 		if {$options ne {}} {
 			append levelscomponents "\tLEVEL_COMPONENT_OPTIONS(\n" [join $options "|\n"] "\n\t),\n"
 		}
@@ -1337,6 +1344,7 @@ proc setupGroups {} {
 		set ::attackWaveSpeed$g {}
 		set ::bonusSpeed$g {}
 		set ::wrap$g {}
+		set ::horde$g {}
 		for {set w 0} {$w<8} {incr w} {
 			set ::attackWave$g.$w {}
 		}
@@ -1395,6 +1403,8 @@ proc createOptionsGroup {g} {
 	ttk::combobox .right.options.group$g.bonusspeed              -state readonly -values {{} fast medium slow slowest} -textvariable ::bonusSpeed$g
 	ttk::label    .right.options.group$g.wraplabel               -text "Wrap:"
 	ttk::combobox .right.options.group$g.wrap                    -state readonly -values {{} none eastwest} -textvariable ::wrap$g
+	ttk::label    .right.options.group$g.hordelabel              -text "Horde:"
+	ttk::combobox .right.options.group$g.horde                   -state readonly -values {{} none extra} -textvariable ::horde$g
 
 	grid .right.options.group$g.stomplabel
 	grid .right.options.group$g.stomp
@@ -1408,6 +1418,8 @@ proc createOptionsGroup {g} {
 	grid .right.options.group$g.bonusspeed
 	grid .right.options.group$g.wraplabel
 	grid .right.options.group$g.wrap
+	grid .right.options.group$g.hordelabel
+	grid .right.options.group$g.horde
 
 	grid .right.options.group$g
 	grid remove .right.options.group$g
@@ -0,0 +1,199 @@
+#!/usr/bin/tclsh
+#
+#  levelpack.tcl - build a level pack for loading from SD card.
+#
+#  Reads one or more level files in the format of data/levels.inc and writes
+#  a level pack to stdout. Copy it as WUERGERT.PAK onto a FAT16 formatted SD
+#  card (or SD image for the emulator). The file must not be fragmented.
+#
+#  Pack layout, all numbers little endian:
+#    "WTLP", version (1 byte), number of levels (1 byte)
+#    per level: record offset from file start (4 bytes), record size (2 bytes)
+#    per level: record
+#  Each record holds the level drawing with block numbers starting at 1 for
+#  the blocks it uses, a terminating 0, and the level components of those
+#  blocks, each block terminated by an end component. Components are 3 bytes.
+#
+# (C)2012 Janka <jjj@gmx.de>, use and distribute under the terms of GNU GPLv3 or any later version.
+#
+
+package require cmdline
+
+
+## Get options.
+if {[ catch {set parameters [cmdline::getoptions argv {
+	{screens.arg "screens.h" "screens.h with the level item definitions"}
+	{size.arg "320" "maximum record size, LEVELPACK_BUFFER_SIZE in levelpack.h"}
+	{v "print record sizes on stderr"}
+}	{[options] levels.inc ... -- options are:}]} result]} {
+	puts stderr $result
+	exit 1
+}
+
+## Pack format version and limits.
+set version 1
+set maxlevels 255
+
+
+## Read level item constants from screens.h.
+set f [open [dict get $parameters screens]]
+foreach line [split [read $f] \n] {
+	if {[regexp {^#define\s+(LEVEL_ITEM_\w+)\s+(.+)$} $line match name value]} {
+		dict set defines $name [string trim $value]
+	}
+}
+close $f
+
+## Evaluate a constant expression with level item names in it.
+proc evaluate {expression} {
+	while {[regexp {LEVEL_ITEM_\w+} $expression name]} {
+		set expression [regsub -all "\\m$name\\M" $expression ([dict get $::defines $name])]
+	}
+	expr $expression
+}
+
+
+## Encode a level component macro into 3 bytes.
+proc component {name arguments} {
+	set a [lmap argument [split $arguments ,] {string trim $argument}]
+	switch -- $name {
+		END {
+			return [list 0 0 0]
+		}
+		OPTIONS {
+			set o [evaluate [join $a ,]]
+			return [list [evaluate LEVEL_ITEM_OPTIONS] [expr $o & 0xff] [expr $o >> 8]]
+		}
+		ATTACKWAVES {
+			set o 0
+			set s 0
+			foreach wave $a {
+				set o [expr $o | ([evaluate $wave] << $s)]
+				incr s 2
+			}
+			return [list [evaluate LEVEL_ITEM_ATTACKWAVES] [expr $o & 0xff] [expr $o >> 8]]
+		}
+		FLOOR {
+			lassign $a x y length
+			return [list [expr [evaluate LEVEL_ITEM_FLOOR] | $length] $x $y]
+		}
+		LADDER {
+			lassign $a type x y length
+			return [list [expr [evaluate LEVEL_ITEM_LADDER] | [evaluate LEVEL_ITEM_LADDER_$type] | $length] $x $y]
+		}
+		BURGER {
+			lassign $a type x y
+			return [list [evaluate LEVEL_ITEM_BURGER_$type] $x $y]
+		}
+		default {
+			lassign $a x y
+			return [list [evaluate LEVEL_ITEM_$name] $x $y]
+		}
+	}
+}
+
+
+## Read all level files.
+set records {}
+foreach file $argv {
+	set f [open $file]
+	set source [regsub -all {/\*.*?\*/} [read $f] {}]
+	close $f
+
+	## Get component blocks.
+	if {![regexp {LevelComponents\[\][^\{]*\{([^\}]*)\};} $source match components]} {
+		puts stderr "$file: no level components found."
+		exit 1
+	}
+	set blocks {}
+	set block {}
+	foreach {match name arguments} [regexp -all -inline {LEVEL_COMPONENT_(\w+)(?:\(([^)]*)\))?} $components] {
+		if {$name eq "END"} {
+			lappend blocks $block
+			set block {}
+		} else {
+			lappend block {*}[component $name $arguments]
+		}
+	}
+
+	## Get level drawings.
+	if {![regexp {LevelDrawings\[\][^\{]*\{([^\}]*)\};} $source match drawings]} {
+		puts stderr "$file: no level drawings found."
+		exit 1
+	}
+	set drawing {}
+	foreach b [regexp -all -inline {\d+} $drawings] {
+		if {$b != 0} {
+			lappend drawing $b
+			continue
+		}
+
+		## Skip terminating 0 of level drawings.
+		if {![llength $drawing]} {
+			continue
+		}
+
+		## End of level drawing. Renumber used blocks and collect their components.
+		set used {}
+		set localdrawing {}
+		foreach b $drawing {
+			if {[set i [lsearch -exact $used $b]] < 0} {
+				set i [llength $used]
+				lappend used $b
+			}
+			lappend localdrawing [expr $i+1]
+		}
+		set record [list {*}$localdrawing 0]
+		foreach b $used {
+			lappend record {*}[lindex $blocks [expr $b-1]] 0 0 0
+		}
+		lappend records $record
+		set drawing {}
+	}
+}
+
+## Check number of levels.
+if {[llength $records] > $maxlevels} {
+	puts stderr "Too many levels: [llength $records], maximum is $maxlevels."
+	exit 1
+}
+
+
+## Check record sizes. Bigger records wouldn't fit into the buffer.
+set level 1
+foreach record $records {
+	if {[llength $record] > [dict get $parameters size]} {
+		puts stderr "Level $level too big: [llength $record] bytes, maximum is [dict get $parameters size]."
+		exit 1
+	}
+	incr level
+}
+
+
+## Output header and index.
+fconfigure stdout -translation binary
+puts -nonewline stdout [binary format a4cc WTLP $version [llength $records]]
+set offset [expr 6+6*[llength $records]]
+set maxsize 0
+set level 1
+foreach record $records {
+	puts -nonewline stdout [binary format ius $offset [llength $record]]
+	incr offset [llength $record]
+	if {[llength $record] > $maxsize} {
+		set maxsize [llength $record]
+	}
+	if {[dict get $parameters v]} {
+		puts stderr [format "Level %3d: %4d bytes" $level [llength $record]]
+	}
+	incr level
+}
+
+## Output records.
+foreach record $records {
+	puts -nonewline stdout [binary format c* $record]
+}
+
+## Statistics.
+if {[dict get $parameters v]} {
+	puts stderr "[llength $records] levels, largest record $maxsize bytes."
+}
@@ -0,0 +1,108 @@
+#!/usr/bin/tclsh
+#
+#  levelstats.tcl - print the per level statistics from an EEPROM dump.
+#
+#  Reads a binary EEPROM image, e.g. eeprom.bin as written by the emulator
+#  or read from a console, and prints a report of the level statistics
+#  kept by a Würgertime built with LEVELSTATS=1. The entry layout must
+#  match statistics.h.
+#
+# (C)2012 Janka <jjj@gmx.de>, use and distribute under the terms of GNU GPLv3 or any later version.
+#
+
+package require cmdline
+
+
+## Get options.
+if {[ catch {set parameters [cmdline::getoptions argv {
+	{levels.arg "15" "levels with own statistics, STATISTICS_LEVEL_MAX in statistics.h"}
+}	{[options] eeprom.bin -- options are:}]} result]} {
+	puts stderr $result
+	exit 1
+}
+if {[llength $argv] != 1} {
+	puts stderr "Usage: levelstats.tcl \[-levels n\] eeprom.bin"
+	exit 1
+}
+
+## Layout, see statistics.h.
+set blocksize 32
+set eid 0x5760
+set entrysize 6
+set entriesperblock 5
+set fields {plays 0 10 clears 10 10 best 20 8 sausageman 28 4 egghead 32 4 mrmustard 36 4 anticook 40 4 other 44 4}
+set levels [dict get $parameters levels]
+
+
+## Read EEPROM image.
+set f [open [lindex $argv 0]]
+fconfigure $f -translation binary
+set image [read $f]
+close $f
+
+## Find all statistics blocks.
+set blocks {}
+for {set address 0} {$address+$blocksize <= [string length $image]} {incr address $blocksize} {
+	binary scan $image @${address}su id
+	set n [expr $id-$eid]
+	if {$n >= 0 && $n*$entriesperblock < $levels} {
+		dict set blocks $n $address
+	}
+}
+
+
+## Get bit field from entry, lowest bit first.
+proc field {bytes pos bits} {
+	set value 0
+	for {set i 0} {$i<$bits} {incr i} {
+		set byte [lindex $bytes [expr ($pos+$i)>>3]]
+		if {$byte & (1<<(($pos+$i) & 7))} {
+			set value [expr $value | (1<<$i)]
+		}
+	}
+	return $value
+}
+
+
+## Print report.
+puts [format "%-6s %6s %6s %6s %8s %8s %8s %8s %8s" level plays clears best sausage egghead mustard anticook other]
+for {set level 1} {$level <= $levels} {incr level} {
+	## Skip levels without block.
+	set index [expr $level-1]
+	set n [expr $index/$entriesperblock]
+	if {![dict exists $blocks $n]} {
+		continue
+	}
+
+	## Decode entry.
+	set address [expr [dict get $blocks $n]+2+($index%$entriesperblock)*$entrysize]
+	binary scan $image @${address}cu$entrysize bytes
+	set values {}
+	foreach {name pos bits} $fields {
+		dict set values $name [field $bytes $pos $bits]
+	}
+
+	## Skip levels never played.
+	if {![dict get $values plays]} {
+		continue
+	}
+
+	## Best time as minutes and seconds.
+	set best [dict get $values best]
+	if {$best} {
+		set best [format "%d:%02d" [expr $best/60] [expr $best%60]]
+	} else {
+		set best "-"
+	}
+
+	## Last level stands for all higher levels.
+	set name $level
+	if {$level == $levels} {
+		set name "$level+"
+	}
+
+	puts [format "%-6s %6d %6d %6s %8d %8d %8d %8d %8d" $name \
+		[dict get $values plays] [dict get $values clears] $best \
+		[dict get $values sausageman] [dict get $values egghead] [dict get $values mrmustard] \
+		[dict get $values anticook] [dict get $values other]]
+}
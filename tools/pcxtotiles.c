@@ -0,0 +1,217 @@
+/*
+ *  pcxtotiles.c - a PCX to tiles converter for uzebox video mode 3.
+ *
+ *  Native replacement for pcxtotiles.tcl, with the same input and output.
+ *  PCX must be 8 bits per pixel/1 plane, like needed for uzebox. A palette
+ *  given in the file is ignored as uzebox has a fixed palette. Pixels per
+ *  line and number of lines must be a multiple of 8.
+ *
+ *  Usage: pcxtotiles [-d] [-m] [-r macro] [-t color] [-v] name <in.pcx >out.inc
+ *
+ *    -d        drop duplicate tiles and output a remap macro
+ *    -m        also drop tiles which are X-mirrored duplicates, implies -d
+ *    -r macro  name of the remap macro, default name_REMAP
+ *    -t color  transparent color for blank tile detection, default 0xfe
+ *    -v        print statistics on stderr
+ *
+ *  With -d, tiles are output in order of first appearance and the macro
+ *  maps the tile index in the image to the index in the output. With -m,
+ *  the mapped index of a mirrored tile has the mirror bit 0x80 set, which
+ *  SPRITE_PIECE() turns into SPRITE_FLIP_X. The macro is a conditional
+ *  chain, so it folds into a constant for constant tile indices.
+ *
+ *  Build with: cc -O2 -o pcxtotiles pcxtotiles.c
+ *
+ * (C)2012 Janka <jjj@gmx.de>, use and distribute under the terms of GNU GPLv3 or any later version.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+
+/* Tile basics. */
+#define TILE_SIZE 8
+#define PIXELS_PER_TILE ((TILE_SIZE*TILE_SIZE))
+#define TILES_MAX 1024
+#define TILE_MIRROR 0x80
+
+
+/* PCX header fields. */
+#define PCX_HEADER_SIZE 128
+#define PCX_RLE_MARK 0xc0
+
+
+/* Read little endian word from header. */
+static unsigned int word(const unsigned char *p) {
+	return p[0]|(p[1]<<8);
+}
+
+
+/* Mirror tile along X. */
+static void mirror(unsigned char *dst, const unsigned char *src) {
+	int x, y;
+
+	for (y=0;y<TILE_SIZE;y++)
+		for (x=0;x<TILE_SIZE;x++)
+			dst[y*TILE_SIZE+x]=src[y*TILE_SIZE+TILE_SIZE-1-x];
+}
+
+
+int main(int argc, char *argv[]) {
+	unsigned char header[PCX_HEADER_SIZE];
+	unsigned char *image, *tiles;
+	unsigned char mirrored[PIXELS_PER_TILE];
+	static int remap[TILES_MAX], source[TILES_MAX], blank[TILES_MAX];
+	unsigned int bytes_per_line, lines, columns, rows, count, kept, blanks, duplicates, mirrors;
+	unsigned int i, j, n, x, y;
+	int c, dedup=0, mirrors_too=0, verbose=0, transparent=0xfe;
+	const char *macro=NULL;
+	char defaultmacro[256];
+
+	/* Get options. */
+	while ((c=getopt(argc,argv,"dmr:t:v")) != -1) {
+		switch (c) {
+			case 'd': dedup=1; break;
+			case 'm': dedup=1; mirrors_too=1; break;
+			case 'r': macro=optarg; break;
+			case 't': transparent=strtol(optarg,NULL,0); break;
+			case 'v': verbose=1; break;
+			default:
+				fprintf(stderr,"Usage: %s [-d] [-m] [-r macro] [-t color] [-v] name <in.pcx >out.inc\n",argv[0]);
+				return 1;
+		}
+	}
+	if (optind != argc-1) {
+		fprintf(stderr,"Usage: %s [-d] [-m] [-r macro] [-t color] [-v] name <in.pcx >out.inc\n",argv[0]);
+		return 1;
+	}
+	if (!macro) {
+		snprintf(defaultmacro,sizeof(defaultmacro),"%s_REMAP",argv[optind]);
+		macro=defaultmacro;
+	}
+
+	/* Read and check PCX header. */
+	if (fread(header,1,PCX_HEADER_SIZE,stdin) != PCX_HEADER_SIZE) {
+		fprintf(stderr,"Short PCX header.\n");
+		return 1;
+	}
+	if (header[3] != 8 || header[65] != 1) {
+		fprintf(stderr,"Uzebox requires an 8 bpp 1 plane indexed PCX file as source for tiles.\n");
+		return 1;
+	}
+	bytes_per_line=word(header+66);
+	lines=word(header+10)-word(header+6)+1;
+	columns=bytes_per_line/TILE_SIZE;
+	rows=lines/TILE_SIZE;
+	count=columns*rows;
+	if (count > TILES_MAX) {
+		fprintf(stderr,"Too many tiles: %u, maximum is %u.\n",count,TILES_MAX);
+		return 1;
+	}
+
+	/* Decode image. Runs may span lines. */
+	image=malloc(bytes_per_line*rows*TILE_SIZE);
+	tiles=malloc(count*PIXELS_PER_TILE);
+	if (!image || !tiles) {
+		fprintf(stderr,"Out of memory.\n");
+		return 1;
+	}
+	for (i=0;i<bytes_per_line*rows*TILE_SIZE;) {
+		if ((c=getchar()) == EOF) {
+			fprintf(stderr,"Short PCX data.\n");
+			return 1;
+		}
+		n=1;
+		if (c >= PCX_RLE_MARK) {
+			n=c-PCX_RLE_MARK;
+			if ((c=getchar()) == EOF) {
+				fprintf(stderr,"Short PCX data.\n");
+				return 1;
+			}
+		}
+		for (;n && i<bytes_per_line*rows*TILE_SIZE;n--)
+			image[i++]=c;
+	}
+
+	/* Cut into tiles, row by row. */
+	for (i=0;i<count;i++)
+		for (y=0;y<TILE_SIZE;y++)
+			for (x=0;x<TILE_SIZE;x++)
+				tiles[i*PIXELS_PER_TILE+y*TILE_SIZE+x]=image[((i/columns)*TILE_SIZE+y)*bytes_per_line+(i%columns)*TILE_SIZE+x];
+
+	/* Find blank, duplicate and mirrored tiles. */
+	kept=blanks=duplicates=mirrors=0;
+	for (i=0;i<count;i++) {
+		/* Blank? */
+		blank[i]=1;
+		for (j=0;j<PIXELS_PER_TILE;j++)
+			if (tiles[i*PIXELS_PER_TILE+j] != transparent)
+				blank[i]=0;
+		blanks+=blank[i];
+
+		/* Keep all tiles if not deduplicating. */
+		remap[i]=-1;
+		if (dedup) {
+			/* Compare with all kept tiles, as is and mirrored. */
+			mirror(mirrored,tiles+i*PIXELS_PER_TILE);
+			for (j=0;j<kept && remap[i]<0;j++) {
+				if (!memcmp(tiles+source[j]*PIXELS_PER_TILE,tiles+i*PIXELS_PER_TILE,PIXELS_PER_TILE)) {
+					remap[i]=j;
+					duplicates++;
+				} else if (mirrors_too && !memcmp(tiles+source[j]*PIXELS_PER_TILE,mirrored,PIXELS_PER_TILE)) {
+					remap[i]=j|TILE_MIRROR;
+					mirrors++;
+				}
+			}
+		}
+
+		/* New tile. */
+		if (remap[i] < 0) {
+			if (mirrors_too && kept >= TILE_MIRROR) {
+				fprintf(stderr,"Too many tiles for mirror bit: more than %u unique tiles.\n",TILE_MIRROR);
+				return 1;
+			}
+			source[kept]=i;
+			remap[i]=kept++;
+		}
+	}
+
+	/* Output tiles. */
+	printf("const char %s[] PROGMEM={\n",argv[optind]);
+	for (j=0;j<kept;j++) {
+		i=source[j];
+		if (dedup)
+			printf("/* Tile #%u, image tile #%u (%u|%u)%s */\n\t",j,i,i/columns,i%columns,blank[i]?", blank":"");
+		else
+			printf("/* Tile #%u (%u|%u) */\n\t",i,i/columns,i%columns);
+		for (y=0;y<TILE_SIZE;y++) {
+			for (x=0;x<TILE_SIZE;x++)
+				printf("0x%02x, ",tiles[i*PIXELS_PER_TILE+y*TILE_SIZE+x]);
+			printf("\n\t");
+		}
+		printf("\n");
+	}
+	printf("};\n");
+
+	/* Output remap macro. */
+	if (dedup) {
+		printf("\n/* Image tile index to tile index. Mirrored tiles have bit 0x80 set. */\n");
+		printf("#define %s(t) (( \\\n",macro);
+		for (i=0;i<count;i++)
+			if ((unsigned)remap[i] != i)
+				printf("\t((t) == %u)?%u: \\\n",i,remap[i]);
+		printf("\t(t) ))\n");
+	}
+
+	/* Statistics. */
+	if (verbose) {
+		fprintf(stderr,"%s: %u tiles, %u blank, %u duplicate, %u mirrored, %u output, %u bytes saved.\n",
+			argv[optind],count,blanks,duplicates,mirrors,kept,(count-kept)*PIXELS_PER_TILE);
+	}
+
+	free(image);
+	free(tiles);
+	return 0;
+}
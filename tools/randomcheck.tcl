@@ -0,0 +1,126 @@
+#!/usr/bin/tclsh
+#
+#  randomcheck.tcl - statistical check of the random generator in utils.c
+#
+#  Runs the 16 bit xorshift generator from utils.c and, for comparison, the
+#  former 31 bit generator on the host and prints for both:
+#    + period from the given seed (xorshift only)
+#    + chi square of the byte histogram (255 degrees of freedom)
+#    + chi square of the modulo 4, 5 and 6 results the game uses
+#    + chi square of consecutive pairs of high nibbles (255 d.o.f.)
+#    + balance of each output bit
+#    + lag 1 serial correlation of the bytes
+#  Chi square values around the degrees of freedom are fine, values far
+#  above hint at a bias.
+#
+# (C)2012 Janka <jjj@gmx.de>, use and distribute under the terms of GNU GPLv3 or any later version.
+#
+
+package require cmdline
+
+
+## Get options.
+if {[ catch {set parameters [cmdline::getoptions argv {
+	{seed.arg "1234" "seed, RANDOM_DEFAULT_SEED in utils.c"}
+	{n.arg "16384" "number of bytes to check, up to 65535 for the full period"}
+}	{[options] -- options are:}]} result]} {
+	puts stderr $result
+	exit 1
+}
+set seed [dict get $parameters seed]
+set n [dict get $parameters n]
+
+
+## The generators. Each one returns the next byte and updates the state.
+proc xorshift {} {
+	global state
+	set state [expr {($state ^ ($state<<7)) & 0xffff}]
+	set state [expr {$state ^ ($state>>9)}]
+	set state [expr {($state ^ ($state<<8)) & 0xffff}]
+	expr {$state & 0xff}
+}
+
+proc former {} {
+	global state
+	set state [expr {(($state>>16) + (($state<<15) & 0x7fffffff) - ($state>>21) - (($state<<10) & 0x7fffffff)) & 0xffffffff}]
+	expr {$state & 0xff}
+}
+
+
+## Chi square of a histogram against uniform distribution.
+proc chisquare {histogram total} {
+	set expected [expr {double($total)/[llength $histogram]}]
+	set chi 0.0
+	foreach count $histogram {
+		set chi [expr {$chi+($count-$expected)*($count-$expected)/$expected}]
+	}
+	format %.1f $chi
+}
+
+
+## Check one generator.
+proc check {name generator} {
+	global state seed n
+
+	## Collect statistics.
+	set state $seed
+	set bytes [lrepeat 256 0]
+	set pairs [lrepeat 256 0]
+	foreach m {4 5 6} {
+		set mod($m) [lrepeat $m 0]
+	}
+	set bits [lrepeat 8 0]
+	set sx 0.0; set sxx 0.0; set sxy 0.0
+	set previous [$generator]
+	set first $previous
+	for {set i 0} {$i<$n} {incr i} {
+		set r [$generator]
+		lset bytes $r [expr {[lindex $bytes $r]+1}]
+		lset pairs [expr {($previous>>4)*16+($r>>4)}] [expr {[lindex $pairs [expr {($previous>>4)*16+($r>>4)}]]+1}]
+		foreach m {4 5 6} {
+			lset mod($m) [expr {$r%$m}] [expr {[lindex $mod($m) [expr {$r%$m}]]+1}]
+		}
+		for {set b 0} {$b<8} {incr b} {
+			if {$r & (1<<$b)} {
+				lset bits $b [expr {[lindex $bits $b]+1}]
+			}
+		}
+		set sx [expr {$sx+$r}]
+		set sxx [expr {$sxx+$r*$r}]
+		set sxy [expr {$sxy+$previous*$r}]
+		set previous $r
+	}
+
+	## Serial correlation.
+	set correlation [expr {($n*$sxy-$sx*$sx)/($n*$sxx-$sx*$sx)}]
+
+	## Report.
+	puts "$name:"
+	puts [format "  bytes chi square      %s" [chisquare $bytes $n]]
+	foreach m {4 5 6} {
+		puts [format "  modulo %d chi square   %s (%d d.o.f.)" $m [chisquare $mod($m) $n] [expr {$m-1}]]
+	}
+	puts [format "  nibble pairs chi sq.  %s" [chisquare $pairs $n]]
+	puts -nonewline "  bit balance          "
+	foreach count $bits {
+		puts -nonewline [format " %.3f" [expr {double($count)/$n}]]
+	}
+	puts ""
+	puts [format "  serial correlation    %.4f" $correlation]
+}
+
+
+## Period of the xorshift generator.
+set state $seed
+set period 0
+while {1} {
+	xorshift
+	incr period
+	if {$state == $seed} break
+}
+puts "xorshift period from seed $seed: $period"
+puts ""
+
+## Check both generators.
+check xorshift xorshift
+check former former
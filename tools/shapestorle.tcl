@@ -0,0 +1,98 @@
+#!/usr/bin/tclsh
+#
+#  shapestorle.tcl - a minimalist run length encoder for shapes.inc
+#
+#  Reads the shape definitions from stdin and writes them run length encoded
+#  to stdout. Tiles are compared by their symbolic names, so the tile numbers
+#  don't need to be known. Runs of three or more equal tiles are replaced by
+#  SHAPE_RLE_RUN, count, tile. Width and height are kept as they are.
+#
+#  Use -v to get the size of each shape before and after encoding on stderr.
+#
+# (C)2012 Janka <jjj@gmx.de>, use and distribute under the terms of GNU GPLv3 or any later version.
+#
+
+
+## Verbose output?
+set verbose [expr {[lindex $argv 0] eq "-v"}]
+
+## Read all input, strip comments.
+set source [regsub -all {/\*.*?\*/} [read stdin] {}]
+
+## Output header.
+puts "/*"
+puts " *  data/shapes_rle.inc - run length encoded shapes, generated by shapestorle.tcl from data/shapes.inc"
+puts " */"
+puts ""
+puts ""
+puts "#ifndef SHAPES_RLE_INC"
+puts "#define SHAPES_RLE_INC"
+puts ""
+puts ""
+puts "#include <avr/io.h> /* for uint8_t */"
+puts ""
+puts ""
+puts "/* Local includes */"
+puts "#include \"tiles.inc\" /* for tile semantics. */"
+puts ""
+
+## Encode all shapes.
+set total 0
+set totalencoded 0
+foreach {match name body} [regexp -all -inline {const\s+uint8_t\s+(\w+)\[\]\s+PROGMEM\s*=\s*\{([^\}]*)\}} $source] {
+	## Get tokens. First two are width and height.
+	set tokens {}
+	foreach token [split $body ,] {
+		set token [string trim $token]
+		if {$token ne {}} {
+			lappend tokens $token
+		}
+	}
+	set tiles [lrange $tokens 2 end]
+
+	## Encode runs. One line per tile or run.
+	set encoded {}
+	set size 2
+	set i 0
+	while {$i<[llength $tiles]} {
+		set tile [lindex $tiles $i]
+		set n 1
+		while {($i+$n<[llength $tiles]) && ([lindex $tiles [expr $i+$n]] eq $tile) && ($n<255)} {
+			incr n
+		}
+		if {$n>=3} {
+			lappend encoded "SHAPE_RLE_RUN, $n, $tile"
+			incr size 3
+		} else {
+			lappend encoded {*}[lrepeat $n $tile]
+			incr size $n
+		}
+		incr i $n
+	}
+
+	## Output encoded shape.
+	puts ""
+	puts "const uint8_t $name\[\] PROGMEM=\{"
+	puts "\t[lindex $tokens 0], [lindex $tokens 1],"
+	foreach token $encoded {
+		puts "\t$token,"
+	}
+	puts "\};"
+
+	## Statistics.
+	incr total [llength $tokens]
+	incr totalencoded $size
+	if {$verbose} {
+		puts stderr [format "%-40s %5d -> %5d bytes" $name [llength $tokens] $size]
+	}
+}
+
+## Output footer.
+puts ""
+puts ""
+puts "#endif /* SHAPES_RLE_INC */"
+
+## Statistics.
+if {$verbose} {
+	puts stderr [format "%-40s %5d -> %5d bytes" total $total $totalencoded]
+}
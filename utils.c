@@ -17,24 +17,37 @@
 #include <avr/pgmspace.h>
 
 
-/*  Random generator. */
-#define RANDOM_MODULO 0x7FFFFFFF
+/*
+ *  Random generator. A 16 bit xorshift with shifts 7, 9, 8, which are
+ *  cheap on an 8 bit CPU. The state must never be zero, its period is
+ *  65535. See tools/randomcheck.tcl.
+ */
+#define RANDOM_DEFAULT_SEED 1234
 
-uint32_t random_seed = 1234;
+uint16_t RandomState = RANDOM_DEFAULT_SEED;
 
 uint8_t fastrandom(void) {
-	random_seed=
-		(random_seed >> 16)
-		+ ((random_seed << 15) & RANDOM_MODULO)
-		- (random_seed >> 21)
-		- ((random_seed << 10) & RANDOM_MODULO);
-	if (random_seed < 0) random_seed += RANDOM_MODULO;
-	return (uint8_t) random_seed;
+	RandomState^=RandomState<<7;
+	RandomState^=RandomState>>9;
+	RandomState^=RandomState<<8;
+	return (uint8_t) RandomState;
 }
 
 void pushentropy(uint32_t entropy) {
-	random_seed<<=2;
-	random_seed|=(entropy & 3);
+	/* Rotate two bits of entropy into the state. */
+	RandomState=(RandomState<<2)|(RandomState>>14);
+	RandomState^=(entropy & 3);
+
+	/* Never let the state become zero. */
+	if (!RandomState) RandomState=RANDOM_DEFAULT_SEED;
+}
+
+void seedRandom(uint16_t seed) {
+	RandomState=seed?seed:RANDOM_DEFAULT_SEED;
+}
+
+uint16_t getRandomState(void) {
+	return RandomState;
 }
 
 
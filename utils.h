@@ -40,6 +40,8 @@ typedef	struct { uint8_t x, y; } position_t;
 /* Random generator. */
 uint8_t fastrandom(void);
 void pushentropy(uint32_t entropy);
+void seedRandom(uint16_t seed);
+uint16_t getRandomState(void);
 
 
 /* Initialize RAM from program memory. */